@@ -40,6 +40,10 @@ vle.exe -P ext.qwt clean rclean configure build
 if %ERRORLEVEL% NEQ 0 goto :ERROR
 vle.exe -P ext.shapelib clean rclean configure build
 if %ERRORLEVEL% NEQ 0 goto :ERROR
+vle.exe -P vle.muparser clean rclean configure build
+if %ERRORLEVEL% NEQ 0 goto :ERROR
+vle.exe -P vle.lua clean rclean configure build
+if %ERRORLEVEL% NEQ 0 goto :ERROR
 vle.exe -P vle.adaptative-qss.examples clean rclean configure build
 if %ERRORLEVEL% NEQ 0 goto :ERROR
 vle.exe -P gvle.decision clean rclean configure build
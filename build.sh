@@ -45,6 +45,8 @@ ext.lua
 ext.muparser
 ext.qwt
 ext.shapelib
+vle.muparser
+vle.lua
 vle.adaptative-qss.examples
 test_manager
 gvle.decision
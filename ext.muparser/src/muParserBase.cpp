@@ -1714,7 +1714,13 @@ namespace mu
   //---------------------------------------------------------------------------
   void ParserBase::Eval(value_type *results, int nBulkSize)
   {
-    CreateRPN();
+    // Build the bytecode only if no evaluation did it since the last change
+    // of the expression or of the variables (see ReInit), as Eval() does.
+    if (m_pParseFormula == &ParserBase::ParseString)
+    {
+      CreateRPN();
+      m_pParseFormula = &ParserBase::ParseCmdCode;
+    }
 
     int i = 0;
 
@@ -0,0 +1,408 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_decimated_point_data.h"
+#include <algorithm>
+
+/*!
+  Constructor
+
+  \param factor Number of blocks of a level merged into one block
+                of the next level ( at least 2 )
+*/
+QwtDecimatedPointData::QwtDecimatedPointData( int factor ):
+    d_factor( qMax( factor, 2 ) ),
+    d_sorted( true ),
+    d_x1( 0.0 ),
+    d_x2( -1.0 ),
+    d_pixels( 1000 ),
+    d_dirty( true )
+{
+}
+
+/*!
+  Append a sample and update the levels of the pyramid
+
+  \param x X value, expected to be >= the x value of the previous sample
+  \param y Y value
+*/
+void QwtDecimatedPointData::append( double x, double y )
+{
+    const size_t index = d_x.size();
+
+    if ( index == 0 )
+    {
+        d_boundingRect = QRectF( x, y, 0.0, 0.0 );
+    }
+    else
+    {
+        if ( x < d_x.last() )
+            d_sorted = false;
+
+        if ( x < d_boundingRect.left() )
+            d_boundingRect.setLeft( x );
+        if ( x > d_boundingRect.right() )
+            d_boundingRect.setRight( x );
+        if ( y < d_boundingRect.top() )
+            d_boundingRect.setTop( y );
+        if ( y > d_boundingRect.bottom() )
+            d_boundingRect.setBottom( y );
+    }
+
+    d_x.append( x );
+    d_y.append( y );
+
+    size_t blockSize = d_factor;
+    for ( int k = 0; k < d_levels.size(); k++ )
+    {
+        QVector<Bucket> &level = d_levels[k];
+        const int b = static_cast<int>( index / blockSize );
+
+        if ( b == level.size() )
+        {
+            Bucket bucket;
+            bucket.min = bucket.max = y;
+            bucket.minIndex = bucket.maxIndex = index;
+            level.append( bucket );
+        }
+        else
+        {
+            Bucket &bucket = level[b];
+            if ( y < bucket.min )
+            {
+                bucket.min = y;
+                bucket.minIndex = index;
+            }
+            if ( y > bucket.max )
+            {
+                bucket.max = y;
+                bucket.maxIndex = index;
+            }
+        }
+
+        blockSize *= d_factor;
+    }
+
+    if ( index + 1 > blockSize )
+        addLevel();
+
+    d_dirty = true;
+}
+
+/*!
+  Append a block of samples
+
+  \param x Array of x values
+  \param y Array of y values
+  \param size Size of the x and y arrays
+*/
+void QwtDecimatedPointData::append(
+    const double *x, const double *y, size_t size )
+{
+    d_x.reserve( d_x.size() + static_cast<int>( size ) );
+    d_y.reserve( d_y.size() + static_cast<int>( size ) );
+
+    for ( size_t i = 0; i < size; i++ )
+        append( x[i], y[i] );
+}
+
+//! Remove all samples and levels
+void QwtDecimatedPointData::clear()
+{
+    d_x.clear();
+    d_y.clear();
+    d_levels.clear();
+    d_sorted = true;
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    d_view.clear();
+    d_dirty = true;
+}
+
+//! \return Number of appended samples
+size_t QwtDecimatedPointData::rawSize() const
+{
+    return d_x.size();
+}
+
+/*!
+  \param index Index of an appended sample
+  \return Appended sample at position index
+*/
+QPointF QwtDecimatedPointData::rawSample( size_t index ) const
+{
+    return QPointF( d_x[int( index )], d_y[int( index )] );
+}
+
+//! \return Number of blocks merged from one level to the next
+int QwtDecimatedPointData::factor() const
+{
+    return d_factor;
+}
+
+//! \return Number of levels of the pyramid
+int QwtDecimatedPointData::levels() const
+{
+    return d_levels.size();
+}
+
+/*!
+  \param level Level of the pyramid
+  \return Number of blocks of the level
+*/
+int QwtDecimatedPointData::levelSize( int level ) const
+{
+    return d_levels[level].size();
+}
+
+/*!
+  \param level Level of the pyramid
+  \param block Block of the level, covering the samples
+               [ block * factor^(level+1), ( block + 1 ) * factor^(level+1) [
+  \return Minimum of the y values of the block
+*/
+double QwtDecimatedPointData::levelMinimum( int level, int block ) const
+{
+    return d_levels[level][block].min;
+}
+
+/*!
+  \param level Level of the pyramid
+  \param block Block of the level
+  \return Maximum of the y values of the block
+  \sa levelMinimum()
+*/
+double QwtDecimatedPointData::levelMaximum( int level, int block ) const
+{
+    return d_levels[level][block].max;
+}
+
+/*!
+  Set the number of pixel columns the view is reduced to,
+  when there is no better information from selectView()
+
+  \param pixels Number of pixels
+  \sa resolution(), selectView()
+*/
+void QwtDecimatedPointData::setResolution( int pixels )
+{
+    selectView( d_x1, d_x2, pixels );
+}
+
+//! \return Number of pixel columns
+int QwtDecimatedPointData::resolution() const
+{
+    return d_pixels;
+}
+
+/*!
+  Restrict the view to the x interval of the rectangle
+
+  \param rect Rectangle of interest
+  \sa QwtPlotSeriesItem::updateScaleDiv()
+*/
+void QwtDecimatedPointData::setRectOfInterest( const QRectF &rect )
+{
+    selectView( rect.left(), rect.right(), d_pixels );
+}
+
+/*!
+  Select the samples returned by size() and sample()
+
+  Only the cached view is affected, the samples are not modified.
+  An invalid interval ( x1 > x2 ) selects all samples.
+
+  \param x1 Lower bound of the visible interval
+  \param x2 Upper bound of the visible interval
+  \param pixels Number of pixel columns of the interval
+*/
+void QwtDecimatedPointData::selectView(
+    double x1, double x2, int pixels ) const
+{
+    pixels = qMax( pixels, 1 );
+
+    if ( x1 != d_x1 || x2 != d_x2 || pixels != d_pixels )
+    {
+        d_x1 = x1;
+        d_x2 = x2;
+        d_pixels = pixels;
+        d_dirty = true;
+    }
+}
+
+/*!
+  \return Bounding rectangle of all appended samples
+*/
+QRectF QwtDecimatedPointData::boundingRect() const
+{
+    return d_boundingRect;
+}
+
+//! \return Number of samples of the current view
+size_t QwtDecimatedPointData::size() const
+{
+    if ( d_dirty )
+        updateView();
+
+    return d_view.size();
+}
+
+/*!
+  \param index Index
+  \return Sample of the current view at position index
+*/
+QPointF QwtDecimatedPointData::sample( size_t index ) const
+{
+    if ( d_dirty )
+        updateView();
+
+    return d_view[int( index )];
+}
+
+void QwtDecimatedPointData::addLevel()
+{
+    const int k = d_levels.size();
+    QVector<Bucket> level;
+
+    if ( k == 0 )
+    {
+        for ( int i = 0; i < d_y.size(); i++ )
+        {
+            const int b = i / d_factor;
+            const double y = d_y[i];
+
+            if ( b == level.size() )
+            {
+                Bucket bucket;
+                bucket.min = bucket.max = y;
+                bucket.minIndex = bucket.maxIndex = i;
+                level.append( bucket );
+            }
+            else
+            {
+                Bucket &bucket = level[b];
+                if ( y < bucket.min )
+                {
+                    bucket.min = y;
+                    bucket.minIndex = i;
+                }
+                if ( y > bucket.max )
+                {
+                    bucket.max = y;
+                    bucket.maxIndex = i;
+                }
+            }
+        }
+    }
+    else
+    {
+        const QVector<Bucket> &lower = d_levels[k - 1];
+        for ( int i = 0; i < lower.size(); i++ )
+        {
+            const int b = i / d_factor;
+            const Bucket &from = lower[i];
+
+            if ( b == level.size() )
+            {
+                level.append( from );
+            }
+            else
+            {
+                Bucket &bucket = level[b];
+                if ( from.min < bucket.min )
+                {
+                    bucket.min = from.min;
+                    bucket.minIndex = from.minIndex;
+                }
+                if ( from.max > bucket.max )
+                {
+                    bucket.max = from.max;
+                    bucket.maxIndex = from.maxIndex;
+                }
+            }
+        }
+    }
+
+    d_levels.append( level );
+}
+
+void QwtDecimatedPointData::appendView( size_t index ) const
+{
+    d_view.append( QPointF( d_x[int( index )], d_y[int( index )] ) );
+}
+
+void QwtDecimatedPointData::updateView() const
+{
+    d_dirty = false;
+    d_view.clear();
+
+    const size_t numSamples = d_x.size();
+    if ( numSamples == 0 )
+        return;
+
+    size_t i0 = 0;
+    size_t i1 = numSamples;
+
+    /*
+      Keep one sample on each side of the interval, so that the
+      curve is drawn up to the borders of the canvas.
+     */
+    if ( d_sorted && d_x1 <= d_x2 )
+    {
+        const double *x = d_x.constData();
+
+        i0 = std::lower_bound( x, x + numSamples, d_x1 ) - x;
+        if ( i0 > 0 )
+            i0--;
+
+        i1 = std::upper_bound( x, x + numSamples, d_x2 ) - x;
+        if ( i1 < numSamples )
+            i1++;
+    }
+
+    const size_t count = i1 - i0;
+    const size_t pixels = d_pixels;
+
+    if ( !d_sorted || d_levels.isEmpty() || count <= 2 * pixels )
+    {
+        d_view.reserve( static_cast<int>( count ) );
+        for ( size_t i = i0; i < i1; i++ )
+            appendView( i );
+
+        return;
+    }
+
+    int k = 0;
+    size_t blockSize = d_factor;
+    while ( count / blockSize > pixels && k + 1 < d_levels.size() )
+    {
+        k++;
+        blockSize *= d_factor;
+    }
+
+    const QVector<Bucket> &level = d_levels[k];
+    const size_t last = i1 - 1;
+
+    d_view.reserve( static_cast<int>( 2 * ( count / blockSize ) + 4 ) );
+    appendView( i0 );
+
+    for ( size_t b = i0 / blockSize; b <= last / blockSize; b++ )
+    {
+        const Bucket &bucket = level[int( b )];
+        const size_t first = qMin( bucket.minIndex, bucket.maxIndex );
+        const size_t second = qMax( bucket.minIndex, bucket.maxIndex );
+
+        if ( first > i0 && first < last )
+            appendView( first );
+        if ( second != first && second > i0 && second < last )
+            appendView( second );
+    }
+
+    if ( last != i0 )
+        appendView( last );
+}
@@ -0,0 +1,97 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_DECIMATED_POINT_DATA_H
+#define QWT_DECIMATED_POINT_DATA_H 1
+
+#include "qwt_global.h"
+#include "qwt_series_data.h"
+#include <qvector.h>
+
+/*!
+  \brief Growing series with a min/max pyramid for large time series
+
+  Samples are appended one by one or by blocks, with non decreasing
+  x values ( f.e. the time column of a simulation output ).
+  For every level k the pyramid keeps the minimum and the maximum
+  of each block of factor^(k+1) samples. The levels are updated
+  incrementally by append(), so the cost of an append is
+  proportional to the number of levels.
+
+  size() and sample() do not iterate over the raw samples but over
+  a view: the samples inside the rectangle of interest, reduced
+  to at most two points ( minimum and maximum ) per pixel column
+  using the coarsest level that keeps this resolution.
+  The view is rebuilt lazily when the rectangle of interest,
+  the resolution or the samples change.
+
+  When a sample with a decreasing x value is appended the
+  pyramid can't be used anymore and the view falls back to all
+  samples.
+
+  \sa QwtPlotDecimatedCurve
+*/
+class QWT_EXPORT QwtDecimatedPointData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtDecimatedPointData( int factor = 4 );
+
+    void append( double x, double y );
+    void append( const double *x, const double *y, size_t size );
+    void clear();
+
+    size_t rawSize() const;
+    QPointF rawSample( size_t index ) const;
+
+    int factor() const;
+    int levels() const;
+
+    int levelSize( int level ) const;
+    double levelMinimum( int level, int block ) const;
+    double levelMaximum( int level, int block ) const;
+
+    void setResolution( int pixels );
+    int resolution() const;
+
+    virtual void setRectOfInterest( const QRectF & );
+
+    void selectView( double x1, double x2, int pixels ) const;
+
+    virtual QRectF boundingRect() const;
+    virtual size_t size() const;
+    virtual QPointF sample( size_t index ) const;
+
+private:
+    class Bucket
+    {
+    public:
+        double min;
+        double max;
+        size_t minIndex;
+        size_t maxIndex;
+    };
+
+    void addLevel();
+    void updateView() const;
+    void appendView( size_t index ) const;
+
+    int d_factor;
+    QVector<double> d_x;
+    QVector<double> d_y;
+    QVector< QVector<Bucket> > d_levels;
+    bool d_sorted;
+
+    mutable double d_x1;
+    mutable double d_x2;
+    mutable int d_pixels;
+    mutable bool d_dirty;
+    mutable QVector<QPointF> d_view;
+};
+
+#endif
@@ -0,0 +1,131 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_decimated_curve.h"
+#include "qwt_scale_map.h"
+#include <qmath.h>
+
+/*!
+  Constructor
+  \param title Title of the curve
+*/
+QwtPlotDecimatedCurve::QwtPlotDecimatedCurve( const QString &title ):
+    QwtPlotCurve( QwtText( title ) )
+{
+    setData( new QwtDecimatedPointData() );
+}
+
+/*!
+  Constructor
+  \param title Title of the curve
+*/
+QwtPlotDecimatedCurve::QwtPlotDecimatedCurve( const QwtText &title ):
+    QwtPlotCurve( title )
+{
+    setData( new QwtDecimatedPointData() );
+}
+
+//! Destructor
+QwtPlotDecimatedCurve::~QwtPlotDecimatedCurve()
+{
+}
+
+/*!
+  \return Decimated samples, or NULL when the data has been replaced
+          by setData() with another type of series
+*/
+QwtDecimatedPointData *QwtPlotDecimatedCurve::decimatedData()
+{
+    return dynamic_cast<QwtDecimatedPointData *>( data() );
+}
+
+/*!
+  \return Decimated samples, or NULL when the data has been replaced
+          by setData() with another type of series
+*/
+const QwtDecimatedPointData *QwtPlotDecimatedCurve::decimatedData() const
+{
+    return dynamic_cast<const QwtDecimatedPointData *>( data() );
+}
+
+/*!
+  Append a sample
+
+  The curve is not repainted, call QwtPlot::replot() when
+  a block of samples has been appended.
+
+  \param x X value, expected to be >= the x value of the previous sample
+  \param y Y value
+*/
+void QwtPlotDecimatedCurve::appendSample( double x, double y )
+{
+    QwtDecimatedPointData *samples = decimatedData();
+    if ( samples )
+    {
+        samples->append( x, y );
+        dataChanged();
+    }
+}
+
+/*!
+  Append a block of samples
+
+  \param x Array of x values
+  \param y Array of y values
+  \param size Size of the x and y arrays
+  \sa appendSample()
+*/
+void QwtPlotDecimatedCurve::appendSamples(
+    const double *x, const double *y, size_t size )
+{
+    QwtDecimatedPointData *samples = decimatedData();
+    if ( samples && size > 0 )
+    {
+        samples->append( x, y, size );
+        dataChanged();
+    }
+}
+
+//! Remove all samples
+void QwtPlotDecimatedCurve::clearSamples()
+{
+    QwtDecimatedPointData *samples = decimatedData();
+    if ( samples )
+    {
+        samples->clear();
+        dataChanged();
+    }
+}
+
+/*!
+  Reduce the samples to the visible interval and the resolution of
+  the canvas, then draw them like QwtPlotCurve::drawSeries()
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+  \param from Index of the first point of the view to be painted
+  \param to Index of the last point of the view to be painted. If to < 0 the
+         curve will be painted to its last point.
+*/
+void QwtPlotDecimatedCurve::drawSeries( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    const QwtDecimatedPointData *samples = decimatedData();
+    if ( samples )
+    {
+        const int pixels = qCeil( qAbs( xMap.p2() - xMap.p1() ) );
+        samples->selectView( qMin( xMap.s1(), xMap.s2() ),
+            qMax( xMap.s1(), xMap.s2() ), pixels );
+    }
+
+    QwtPlotCurve::drawSeries( painter, xMap, yMap, canvasRect, from, to );
+}
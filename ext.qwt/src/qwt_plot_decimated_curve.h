@@ -0,0 +1,55 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PLOT_DECIMATED_CURVE_H
+#define QWT_PLOT_DECIMATED_CURVE_H 1
+
+#include "qwt_global.h"
+#include "qwt_plot_curve.h"
+#include "qwt_decimated_point_data.h"
+
+/*!
+  \brief A curve drawing large growing series through a min/max pyramid
+
+  Before each paint the visible x interval and the width of the canvas
+  are passed to QwtDecimatedPointData::selectView(), so that only about
+  two points per pixel column are mapped. The default paint attributes
+  of QwtPlotCurve ( ClipPolygons and FilterPoints, that enables
+  QwtPointMapper::WeedOutPoints ) are applied on the reduced polygon.
+
+  \code
+    QwtPlotDecimatedCurve *curve = new QwtPlotDecimatedCurve( "x" );
+    curve->attach( plot );
+
+    // every time new rows are available
+    curve->appendSamples( time, values, rows );
+    plot->replot();
+  \endcode
+*/
+class QWT_EXPORT QwtPlotDecimatedCurve: public QwtPlotCurve
+{
+public:
+    explicit QwtPlotDecimatedCurve( const QString &title = QString() );
+    explicit QwtPlotDecimatedCurve( const QwtText &title );
+
+    virtual ~QwtPlotDecimatedCurve();
+
+    void appendSample( double x, double y );
+    void appendSamples( const double *x, const double *y, size_t size );
+    void clearSamples();
+
+    QwtDecimatedPointData *decimatedData();
+    const QwtDecimatedPointData *decimatedData() const;
+
+    virtual void drawSeries( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+};
+
+#endif
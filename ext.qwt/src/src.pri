@@ -134,6 +134,8 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_series_data.h \
         qwt_series_store.h \
         qwt_point_data.h \
+        qwt_decimated_point_data.h \
+        qwt_plot_decimated_curve.h \
         qwt_scale_widget.h 
 
     SOURCES += \
@@ -180,6 +182,8 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_sampling_thread.cpp \
         qwt_series_data.cpp \
         qwt_point_data.cpp \
+        qwt_decimated_point_data.cpp \
+        qwt_plot_decimated_curve.cpp \
         qwt_scale_widget.cpp
 
     contains(QWT_CONFIG, QwtOpenGL) {
@@ -0,0 +1,228 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/unit-test.hpp>
+#include <qwt_decimated_point_data.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/*
+ * A noisy signal with spikes, so that the minimum and the maximum of a
+ * block are not always its first or last sample.
+ */
+double signal(int i)
+{
+    const double spike = (i % 37 == 0) ? 50.0 : ((i % 53 == 0) ? -50.0 : 0.0);
+    return 10.0 * std::sin(0.01 * i) + std::fmod(i * 7919.0, 13.0) + spike;
+}
+
+/*
+ * Checks every block of every level against the raw samples, and that
+ * the number of levels is the one needed for rawSize() samples.
+ */
+void checkPyramid(const QwtDecimatedPointData& data)
+{
+    const int n = static_cast<int>(data.rawSize());
+    const int factor = data.factor();
+
+    int blockSize = factor;
+    for (int k = 0; k < data.levels(); k++) {
+        EnsuresEqual(data.levelSize(k), (n + blockSize - 1) / blockSize);
+
+        for (int b = 0; b < data.levelSize(k); b++) {
+            double min = data.rawSample(b * blockSize).y();
+            double max = min;
+            for (int i = b * blockSize; i < std::min(n, (b + 1) * blockSize);
+                 i++) {
+                min = std::min(min, data.rawSample(i).y());
+                max = std::max(max, data.rawSample(i).y());
+            }
+            EnsuresEqual(data.levelMinimum(k, b), min);
+            EnsuresEqual(data.levelMaximum(k, b), max);
+        }
+        blockSize *= factor;
+    }
+
+    // blockSize is factor^(levels + 1): the top level has at most factor
+    // blocks, and it would have only one block with one level less
+    Ensures(n <= blockSize);
+    Ensures(data.levels() == 0 or n > blockSize / factor);
+}
+
+/*
+ * Checks that the view is made of raw samples in increasing x order and
+ * that it is reduced to at most two samples per pixel column, plus the
+ * two partial blocks and the two samples around the interval.
+ */
+void checkView(const QwtDecimatedPointData& data, double x1, double x2,
+               int pixels)
+{
+    data.selectView(x1, x2, pixels);
+
+    const size_t size = data.size();
+    Ensures(size <= 2 * static_cast<size_t>(pixels) + 6);
+    Ensures(size <= data.rawSize());
+
+    for (size_t i = 0; i < size; i++) {
+        const QPointF p = data.sample(i);
+        const size_t index = static_cast<size_t>(p.x());
+        Ensures(index < data.rawSize());
+        EnsuresEqual(data.rawSample(index).y(), p.y());
+        if (i > 0) {
+            Ensures(data.sample(i - 1).x() < p.x());
+        }
+    }
+
+    if (size > 0 and x1 <= x2) {
+        Ensures(data.sample(0).x() <= std::max(x1, 0.0));
+        Ensures(data.sample(size - 1).x() >=
+                std::min(x2, data.rawSample(data.rawSize() - 1).x()));
+    }
+}
+
+}
+
+void test_levels_incremental()
+{
+    QwtDecimatedPointData data(4);
+    EnsuresEqual(data.levels(), 0);
+
+    for (int i = 0; i < 5000; i++) {
+        data.append(i, signal(i));
+        if (i < 300 or i % 97 == 0) {
+            checkPyramid(data);
+        }
+    }
+    checkPyramid(data);
+    EnsuresEqual(data.levels(), 6);//4^6 < 5000 <= 4^7
+}
+
+void test_levels_block_append()
+{
+    std::vector<double> x(3000), y(3000);
+    for (int i = 0; i < 3000; i++) {
+        x[i] = i;
+        y[i] = signal(i);
+    }
+
+    QwtDecimatedPointData byBlocks(3);
+    byBlocks.append(x.data(), y.data(), 1000);
+    checkPyramid(byBlocks);
+    byBlocks.append(x.data() + 1000, y.data() + 1000, 2000);
+    checkPyramid(byBlocks);
+
+    QwtDecimatedPointData oneByOne(3);
+    for (int i = 0; i < 3000; i++) {
+        oneByOne.append(x[i], y[i]);
+    }
+    EnsuresEqual(byBlocks.levels(), oneByOne.levels());
+    for (int k = 0; k < oneByOne.levels(); k++) {
+        EnsuresEqual(byBlocks.levelSize(k), oneByOne.levelSize(k));
+    }
+
+    byBlocks.clear();
+    EnsuresEqual(byBlocks.levels(), 0);
+    EnsuresEqual(byBlocks.rawSize(), 0u);
+    EnsuresEqual(byBlocks.size(), 0u);
+}
+
+void test_view_selection()
+{
+    QwtDecimatedPointData data(4);
+    for (int i = 0; i < 2000; i++) {
+        data.append(i, signal(i));
+    }
+
+    // all samples, then zoom in and out
+    checkView(data, 0.0, -1.0, 100);
+    checkView(data, 0.0, 1999.0, 100);
+    checkView(data, 500.0, 1500.0, 100);
+    checkView(data, 990.0, 1010.0, 100);
+    checkView(data, 0.0, 1999.0, 10);
+    checkView(data, 123.5, 1777.25, 1);
+
+    // few samples in the interval: no reduction
+    data.selectView(990.0, 1010.0, 100);
+    EnsuresEqual(data.size(), 23u);
+
+    // the view follows the appends
+    checkView(data, 0.0, -1.0, 50);
+    EnsuresEqual(data.sample(data.size() - 1).x(), 1999.0);
+    for (int i = 2000; i < 20000; i++) {
+        data.append(i, signal(i));
+        if (i % 1000 == 0) {
+            checkView(data, 0.0, -1.0, 50);
+            checkView(data, i - 3000.0, i, 50);
+        }
+    }
+    checkView(data, 0.0, -1.0, 50);
+    EnsuresEqual(data.sample(data.size() - 1).x(), 19999.0);
+
+    // the extrema of the whole series are kept when it is reduced
+    double rawMin = data.rawSample(0).y();
+    double rawMax = rawMin;
+    for (size_t i = 0; i < data.rawSize(); i++) {
+        rawMin = std::min(rawMin, data.rawSample(i).y());
+        rawMax = std::max(rawMax, data.rawSample(i).y());
+    }
+    data.selectView(0.0, 19999.0, 200);
+    Ensures(data.size() < data.rawSize());
+    double min = data.sample(0).y();
+    double max = min;
+    for (size_t i = 0; i < data.size(); i++) {
+        min = std::min(min, data.sample(i).y());
+        max = std::max(max, data.sample(i).y());
+    }
+    EnsuresEqual(min, rawMin);
+    EnsuresEqual(max, rawMax);
+}
+
+void test_view_unsorted()
+{
+    QwtDecimatedPointData data(4);
+    for (int i = 0; i < 100; i++) {
+        data.append(i, signal(i));
+    }
+    data.append(50.0, 0.0);
+
+    // without sorted x values the view falls back to all samples
+    data.selectView(10.0, 20.0, 10);
+    EnsuresEqual(data.size(), data.rawSize());
+}
+
+int main()
+{
+    test_levels_incremental();
+    test_levels_block_append();
+    test_view_selection();
+    test_view_unsorted();
+
+    return unit_test::report_errors();
+}
@@ -0,0 +1,196 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_EXT_SHAPELIB_SHAPEEXECUTIVE_HPP
+#define VLE_EXT_SHAPELIB_SHAPEEXECUTIVE_HPP
+
+#include <shapemap.hpp>
+
+#include <vle/devs/Executive.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/vpz/Condition.hpp>
+
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace shapelib {
+
+/**
+ * @brief An executive that builds one model per record of a shapefile
+ * and connects the neighbour polygons (see computeAdjacency()).
+ *
+ * The generated models follow the CellDevs conventions: each model has
+ * an input port per neighbour named after the neighbour, the neighbour's
+ * "out" port is connected to it, and the set of neighbour names is given
+ * on the "Neighbourhood" port of the class condition.
+ *
+ * Conditions:
+ * - "shapefile" (string): the shapefile path without extension.
+ * - "class" (string): the class used to create each model.
+ * - "condition" (string): the condition of the class filled for each
+ *   record with "Neighbourhood" and the columns.
+ * - "columns" (set of strings, optional): DBF fields copied to the ports
+ *   of the same name, as doubles for numeric fields and strings otherwise.
+ * - "prefix" (string, optional, "cell_"): prefix of the model names.
+ * - "tolerance" (double, optional, 0): vertex snapping step.
+ *
+ * Use it directly with DECLARE_EXECUTIVE(vle::shapelib::ShapeExecutive)
+ * or derive from it to override name().
+ */
+class ShapeExecutive : public vle::devs::Executive
+{
+public:
+    ShapeExecutive(const vle::devs::ExecutiveInit& init,
+                   const vle::devs::InitEventList& events)
+      : vle::devs::Executive(init, events)
+      , mPrefix("cell_")
+      , mTolerance(0.0)
+    {
+        mShapefile = events.getString("shapefile");
+        mClass = events.getString("class");
+        mCondition = events.getString("condition");
+
+        if (events.exist("prefix"))
+            mPrefix = events.getString("prefix");
+
+        if (events.exist("tolerance"))
+            mTolerance = events.getDouble("tolerance");
+
+        if (events.exist("columns")) {
+            const auto& columns = events.getSet("columns");
+            for (std::size_t i = 0, e = columns.size(); i != e; ++i)
+                mColumns.push_back(columns.getString(i));
+        }
+    }
+
+    virtual ~ShapeExecutive() = default;
+
+    virtual vle::devs::Time init(vle::devs::Time /* time */) override
+    {
+        ShapeGeometry geometry(mShapefile);
+        AttributeTable table;
+        if (not mColumns.empty()) {
+            table = AttributeTable(mShapefile);
+            if (table.size() != geometry.size())
+                throw vle::utils::ModellingError(
+                  "ShapeExecutive: .dbf and .shp record counts differ");
+        }
+
+        mAdjacency = computeAdjacency(geometry, mTolerance);
+
+        const std::size_t records = geometry.size();
+        mNames.resize(records);
+        for (std::size_t r = 0; r != records; ++r)
+            mNames[r] = name(r);
+
+        std::vector<std::vector<double>> numbers(mColumns.size());
+        std::vector<std::vector<std::string>> strings(mColumns.size());
+        for (std::size_t c = 0, e = mColumns.size(); c != e; ++c) {
+            int field = table.fieldIndex(mColumns[c]);
+            if (field < 0)
+                throw vle::utils::ModellingError(
+                  "ShapeExecutive: unknown column " + mColumns[c]);
+
+            if (table.isNumeric(field))
+                numbers[c] = table.numbers(mColumns[c]);
+            else
+                strings[c] = table.strings(mColumns[c]);
+        }
+
+        auto& condition = conditions().get(mCondition);
+
+        for (std::size_t r = 0; r != records; ++r) {
+            auto neighbourhood = vle::value::Set::create();
+            for (std::size_t p = mAdjacency.offsets[r],
+                             e = mAdjacency.offsets[r + 1];
+                 p != e;
+                 ++p)
+                neighbourhood->toSet().addString(
+                  mNames[mAdjacency.indices[p]]);
+
+            condition.setValueToPort("Neighbourhood",
+                                     std::move(neighbourhood));
+
+            for (std::size_t c = 0, e = mColumns.size(); c != e; ++c) {
+                if (not numbers[c].empty())
+                    condition.setValueToPort(
+                      mColumns[c], vle::value::Double::create(numbers[c][r]));
+                else
+                    condition.setValueToPort(
+                      mColumns[c], vle::value::String::create(strings[c][r]));
+            }
+
+            createModelFromClass(mClass, mNames[r]);
+
+            for (std::size_t p = mAdjacency.offsets[r],
+                             e = mAdjacency.offsets[r + 1];
+                 p != e;
+                 ++p)
+                addInputPort(mNames[r], mNames[mAdjacency.indices[p]]);
+        }
+
+        for (std::size_t r = 0; r != records; ++r)
+            for (std::size_t p = mAdjacency.offsets[r],
+                             e = mAdjacency.offsets[r + 1];
+                 p != e;
+                 ++p) {
+                const std::string& neighbour = mNames[mAdjacency.indices[p]];
+                addConnection(neighbour, "out", mNames[r], neighbour);
+            }
+
+        return vle::devs::infinity;
+    }
+
+protected:
+    /** @return the name of the model built for the record @e record. */
+    virtual std::string name(std::size_t record) const
+    {
+        return mPrefix + std::to_string(record);
+    }
+
+    const Adjacency& adjacency() const { return mAdjacency; }
+    const std::vector<std::string>& names() const { return mNames; }
+
+private:
+    std::string mShapefile;
+    std::string mClass;
+    std::string mCondition;
+    std::string mPrefix;
+    std::vector<std::string> mColumns;
+    double mTolerance;
+
+    Adjacency mAdjacency;
+    std::vector<std::string> mNames;
+};
+
+}
+} // namespace vle shapelib
+
+#endif
@@ -0,0 +1,662 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shapemap.hpp"
+
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vle {
+namespace shapelib {
+
+/*
+ * MappedFile
+ */
+
+MappedFile::MappedFile(const std::string& filename)
+{
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw vle::utils::FileError(
+          vle::utils::format("Shapefile: cannot open `%s'", filename.c_str()));
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw vle::utils::FileError(
+          vle::utils::format("Shapefile: cannot stat `%s'", filename.c_str()));
+    }
+
+    mSize = static_cast<std::size_t>(st.st_size);
+    if (mSize > 0) {
+        void* ptr = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED) {
+            ::madvise(ptr, mSize, MADV_SEQUENTIAL);
+            mData = static_cast<const unsigned char*>(ptr);
+            mMapped = true;
+        }
+    }
+    ::close(fd);
+
+    if (mMapped or mSize == 0)
+        return;
+#endif
+
+    std::ifstream ifs(filename, std::ios::binary);
+    if (not ifs)
+        throw vle::utils::FileError(
+          vle::utils::format("Shapefile: cannot open `%s'", filename.c_str()));
+
+    ifs.seekg(0, std::ios::end);
+    mBuffer.resize(static_cast<std::size_t>(ifs.tellg()));
+    ifs.seekg(0, std::ios::beg);
+    ifs.read(reinterpret_cast<char*>(mBuffer.data()), mBuffer.size());
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile&
+MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        mBuffer = std::move(other.mBuffer);
+        mSize = other.mSize;
+        mMapped = other.mMapped;
+        mData = mMapped ? other.mData : mBuffer.data();
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mMapped = false;
+    }
+    return *this;
+}
+
+void
+MappedFile::release()
+{
+#ifndef _WIN32
+    if (mMapped)
+        ::munmap(const_cast<unsigned char*>(mData), mSize);
+#endif
+    mBuffer.clear();
+    mData = nullptr;
+    mSize = 0;
+    mMapped = false;
+}
+
+/*
+ * Shapefiles mix big endian (file and record headers) and little endian
+ * (contents) integers. Every field is read byte by byte so the decoding
+ * does not depend on the host or on alignment.
+ */
+
+namespace {
+
+inline std::int32_t
+readBig32(const unsigned char* p)
+{
+    return static_cast<std::int32_t>(
+      (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) |
+      (std::uint32_t(p[2]) << 8) | std::uint32_t(p[3]));
+}
+
+inline std::int32_t
+readLittle32(const unsigned char* p)
+{
+    return static_cast<std::int32_t>(
+      (std::uint32_t(p[3]) << 24) | (std::uint32_t(p[2]) << 16) |
+      (std::uint32_t(p[1]) << 8) | std::uint32_t(p[0]));
+}
+
+inline std::uint16_t
+readLittle16(const unsigned char* p)
+{
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline double
+readDouble(const unsigned char* p)
+{
+    std::uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i)
+        bits = (bits << 8) | p[i];
+
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline BoundingBox
+readBox(const unsigned char* p)
+{
+    return { readDouble(p), readDouble(p + 8), readDouble(p + 16),
+             readDouble(p + 24) };
+}
+
+[[noreturn]] void
+truncated(const std::string& filename)
+{
+    throw vle::utils::FileError(
+      vle::utils::format("Shapefile: `%s' is truncated", filename.c_str()));
+}
+
+bool
+hasPoints(int type)
+{
+    switch (type) {
+    case 1:  // Point
+    case 11: // PointZ
+    case 21: // PointM
+    case 3:  // PolyLine
+    case 13:
+    case 23:
+    case 5: // Polygon
+    case 15:
+    case 25:
+    case 8: // MultiPoint
+    case 18:
+    case 28:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // anonymous namespace
+
+/*
+ * ShapeGeometry
+ */
+
+ShapeGeometry::ShapeGeometry(const std::string& basename)
+{
+    const std::string shpname = basename + ".shp";
+    const std::string shxname = basename + ".shx";
+    MappedFile shp(shpname);
+    MappedFile shx(shxname);
+
+    if (shp.size() < 100)
+        truncated(shpname);
+    if (shx.size() < 100)
+        truncated(shxname);
+    if (readBig32(shp.data()) != 9994)
+        throw vle::utils::FileError(vle::utils::format(
+          "Shapefile: `%s' is not a shapefile", shpname.c_str()));
+
+    mShapeType = readLittle32(shp.data() + 32);
+    mExtent = readBox(shp.data() + 36);
+
+    const std::size_t records = (shx.size() - 100) / 8;
+    const unsigned char* index = shx.data() + 100;
+
+    /*
+     * A first pass over the index and the record headers sizes the flat
+     * point and part arrays so that the second pass never reallocates.
+     */
+    std::size_t totalPoints = 0, totalParts = 0;
+    for (std::size_t i = 0; i != records; ++i) {
+        const std::size_t offset = std::size_t(readBig32(index + 8 * i)) * 2;
+        if (offset + 8 + 4 > shp.size())
+            truncated(shpname);
+
+        const unsigned char* rec = shp.data() + offset + 8;
+        const int type = readLittle32(rec);
+        if (type == 1 or type == 11 or type == 21) {
+            totalParts += 1;
+            totalPoints += 1;
+        } else if (type == 8 or type == 18 or type == 28) {
+            if (offset + 8 + 40 > shp.size())
+                truncated(shpname);
+            totalParts += 1;
+            totalPoints += readLittle32(rec + 36);
+        } else if (hasPoints(type)) {
+            if (offset + 8 + 44 > shp.size())
+                truncated(shpname);
+            totalParts += readLittle32(rec + 36);
+            totalPoints += readLittle32(rec + 40);
+        }
+    }
+
+    mBounds.resize(records);
+    mPointOffsets.resize(records + 1);
+    mPartOffsets.resize(records + 1);
+    mParts.reserve(totalParts);
+    mX.reserve(totalPoints);
+    mY.reserve(totalPoints);
+
+    for (std::size_t i = 0; i != records; ++i) {
+        mPointOffsets[i] = mX.size();
+        mPartOffsets[i] = mParts.size();
+
+        const std::size_t offset = std::size_t(readBig32(index + 8 * i)) * 2;
+        const std::size_t length =
+          std::size_t(readBig32(index + 8 * i + 4)) * 2;
+        if (offset + 8 + length > shp.size())
+            truncated(shpname);
+
+        const unsigned char* rec = shp.data() + offset + 8;
+        const int type = readLittle32(rec);
+
+        if (type == 1 or type == 11 or type == 21) {
+            if (length < 20)
+                truncated(shpname);
+
+            const double x = readDouble(rec + 4), y = readDouble(rec + 12);
+            mBounds[i] = { x, y, x, y };
+            mParts.push_back(mX.size());
+            mX.push_back(x);
+            mY.push_back(y);
+        } else if (hasPoints(type)) {
+            const bool multipoint = (type == 8 or type == 18 or type == 28);
+            const std::size_t nparts =
+              multipoint ? 1 : std::size_t(readLittle32(rec + 36));
+            const std::size_t npoints =
+              std::size_t(readLittle32(rec + (multipoint ? 36 : 40)));
+            const unsigned char* partptr = rec + 44;
+            const unsigned char* pointptr =
+              multipoint ? rec + 40 : partptr + 4 * nparts;
+
+            if (pointptr + 16 * npoints > rec + length)
+                truncated(shpname);
+
+            mBounds[i] = readBox(rec + 4);
+
+            const std::size_t first = mX.size();
+            if (multipoint) {
+                mParts.push_back(first);
+            } else {
+                for (std::size_t p = 0; p != nparts; ++p)
+                    mParts.push_back(first +
+                                     readLittle32(partptr + 4 * p));
+            }
+
+            for (std::size_t p = 0; p != npoints; ++p) {
+                mX.push_back(readDouble(pointptr + 16 * p));
+                mY.push_back(readDouble(pointptr + 16 * p + 8));
+            }
+        } else {
+            mBounds[i] = { 0, 0, 0, 0 };
+        }
+    }
+
+    mPointOffsets[records] = mX.size();
+    mPartOffsets[records] = mParts.size();
+}
+
+/*
+ * AttributeTable
+ */
+
+AttributeTable::AttributeTable(const std::string& basename)
+  : mFile(basename + ".dbf")
+{
+    const std::string dbfname = basename + ".dbf";
+    const unsigned char* data = mFile.data();
+
+    if (mFile.size() < 32)
+        truncated(dbfname);
+
+    mRecords = static_cast<std::uint32_t>(readLittle32(data + 4));
+    mHeaderSize = readLittle16(data + 8);
+    mRecordSize = readLittle16(data + 10);
+
+    if (mHeaderSize > mFile.size())
+        truncated(dbfname);
+
+    // The first byte of a record is the deletion flag.
+    std::size_t offset = 1;
+    for (std::size_t p = 32; p + 32 <= mHeaderSize and data[p] != 0x0D;
+         p += 32) {
+        Field field;
+        const char* name = reinterpret_cast<const char*>(data + p);
+        field.name.assign(name, strnlen(name, 11));
+        field.type = static_cast<char>(data[p + 11]);
+        field.width = data[p + 16];
+        field.decimals = data[p + 17];
+        field.offset = offset;
+        offset += field.width;
+        mFields.push_back(std::move(field));
+    }
+
+    if (mHeaderSize + mRecords * mRecordSize > mFile.size()) {
+        // Some writers omit the end of file marker, others stop early:
+        // keep the complete records only.
+        mRecords = (mFile.size() - mHeaderSize) / std::max<std::size_t>(
+                                                    mRecordSize, 1);
+    }
+}
+
+int
+AttributeTable::fieldIndex(const std::string& name) const
+{
+    for (std::size_t i = 0, e = mFields.size(); i != e; ++i)
+        if (mFields[i].name == name)
+            return static_cast<int>(i);
+
+    return -1;
+}
+
+bool
+AttributeTable::isNumeric(int field) const
+{
+    return mFields[field].type == 'N' or mFields[field].type == 'F';
+}
+
+const AttributeTable::Field&
+AttributeTable::field_(const std::string& name) const
+{
+    int index = fieldIndex(name);
+    if (index < 0)
+        throw vle::utils::ArgError(
+          vle::utils::format("Shapefile: unknown field `%s'", name.c_str()));
+
+    return mFields[index];
+}
+
+std::vector<double>
+AttributeTable::numbers(const std::string& name) const
+{
+    const Field& field = field_(name);
+    std::vector<double> result(mRecords, 0.0);
+    char buffer[256];
+
+    for (std::size_t i = 0; i != mRecords; ++i) {
+        std::memcpy(buffer, record_(i) + field.offset, field.width);
+        buffer[field.width] = '\0';
+        result[i] = std::strtod(buffer, nullptr);
+    }
+
+    return result;
+}
+
+std::vector<std::string>
+AttributeTable::strings(const std::string& name) const
+{
+    const Field& field = field_(name);
+    std::vector<std::string> result(mRecords);
+
+    for (std::size_t i = 0; i != mRecords; ++i) {
+        const char* begin =
+          reinterpret_cast<const char*>(record_(i) + field.offset);
+        const char* end = begin + field.width;
+        while (end != begin and (end[-1] == ' ' or end[-1] == '\0'))
+            --end;
+        while (begin != end and *begin == ' ')
+            ++begin;
+        result[i].assign(begin, end);
+    }
+
+    return result;
+}
+
+/*
+ * Adjacency
+ */
+
+namespace {
+
+/*
+ * @return true if the point (px, py) lies on the segment (x0, y0) (x1, y1),
+ * within @e tolerance or, when @e tolerance is 0, within the rounding error
+ * of the cross product.
+ */
+bool
+onSegment(double px,
+          double py,
+          double x0,
+          double y0,
+          double x1,
+          double y1,
+          double tolerance)
+{
+    const double dx = x1 - x0, dy = y1 - y0;
+    const double ux = px - x0, uy = py - y0;
+    const double length2 = dx * dx + dy * dy;
+    const double dot = ux * dx + uy * dy;
+
+    if (length2 == 0.0 or dot < 0.0 or dot > length2)
+        return false;
+
+    const double cross = ux * dy - uy * dx;
+    if (tolerance > 0.0)
+        return cross * cross <= tolerance * tolerance * length2;
+
+    return std::abs(cross) <= 4 * std::numeric_limits<double>::epsilon() *
+                                (std::abs(ux * dy) + std::abs(uy * dx));
+}
+
+/*
+ * @return true if a vertex of the record @e a lies on an edge of the record
+ * @e b. Only the vertices and edges inside the intersection of the bounding
+ * boxes are tested, @e candidates is a scratch buffer.
+ */
+bool
+touches(const ShapeGeometry& geometry,
+        std::size_t a,
+        std::size_t b,
+        double tolerance,
+        std::vector<std::size_t>& candidates)
+{
+    const auto& xs = geometry.x();
+    const auto& ys = geometry.y();
+    const auto& parts = geometry.parts();
+    const BoundingBox& ba = geometry.bounds(a);
+    const BoundingBox& bb = geometry.bounds(b);
+    const BoundingBox box = { std::max(ba.xmin, bb.xmin) - tolerance,
+                              std::max(ba.ymin, bb.ymin) - tolerance,
+                              std::min(ba.xmax, bb.xmax) + tolerance,
+                              std::min(ba.ymax, bb.ymax) + tolerance };
+
+    candidates.clear();
+    for (std::size_t p = geometry.pointBegin(a), e = geometry.pointEnd(a);
+         p != e; ++p)
+        if (box.xmin <= xs[p] and xs[p] <= box.xmax and box.ymin <= ys[p] and
+            ys[p] <= box.ymax)
+            candidates.push_back(p);
+
+    if (candidates.empty())
+        return false;
+
+    for (std::size_t part = geometry.partBegin(b), e = geometry.partEnd(b);
+         part != e; ++part) {
+        const std::size_t last =
+          part + 1 != e ? parts[part + 1] : geometry.pointEnd(b);
+
+        for (std::size_t q = parts[part]; q + 1 < last; ++q) {
+            const BoundingBox edge = { std::min(xs[q], xs[q + 1]),
+                                       std::min(ys[q], ys[q + 1]),
+                                       std::max(xs[q], xs[q + 1]),
+                                       std::max(ys[q], ys[q + 1]) };
+            if (not edge.intersects(box))
+                continue;
+
+            for (std::size_t p : candidates)
+                if (onSegment(xs[p], ys[p], xs[q], ys[q], xs[q + 1],
+                              ys[q + 1], tolerance))
+                    return true;
+        }
+    }
+
+    return false;
+}
+
+} // anonymous namespace
+
+Adjacency
+computeAdjacency(const ShapeGeometry& geometry, double tolerance)
+{
+    struct Vertex
+    {
+        std::int64_t x, y;
+        std::size_t record;
+
+        bool operator<(const Vertex& o) const
+        {
+            return x < o.x or (x == o.x and (y < o.y or
+                                             (y == o.y and record < o.record)));
+        }
+    };
+
+    auto snap = [tolerance](double v) -> std::int64_t {
+        if (tolerance > 0.0)
+            return static_cast<std::int64_t>(std::llround(v / tolerance));
+
+        std::int64_t bits;
+        v = (v == 0.0) ? 0.0 : v; // -0.0 and 0.0 are the same vertex.
+        std::memcpy(&bits, &v, sizeof(bits));
+        return bits;
+    };
+
+    const std::size_t records = geometry.size();
+    const auto& xs = geometry.x();
+    const auto& ys = geometry.y();
+
+    std::vector<Vertex> vertices;
+    vertices.reserve(xs.size());
+    for (std::size_t r = 0; r != records; ++r)
+        for (std::size_t p = geometry.pointBegin(r), e = geometry.pointEnd(r);
+             p != e; ++p)
+            vertices.push_back({ snap(xs[p]), snap(ys[p]), r });
+
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end(),
+                               [](const Vertex& a, const Vertex& b) {
+                                   return a.x == b.x and a.y == b.y and
+                                          a.record == b.record;
+                               }),
+                   vertices.end());
+
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for (std::size_t i = 0, e = vertices.size(); i != e;) {
+        std::size_t j = i + 1;
+        while (j != e and vertices[j].x == vertices[i].x and
+               vertices[j].y == vertices[i].y)
+            ++j;
+
+        for (std::size_t a = i; a != j; ++a)
+            for (std::size_t b = a + 1; b != j; ++b) {
+                pairs.emplace_back(vertices[a].record, vertices[b].record);
+                pairs.emplace_back(vertices[b].record, vertices[a].record);
+            }
+
+        i = j;
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    /*
+     * Polygons also touch along an edge without sharing a vertex when the
+     * border is split differently on both sides. Two segments overlapping
+     * along a length always have a vertex of one inside the other, so the
+     * records whose bounding boxes intersect are swept by xmin and, for the
+     * pairs not found above, the vertices of each one are tested against
+     * the edges of the other.
+     */
+    std::vector<std::size_t> order;
+    order.reserve(records);
+    for (std::size_t r = 0; r != records; ++r)
+        if (geometry.pointBegin(r) != geometry.pointEnd(r))
+            order.push_back(r);
+
+    std::sort(order.begin(), order.end(),
+              [&geometry](std::size_t a, std::size_t b) {
+                  return geometry.bounds(a).xmin < geometry.bounds(b).xmin;
+              });
+
+    const std::size_t shared = pairs.size();
+    std::vector<std::size_t> candidates;
+    for (std::size_t i = 0, e = order.size(); i != e; ++i) {
+        const BoundingBox& bounds = geometry.bounds(order[i]);
+        const BoundingBox grown = { bounds.xmin - tolerance,
+                                    bounds.ymin - tolerance,
+                                    bounds.xmax + tolerance,
+                                    bounds.ymax + tolerance };
+
+        for (std::size_t j = i + 1;
+             j != e and geometry.bounds(order[j]).xmin <= grown.xmax;
+             ++j) {
+            if (not grown.intersects(geometry.bounds(order[j])))
+                continue;
+
+            const std::size_t a = std::min(order[i], order[j]);
+            const std::size_t b = std::max(order[i], order[j]);
+            if (std::binary_search(pairs.begin(), pairs.begin() + shared,
+                                   std::make_pair(a, b)))
+                continue;
+
+            if (touches(geometry, a, b, tolerance, candidates) or
+                touches(geometry, b, a, tolerance, candidates)) {
+                pairs.emplace_back(a, b);
+                pairs.emplace_back(b, a);
+            }
+        }
+    }
+
+    if (pairs.size() != shared)
+        std::sort(pairs.begin(), pairs.end());
+
+    Adjacency result;
+    result.offsets.assign(records + 1, 0);
+    result.indices.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+        result.offsets[pair.first + 1]++;
+        result.indices.push_back(pair.second);
+    }
+    for (std::size_t r = 0; r != records; ++r)
+        result.offsets[r + 1] += result.offsets[r];
+
+    return result;
+}
+
+}
+} // namespace vle shapelib
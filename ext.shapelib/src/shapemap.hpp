@@ -0,0 +1,241 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_EXT_SHAPELIB_SHAPEMAP_HPP
+#define VLE_EXT_SHAPELIB_SHAPEMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace shapelib {
+
+/**
+ * @brief A read-only view of a whole file. On POSIX systems the file is
+ * memory mapped, elsewhere it is read in one block.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const unsigned char* data() const { return mData; }
+    std::size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+private:
+    void release();
+
+    const unsigned char* mData = nullptr;
+    std::size_t mSize = 0;
+    std::vector<unsigned char> mBuffer;
+    bool mMapped = false;
+};
+
+struct BoundingBox
+{
+    double xmin, ymin, xmax, ymax;
+
+    bool intersects(const BoundingBox& o) const
+    {
+        return xmin <= o.xmax and o.xmin <= xmax and
+               ymin <= o.ymax and o.ymin <= ymax;
+    }
+};
+
+/**
+ * @brief The geometry of a shapefile, decoded in one pass from the
+ * mapped .shp and .shx files.
+ *
+ * Points of every record are stored in two flat arrays (x and y), records
+ * and parts only keep offsets into them. Null shapes are kept as empty
+ * records so that record indices match the rows of the .dbf file.
+ */
+class ShapeGeometry
+{
+public:
+    ShapeGeometry() = default;
+
+    /**
+     * @brief Read @e basename.shp and @e basename.shx.
+     * @throw vle::utils::FileError if a file is missing or truncated.
+     */
+    explicit ShapeGeometry(const std::string& basename);
+
+    int shapeType() const { return mShapeType; }
+    std::size_t size() const { return mBounds.size(); }
+    const BoundingBox& extent() const { return mExtent; }
+    const BoundingBox& bounds(std::size_t record) const
+    {
+        return mBounds[record];
+    }
+
+    std::size_t pointBegin(std::size_t record) const
+    {
+        return mPointOffsets[record];
+    }
+    std::size_t pointEnd(std::size_t record) const
+    {
+        return mPointOffsets[record + 1];
+    }
+    std::size_t partBegin(std::size_t record) const
+    {
+        return mPartOffsets[record];
+    }
+    std::size_t partEnd(std::size_t record) const
+    {
+        return mPartOffsets[record + 1];
+    }
+
+    /** First point (global index) of each part. */
+    const std::vector<std::size_t>& parts() const { return mParts; }
+    const std::vector<double>& x() const { return mX; }
+    const std::vector<double>& y() const { return mY; }
+
+private:
+    int mShapeType = 0;
+    BoundingBox mExtent = { 0, 0, 0, 0 };
+    std::vector<BoundingBox> mBounds;
+    std::vector<std::size_t> mPointOffsets;
+    std::vector<std::size_t> mPartOffsets;
+    std::vector<std::size_t> mParts;
+    std::vector<double> mX;
+    std::vector<double> mY;
+};
+
+/**
+ * @brief A memory mapped .dbf file. Columns are extracted in bulk by
+ * walking the fixed size records directly in the mapping.
+ */
+class AttributeTable
+{
+public:
+    struct Field
+    {
+        std::string name;
+        char type;
+        std::size_t offset;
+        std::size_t width;
+        int decimals;
+    };
+
+    AttributeTable() = default;
+
+    /**
+     * @brief Map @e basename.dbf.
+     * @throw vle::utils::FileError if the file is missing or truncated.
+     */
+    explicit AttributeTable(const std::string& basename);
+
+    std::size_t size() const { return mRecords; }
+    const std::vector<Field>& fields() const { return mFields; }
+
+    /** @return the index of the field @e name or -1. */
+    int fieldIndex(const std::string& name) const;
+
+    /** @return true if the field is a numeric one (N or F). */
+    bool isNumeric(int field) const;
+
+    /**
+     * @brief Parse a whole column of numbers. Empty cells are 0.
+     * @throw vle::utils::ArgError if @e name is not a field.
+     */
+    std::vector<double> numbers(const std::string& name) const;
+
+    /**
+     * @brief Read a whole column of strings with trailing blanks removed.
+     * @throw vle::utils::ArgError if @e name is not a field.
+     */
+    std::vector<std::string> strings(const std::string& name) const;
+
+    /** @return true if the record is flagged as deleted. */
+    bool deleted(std::size_t record) const
+    {
+        return record_(record)[0] == '*';
+    }
+
+private:
+    const Field& field_(const std::string& name) const;
+    const unsigned char* record_(std::size_t record) const
+    {
+        return mFile.data() + mHeaderSize + record * mRecordSize;
+    }
+
+    MappedFile mFile;
+    std::vector<Field> mFields;
+    std::size_t mRecords = 0;
+    std::size_t mHeaderSize = 0;
+    std::size_t mRecordSize = 0;
+};
+
+/**
+ * @brief Contiguity of the records of a shapefile in compressed sparse
+ * row form: neighbours of record @c i are
+ * @c indices[offsets[i]] .. @c indices[offsets[i + 1] - 1], sorted.
+ */
+struct Adjacency
+{
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> indices;
+
+    std::size_t size() const
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+    std::size_t degree(std::size_t record) const
+    {
+        return offsets[record + 1] - offsets[record];
+    }
+};
+
+/**
+ * @brief Compute the queen contiguity of the polygons: two records are
+ * neighbours if they share at least one vertex or if a vertex of one lies
+ * on an edge of the other (a border split differently on both sides).
+ *
+ * Vertices are snapped to a grid of step @e tolerance (exact coordinates
+ * when @e tolerance is 0) and sorted to build the vertex index, so the
+ * cost is O(n log n) in the number of points rather than quadratic in the
+ * number of polygons. Vertices on edges are only searched between the
+ * remaining records whose bounding boxes intersect, within the common
+ * box.
+ */
+Adjacency computeAdjacency(const ShapeGeometry& geometry,
+                           double tolerance = 0.0);
+
+}
+} // namespace vle shapelib
+
+#endif
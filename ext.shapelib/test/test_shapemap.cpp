@@ -0,0 +1,133 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2018 Gauthier Quesnel <gauthier.quesnel@inra.fr>
+ * Copyright (c) 2003-2018 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2018 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/unit-test.hpp>
+#include <vle/utils/Exception.hpp>
+#include <shapemap.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace vle::shapelib;
+
+/*
+ * touching.shp holds six polygons:
+ * - 0 "wide" [0,2]x[0,1] and 1 "below" [0.5,1.5]x[-1,0] share a part of
+ *   an edge but no vertex,
+ * - 2 "right" [2,3]x[0,1] shares two vertices with 0,
+ * - 3 "island" [5,6]x[5,6] touches nothing,
+ * - 4 "slope" (10,0) (12,2) (12,0) and 5 "wedge" (10.5,0.5) (10,2)
+ *   (11.5,1.5) share a part of the diagonal edge of 4.
+ */
+static const std::string fixture = SHAPELIB_TEST_DIR "/touching";
+
+static std::vector<std::size_t>
+neighbours(const Adjacency& adjacency, std::size_t record)
+{
+    return std::vector<std::size_t>(
+      adjacency.indices.begin() + adjacency.offsets[record],
+      adjacency.indices.begin() + adjacency.offsets[record + 1]);
+}
+
+void
+test_geometry()
+{
+    ShapeGeometry geometry(fixture);
+
+    EnsuresEqual(geometry.shapeType(), 5);
+    EnsuresEqual(geometry.size(), 6u);
+    EnsuresEqual(geometry.x().size(), 28u);
+    EnsuresEqual(geometry.parts().size(), 6u);
+    EnsuresApproximatelyEqual(geometry.extent().xmin, 0.0, 1e-12);
+    EnsuresApproximatelyEqual(geometry.extent().ymin, -1.0, 1e-12);
+    EnsuresApproximatelyEqual(geometry.extent().xmax, 12.0, 1e-12);
+    EnsuresApproximatelyEqual(geometry.extent().ymax, 6.0, 1e-12);
+
+    EnsuresEqual(geometry.pointEnd(4) - geometry.pointBegin(4), 4u);
+    EnsuresApproximatelyEqual(geometry.bounds(1).xmin, 0.5, 1e-12);
+    EnsuresApproximatelyEqual(geometry.bounds(1).ymax, 0.0, 1e-12);
+}
+
+void
+test_adjacency()
+{
+    ShapeGeometry geometry(fixture);
+    Adjacency adjacency = computeAdjacency(geometry);
+
+    EnsuresEqual(adjacency.size(), 6u);
+    Ensures(neighbours(adjacency, 0) == std::vector<std::size_t>({ 1, 2 }));
+    Ensures(neighbours(adjacency, 1) == std::vector<std::size_t>({ 0 }));
+    Ensures(neighbours(adjacency, 2) == std::vector<std::size_t>({ 0 }));
+    EnsuresEqual(adjacency.degree(3), 0u);
+    Ensures(neighbours(adjacency, 4) == std::vector<std::size_t>({ 5 }));
+    Ensures(neighbours(adjacency, 5) == std::vector<std::size_t>({ 4 }));
+
+    // A tolerance of 2 snaps the island to nothing but reaches the others.
+    Adjacency loose = computeAdjacency(geometry, 2.0);
+    EnsuresEqual(loose.degree(3), 0u);
+    Ensures(neighbours(loose, 1) == std::vector<std::size_t>({ 0, 2 }));
+}
+
+void
+test_attributes()
+{
+    AttributeTable table(fixture);
+
+    EnsuresEqual(table.size(), 6u);
+    EnsuresEqual(table.fields().size(), 3u);
+    EnsuresEqual(table.fieldIndex("AREA"), 1);
+    EnsuresEqual(table.fieldIndex("MISSING"), -1);
+    Ensures(table.isNumeric(table.fieldIndex("ID")));
+    Ensures(not table.isNumeric(table.fieldIndex("NAME")));
+
+    std::vector<double> ids = table.numbers("ID");
+    std::vector<double> areas = table.numbers("AREA");
+    std::vector<std::string> names = table.strings("NAME");
+    for (std::size_t i = 0; i != table.size(); ++i) {
+        EnsuresApproximatelyEqual(ids[i], i + 1.0, 1e-12);
+        Ensures(not table.deleted(i));
+    }
+    EnsuresApproximatelyEqual(areas[0], 2.0, 1e-12);
+    EnsuresApproximatelyEqual(areas[5], 0.75, 1e-12);
+    EnsuresEqual(names[0], "wide");
+    EnsuresEqual(names[3], "island");
+    EnsuresEqual(names[5], "wedge");
+
+    EnsuresThrow(table.numbers("MISSING"), vle::utils::ArgError);
+    EnsuresThrow(AttributeTable(SHAPELIB_TEST_DIR "/missing"),
+                 vle::utils::FileError);
+}
+
+int
+main()
+{
+    test_geometry();
+    test_adjacency();
+    test_attributes();
+
+    return unit_test::report_errors();
+}
@@ -0,0 +1,942 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+#include "ForresterKernel.h"
+
+namespace gvle {
+namespace forrester {
+
+/**
+ * @brief Node of the expression tree of a flow. Trees are immutable and
+ * shared between a flow and its derivatives.
+ */
+struct ForresterKernel::Node
+{
+    enum Kind
+    {
+        NUMBER, //value, text as written
+        STATE,  //compartment index, read in x
+        PARAM,  //parameter index
+        FLOW,   //flow index
+        SYMBOL, //bare identifier (t or a constant), text
+        ADD, SUB, MUL, DIV, NEG,
+        CALL    //function text of arguments a and b (pow only)
+    };
+
+    Kind        kind;
+    double      value;
+    std::size_t index;
+    std::string text;
+    NodePtr     a;
+    NodePtr     b;
+
+    Node(Kind k) :
+        kind(k), value(0), index(0), text(), a(), b()
+    {
+    }
+};
+
+/**
+ * @brief Recursive descent parser of an assisted compute.
+ */
+class ForresterKernel::Parser
+{
+public:
+    Parser(ForresterKernel& kernel, const std::string& expression) :
+        mKernel(kernel), mExpr(expression), mPos(0), mError()
+    {
+    }
+
+    NodePtr parse()
+    {
+        NodePtr result = parseSum();
+        skipSpaces();
+        if (result and mPos != mExpr.size()) {
+            return fail(std::string("unexpected '") + mExpr[mPos] + "'");
+        }
+        return result;
+    }
+
+    const std::string& error() const
+    { return mError; }
+
+private:
+    NodePtr fail(const std::string& msg)
+    {
+        if (mError.empty()) {
+            mError = msg;
+        }
+        return NodePtr();
+    }
+
+    void skipSpaces()
+    {
+        while (mPos < mExpr.size() and std::isspace(
+                static_cast<unsigned char>(mExpr[mPos]))) {
+            mPos++;
+        }
+    }
+
+    bool accept(char c)
+    {
+        skipSpaces();
+        if (mPos < mExpr.size() and mExpr[mPos] == c) {
+            mPos++;
+            return true;
+        }
+        return false;
+    }
+
+    NodePtr parseSum()
+    {
+        NodePtr left = parseProduct();
+        while (left) {
+            if (accept('+')) {
+                NodePtr right = parseProduct();
+                left = right ? ForresterKernel::add(left, right) : right;
+            } else if (accept('-')) {
+                NodePtr right = parseProduct();
+                left = right ? ForresterKernel::sub(left, right) : right;
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    NodePtr parseProduct()
+    {
+        NodePtr left = parseUnary();
+        while (left) {
+            if (accept('*')) {
+                NodePtr right = parseUnary();
+                left = right ? ForresterKernel::mul(left, right) : right;
+            } else if (accept('/')) {
+                NodePtr right = parseUnary();
+                left = right ? ForresterKernel::div(left, right) : right;
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    NodePtr parseUnary()
+    {
+        if (accept('-')) {
+            NodePtr operand = parseUnary();
+            return operand ? ForresterKernel::neg(operand) : operand;
+        }
+        if (accept('+')) {
+            return parseUnary();
+        }
+        return parsePrimary();
+    }
+
+    NodePtr parsePrimary()
+    {
+        skipSpaces();
+        if (mPos == mExpr.size()) {
+            return fail("unexpected end of expression");
+        }
+        if (accept('(')) {
+            NodePtr inner = parseSum();
+            if (inner and not accept(')')) {
+                return fail("missing ')'");
+            }
+            return inner;
+        }
+
+        char c = mExpr[mPos];
+        if (std::isdigit(static_cast<unsigned char>(c)) or c == '.') {
+            const char* begin = mExpr.c_str() + mPos;
+            char* end = 0;
+            double value = std::strtod(begin, &end);
+            if (end == begin) {
+                return fail("invalid number");
+            }
+            std::shared_ptr<Node> node = std::make_shared<Node>(Node::NUMBER);
+            node->value = value;
+            node->text.assign(begin, end - begin);
+            mPos += end - begin;
+            return node;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) or c == '_') {
+            std::string name = identifier();
+            if (not accept('(')) {
+                std::shared_ptr<Node> node =
+                    std::make_shared<Node>(Node::SYMBOL);
+                node->text = name;
+                return node;
+            }
+            if (accept(')')) {
+                return reference(name);
+            }
+            std::vector<NodePtr> args;
+            do {
+                NodePtr arg = parseSum();
+                if (not arg) {
+                    return arg;
+                }
+                args.push_back(arg);
+            } while (accept(','));
+            if (not accept(')')) {
+                return fail("missing ')'");
+            }
+            return function(name, args);
+        }
+        return fail(std::string("unexpected '") + c + "'");
+    }
+
+    std::string identifier()
+    {
+        std::string::size_type start = mPos;
+        for (;;) {
+            while (mPos < mExpr.size() and
+                   (std::isalnum(static_cast<unsigned char>(mExpr[mPos])) or
+                    mExpr[mPos] == '_')) {
+                mPos++;
+            }
+            if (mExpr.compare(mPos, 2, "::") != 0) {
+                break;
+            }
+            mPos += 2;
+        }
+        return mExpr.substr(start, mPos - start);
+    }
+
+    NodePtr reference(const std::string& name)
+    {
+        std::map<std::string, std::size_t>::const_iterator it;
+
+        it = mKernel.mCompIndex.find(name);
+        if (it != mKernel.mCompIndex.end()) {
+            std::shared_ptr<Node> node = std::make_shared<Node>(Node::STATE);
+            node->index = it->second;
+            return node;
+        }
+        it = mKernel.mParamIndex.find(name);
+        if (it != mKernel.mParamIndex.end()) {
+            std::shared_ptr<Node> node = std::make_shared<Node>(Node::PARAM);
+            node->index = it->second;
+            return node;
+        }
+        it = mKernel.mFlowIndex.find(name);
+        if (it != mKernel.mFlowIndex.end()) {
+            if (not mKernel.parseFlow(it->second)) {
+                return fail("depends on flow " + name + " ("
+                        + mKernel.mError + ")");
+            }
+            std::shared_ptr<Node> node = std::make_shared<Node>(Node::FLOW);
+            node->index = it->second;
+            return node;
+        }
+        return fail("unknown variable " + name + "()");
+    }
+
+    NodePtr function(std::string name, const std::vector<NodePtr>& args)
+    {
+        if (name.compare(0, 5, "std::") == 0) {
+            name.erase(0, 5);
+        }
+        if (name == "pow" and args.size() == 2) {
+            return ForresterKernel::call(name, args[0], args[1]);
+        }
+        if ((name == "exp" or name == "log" or name == "sqrt" or
+             name == "sin" or name == "cos" or name == "tan") and
+            args.size() == 1) {
+            return ForresterKernel::call(name, args[0]);
+        }
+        return fail("unsupported function " + name);
+    }
+
+    ForresterKernel&       mKernel;
+    const std::string&     mExpr;
+    std::string::size_type mPos;
+    std::string            mError;
+};
+
+ForresterKernel::ForresterKernel(const std::vector<std::string>& compartments,
+        const std::vector<std::string>& parameters) :
+    mComps(compartments), mParams(parameters), mFlows(), mCompIndex(),
+    mParamIndex(), mFlowIndex(), mLinksTo(compartments.size()),
+    mLinksFrom(compartments.size()), mPendingTo(), mPendingFrom(),
+    mTranslated(false), mError()
+{
+    for (std::size_t i = 0; i < mComps.size(); i++) {
+        mCompIndex[mComps[i]] = i;
+    }
+    for (std::size_t i = 0; i < mParams.size(); i++) {
+        mParamIndex[mParams[i]] = i;
+    }
+}
+
+ForresterKernel::~ForresterKernel()
+{
+}
+
+void
+ForresterKernel::addFlow(const std::string& name,
+        const std::string& expression)
+{
+    Flow flow;
+    flow.name = name;
+    flow.expression = expression;
+    flow.parsing = false;
+    mFlowIndex[name] = mFlows.size();
+    mFlows.push_back(flow);
+}
+
+void
+ForresterKernel::addLinkTo(const std::string& flow,
+        const std::string& compName)
+{
+    mPendingTo.push_back(std::make_pair(flow, compName));
+}
+
+void
+ForresterKernel::addLinkFrom(const std::string& flow,
+        const std::string& compName)
+{
+    mPendingFrom.push_back(std::make_pair(flow, compName));
+}
+
+bool
+ForresterKernel::translate()
+{
+    mTranslated = false;
+    mError.clear();
+
+    resolveLinks(mPendingTo, mLinksTo);
+    resolveLinks(mPendingFrom, mLinksFrom);
+
+    for (std::size_t f = 0; f < mFlows.size(); f++) {
+        if (not parseFlow(f)) {
+            return false;
+        }
+    }
+    for (std::size_t f = 0; f < mFlows.size(); f++) {
+        for (std::size_t j = 0; j < mComps.size(); j++) {
+            flowDerivative(f, j);
+        }
+    }
+    mTranslated = true;
+    return true;
+}
+
+void
+ForresterKernel::resolveLinks(
+        std::vector<std::pair<std::string, std::string>>& pending,
+        std::vector<std::vector<std::size_t>>& links)
+{
+    for (std::size_t i = 0; i < pending.size(); i++) {
+        std::map<std::string, std::size_t>::const_iterator flow =
+            mFlowIndex.find(pending[i].first);
+        std::map<std::string, std::size_t>::const_iterator comp =
+            mCompIndex.find(pending[i].second);
+        if (flow != mFlowIndex.end() and comp != mCompIndex.end()) {
+            links[comp->second].push_back(flow->second);
+        }
+    }
+    pending.clear();
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::parseFlow(std::size_t f)
+{
+    Flow& flow = mFlows[f];
+    if (flow.tree) {
+        return flow.tree;
+    }
+    if (flow.parsing) {
+        mError = "flow " + flow.name + ": cyclic dependency";
+        return NodePtr();
+    }
+    if (flow.expression.empty()) {
+        mError = "flow " + flow.name + ": advanced edition";
+        return NodePtr();
+    }
+
+    flow.parsing = true;
+    Parser parser(*this, flow.expression);
+    NodePtr tree = parser.parse();
+    mFlows[f].parsing = false;
+    if (not tree) {
+        if (mError.empty()) {
+            mError = "flow " + mFlows[f].name + ": " + parser.error();
+        }
+        return tree;
+    }
+    mFlows[f].tree = tree;
+    mFlows[f].derivatives.resize(mComps.size());
+    return tree;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::flowDerivative(std::size_t f, std::size_t comp)
+{
+    NodePtr& memo = mFlows[f].derivatives[comp];
+    if (not memo) {
+        memo = derivative(mFlows[f].tree, comp);
+    }
+    return memo;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::derivative(const NodePtr& node, std::size_t comp)
+{
+    switch (node->kind) {
+    case Node::NUMBER:
+    case Node::PARAM:
+    case Node::SYMBOL:
+        return number(0);
+    case Node::STATE:
+        return number(node->index == comp ? 1 : 0);
+    case Node::FLOW:
+        return flowDerivative(node->index, comp);
+    case Node::ADD:
+        return add(derivative(node->a, comp), derivative(node->b, comp));
+    case Node::SUB:
+        return sub(derivative(node->a, comp), derivative(node->b, comp));
+    case Node::NEG:
+        return neg(derivative(node->a, comp));
+    case Node::MUL:
+        return add(mul(derivative(node->a, comp), node->b),
+                   mul(node->a, derivative(node->b, comp)));
+    case Node::DIV: {
+        NodePtr da = derivative(node->a, comp);
+        NodePtr db = derivative(node->b, comp);
+        if (isNumber(db, 0)) {
+            return div(da, node->b);
+        }
+        return div(sub(mul(da, node->b), mul(node->a, db)),
+                   mul(node->b, node->b));
+    }
+    case Node::CALL: {
+        NodePtr da = derivative(node->a, comp);
+        const std::string& fn = node->text;
+        if (fn == "pow") {
+            if (not dependsOnState(node->b)) {
+                return mul(mul(node->b, call("pow", node->a,
+                                        sub(node->b, number(1)))), da);
+            }
+            NodePtr db = derivative(node->b, comp);
+            return mul(node, add(mul(db, call("log", node->a)),
+                                 div(mul(node->b, da), node->a)));
+        }
+        if (isNumber(da, 0)) {
+            return da;
+        }
+        if (fn == "exp") {
+            return mul(node, da);
+        } else if (fn == "log") {
+            return div(da, node->a);
+        } else if (fn == "sqrt") {
+            return div(da, mul(number(2), node));
+        } else if (fn == "sin") {
+            return mul(call("cos", node->a), da);
+        } else if (fn == "cos") {
+            return neg(mul(call("sin", node->a), da));
+        } else { //tan
+            NodePtr c = call("cos", node->a);
+            return div(da, mul(c, c));
+        }
+    }
+    }
+    return number(0);
+}
+
+std::string
+ForresterKernel::computeArrayBody() const
+{
+    std::string body;
+    if (not mTranslated) {
+        body += "    (void)t;\n    (void)x;\n    (void)dx;\n";
+        body += "    return false; // " + mError + "\n";
+        return body;
+    }
+
+    std::vector<bool> flows(mFlows.size(), false);
+    std::vector<bool> params(mParams.size(), false);
+    bool usesTime = false;
+    bool usesState = false;
+    for (std::size_t i = 0; i < mComps.size(); i++) {
+        for (std::size_t f : mLinksTo[i]) {
+            collectFlow(f, flows, params, usesTime, usesState);
+        }
+        for (std::size_t f : mLinksFrom[i]) {
+            collectFlow(f, flows, params, usesTime, usesState);
+        }
+    }
+
+    if (not usesTime) {
+        body += "    (void)t;\n";
+    }
+    if (not usesState) {
+        body += "    (void)x;\n";
+    }
+    body += printLocals(flows, params);
+
+    for (std::size_t i = 0; i < mComps.size(); i++) {
+        std::ostringstream line;
+        line << "    dx[" << i << "] = ";
+        if (mLinksTo[i].empty() and mLinksFrom[i].empty()) {
+            line << "0.0";
+        }
+        bool first = true;
+        for (std::size_t f : mLinksTo[i]) {
+            line << (first ? "" : " + ") << "f_" << mFlows[f].name;
+            first = false;
+        }
+        for (std::size_t f : mLinksFrom[i]) {
+            line << (first ? "-" : " - ") << "f_" << mFlows[f].name;
+            first = false;
+        }
+        line << "; // " << mComps[i] << "\n";
+        body += line.str();
+    }
+    body += "    return true;\n";
+    return body;
+}
+
+std::string
+ForresterKernel::jacobianBody() const
+{
+    std::string body;
+    if (not mTranslated) {
+        body += "    (void)t;\n    (void)x;\n    (void)jac;\n";
+        body += "    return false; // " + mError + "\n";
+        return body;
+    }
+
+    const std::size_t n = mComps.size();
+    std::vector<NodePtr> entries(n * n);
+    std::vector<bool> flows(mFlows.size(), false);
+    std::vector<bool> params(mParams.size(), false);
+    bool usesTime = false;
+    bool usesState = false;
+
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) {
+            NodePtr entry = number(0);
+            for (std::size_t f : mLinksTo[i]) {
+                entry = add(entry, mFlows[f].derivatives[j]);
+            }
+            for (std::size_t f : mLinksFrom[i]) {
+                entry = sub(entry, mFlows[f].derivatives[j]);
+            }
+            if (not isNumber(entry, 0)) {
+                collect(entry, flows, params, usesTime, usesState);
+                entries[i * n + j] = entry;
+            }
+        }
+    }
+
+    if (not usesTime) {
+        body += "    (void)t;\n";
+    }
+    if (not usesState) {
+        body += "    (void)x;\n";
+    }
+    body += "    for (int i = 0; i != stateSize * stateSize; ++i) {\n"
+            "        jac[i] = 0.0;\n"
+            "    }\n";
+    body += printLocals(flows, params);
+
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) {
+            const NodePtr& entry = entries[i * n + j];
+            if (entry) {
+                std::ostringstream line;
+                line << "    jac[" << i * n + j << "] = " << print(entry)
+                     << "; // d(" << mComps[i] << ")/d" << mComps[j] << "\n";
+                body += line.str();
+            }
+        }
+    }
+    body += "    return true;\n";
+    return body;
+}
+
+void
+ForresterKernel::collect(const NodePtr& node, std::vector<bool>& flows,
+        std::vector<bool>& params, bool& usesTime, bool& usesState) const
+{
+    switch (node->kind) {
+    case Node::STATE:
+        usesState = true;
+        break;
+    case Node::PARAM:
+        params[node->index] = true;
+        break;
+    case Node::FLOW:
+        collectFlow(node->index, flows, params, usesTime, usesState);
+        break;
+    case Node::SYMBOL:
+        if (node->text == "t") {
+            usesTime = true;
+        }
+        break;
+    default:
+        if (node->a) {
+            collect(node->a, flows, params, usesTime, usesState);
+        }
+        if (node->b) {
+            collect(node->b, flows, params, usesTime, usesState);
+        }
+        break;
+    }
+}
+
+void
+ForresterKernel::collectFlow(std::size_t f, std::vector<bool>& flows,
+        std::vector<bool>& params, bool& usesTime, bool& usesState) const
+{
+    if (not flows[f]) {
+        flows[f] = true;
+        collect(mFlows[f].tree, flows, params, usesTime, usesState);
+    }
+}
+
+void
+ForresterKernel::orderFlow(std::size_t f, std::vector<bool>& done,
+        std::vector<std::size_t>& order) const
+{
+    if (done[f]) {
+        return;
+    }
+    done[f] = true;
+
+    std::vector<bool> deps(mFlows.size(), false);
+    std::vector<bool> params(mParams.size(), false);
+    bool usesTime = false;
+    bool usesState = false;
+    collect(mFlows[f].tree, deps, params, usesTime, usesState);
+    for (std::size_t g = 0; g < deps.size(); g++) {
+        if (deps[g]) {
+            orderFlow(g, done, order);
+        }
+    }
+    order.push_back(f);
+}
+
+std::string
+ForresterKernel::printLocals(const std::vector<bool>& flows,
+        const std::vector<bool>& params) const
+{
+    std::string locals;
+    for (std::size_t p = 0; p < mParams.size(); p++) {
+        if (params[p]) {
+            locals += "    const double p_" + mParams[p] + " = "
+                + mParams[p] + "();\n";
+        }
+    }
+
+    std::vector<bool> done(mFlows.size(), false);
+    std::vector<std::size_t> order;
+    for (std::size_t f = 0; f < mFlows.size(); f++) {
+        if (flows[f]) {
+            orderFlow(f, done, order);
+        }
+    }
+    for (std::size_t f : order) {
+        locals += "    const double f_" + mFlows[f].name + " = "
+            + print(mFlows[f].tree) + ";\n";
+    }
+    return locals;
+}
+
+std::string
+ForresterKernel::print(const NodePtr& node) const
+{
+    std::string out;
+    printNode(node, out);
+    return out;
+}
+
+void
+ForresterKernel::printNode(const NodePtr& node, std::string& out) const
+{
+    switch (node->kind) {
+    case Node::NUMBER:
+    case Node::SYMBOL:
+        out += node->text;
+        break;
+    case Node::STATE: {
+        std::ostringstream s;
+        s << "x[" << node->index << "]";
+        out += s.str();
+        break;
+    }
+    case Node::PARAM:
+        out += "p_" + mParams[node->index];
+        break;
+    case Node::FLOW:
+        out += "f_" + mFlows[node->index].name;
+        break;
+    case Node::ADD:
+    case Node::SUB:
+        printChild(node->a, 1, out);
+        out += node->kind == Node::ADD ? " + " : " - ";
+        printChild(node->b, 2, out);
+        break;
+    case Node::MUL:
+    case Node::DIV:
+        printChild(node->a, 2, out);
+        out += node->kind == Node::MUL ? " * " : " / ";
+        printChild(node->b, 4, out);
+        break;
+    case Node::NEG:
+        out += "-";
+        printChild(node->a, 4, out);
+        break;
+    case Node::CALL:
+        out += "std::" + node->text + "(";
+        printNode(node->a, out);
+        if (node->b) {
+            out += ", ";
+            printNode(node->b, out);
+        }
+        out += ")";
+        break;
+    }
+}
+
+void
+ForresterKernel::printChild(const NodePtr& child, int minPrecedence,
+        std::string& out) const
+{
+    bool paren = precedence(child) < minPrecedence;
+    if (paren) {
+        out += "(";
+    }
+    printNode(child, out);
+    if (paren) {
+        out += ")";
+    }
+}
+
+int
+ForresterKernel::precedence(const NodePtr& node)
+{
+    switch (node->kind) {
+    case Node::ADD:
+    case Node::SUB:
+        return 1;
+    case Node::MUL:
+    case Node::DIV:
+        return 2;
+    case Node::NEG:
+        return 3;
+    case Node::NUMBER:
+        return node->value < 0 ? 3 : 4;
+    default:
+        return 4;
+    }
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::number(double value, bool integral)
+{
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::NUMBER);
+    node->value = value;
+
+    //keep the type of the literals: 1/2 is an integer division
+    std::ostringstream s;
+    if (integral) {
+        s << static_cast<long long>(value);
+    } else {
+        s.precision(17);
+        s << value;
+        if (s.str().find_first_of(".e") == std::string::npos) {
+            s << ".0";
+        }
+    }
+    node->text = s.str();
+    return node;
+}
+
+bool
+ForresterKernel::isIntegral(const NodePtr& node)
+{
+    return node->kind == Node::NUMBER and
+        node->text.find_first_of(".eE") == std::string::npos;
+}
+
+bool
+ForresterKernel::isNumber(const NodePtr& node, double value)
+{
+    return node->kind == Node::NUMBER and node->value == value;
+}
+
+bool
+ForresterKernel::dependsOnState(const NodePtr& node)
+{
+    switch (node->kind) {
+    case Node::STATE:
+    case Node::FLOW:
+        return true;
+    case Node::NUMBER:
+    case Node::PARAM:
+    case Node::SYMBOL:
+        return false;
+    default:
+        return dependsOnState(node->a) or (node->b and dependsOnState(node->b));
+    }
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::add(const NodePtr& a, const NodePtr& b)
+{
+    if (a->kind == Node::NUMBER and b->kind == Node::NUMBER) {
+        return number(a->value + b->value, isIntegral(a) and isIntegral(b));
+    }
+    if (isNumber(a, 0)) {
+        return b;
+    }
+    if (isNumber(b, 0)) {
+        return a;
+    }
+    if (b->kind == Node::NEG) {
+        return sub(a, b->a);
+    }
+    if (b->kind == Node::NUMBER and b->value < 0) {
+        return sub(a, number(-b->value, isIntegral(b)));
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::ADD);
+    node->a = a;
+    node->b = b;
+    return node;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::sub(const NodePtr& a, const NodePtr& b)
+{
+    if (a->kind == Node::NUMBER and b->kind == Node::NUMBER) {
+        return number(a->value - b->value, isIntegral(a) and isIntegral(b));
+    }
+    if (isNumber(b, 0)) {
+        return a;
+    }
+    if (isNumber(a, 0)) {
+        return neg(b);
+    }
+    if (b->kind == Node::NEG) {
+        return add(a, b->a);
+    }
+    if (b->kind == Node::NUMBER and b->value < 0) {
+        return add(a, number(-b->value, isIntegral(b)));
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::SUB);
+    node->a = a;
+    node->b = b;
+    return node;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::mul(const NodePtr& a, const NodePtr& b)
+{
+    if (a->kind == Node::NUMBER and b->kind == Node::NUMBER) {
+        return number(a->value * b->value, isIntegral(a) and isIntegral(b));
+    }
+    if (isNumber(a, 0) or isNumber(b, 0)) {
+        return number(0);
+    }
+    if (isNumber(a, 1)) {
+        return b;
+    }
+    if (isNumber(b, 1)) {
+        return a;
+    }
+    if (isNumber(a, -1)) {
+        return neg(b);
+    }
+    if (isNumber(b, -1)) {
+        return neg(a);
+    }
+    if (a->kind == Node::NEG) {
+        return neg(mul(a->a, b));
+    }
+    if (b->kind == Node::NEG) {
+        return neg(mul(a, b->a));
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::MUL);
+    node->a = a;
+    node->b = b;
+    return node;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::div(const NodePtr& a, const NodePtr& b)
+{
+    //numbers are not folded, as in the compute of the Vars
+    if (isNumber(a, 0)) {
+        return number(0);
+    }
+    if (isNumber(b, 1)) {
+        return a;
+    }
+    if (a->kind == Node::NEG) {
+        return neg(div(a->a, b));
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::DIV);
+    node->a = a;
+    node->b = b;
+    return node;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::neg(const NodePtr& a)
+{
+    if (a->kind == Node::NUMBER) {
+        return number(-a->value, isIntegral(a));
+    }
+    if (a->kind == Node::NEG) {
+        return a->a;
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::NEG);
+    node->a = a;
+    return node;
+}
+
+ForresterKernel::NodePtr
+ForresterKernel::call(const std::string& fn, const NodePtr& a,
+        const NodePtr& b)
+{
+    if (fn == "pow" and isNumber(b, 1)) {
+        return a;
+    }
+    std::shared_ptr<Node> node = std::make_shared<Node>(Node::CALL);
+    node->text = fn;
+    node->a = a;
+    node->b = b;
+    return node;
+}
+
+}}//namespaces
@@ -0,0 +1,150 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GVLE_FORRESTER_KERNEL_H
+#define GVLE_FORRESTER_KERNEL_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gvle {
+namespace forrester {
+
+/**
+ * @brief Translates the material flows of a Forrester diagram into the
+ * bodies of two functions of the generated dynamics:
+ * - computeArray(t, x, dx): the gradients of the compartments computed
+ *   from a contiguous state vector x, one entry per compartment,
+ * - jacobian(t, x, jac): the derivatives of these gradients by the
+ *   compartments, obtained by symbolic differentiation of the flows.
+ *
+ * A flow is translated if its compute is an assisted expression made of
+ * numbers, compartments, parameters and flows read with name(), bare
+ * identifiers (the time t or constants of the user section), the
+ * operators + - * / and the functions exp, log, sqrt, pow, sin, cos and
+ * tan. Otherwise (advanced edition, other calls or operators) both
+ * functions are generated but return false.
+ *
+ * The vle.ode integrators do not call these functions: they are only
+ * generated when the array kernel is enabled, see
+ * vleSmForrester::setArrayKernel().
+ */
+class ForresterKernel
+{
+public:
+    ForresterKernel(const std::vector<std::string>& compartments,
+            const std::vector<std::string>& parameters);
+    ~ForresterKernel();
+
+    /**
+     * @brief declare a material flow
+     * @param name, the material flow name
+     * @param expression, the assisted compute or an empty string for
+     * an advanced edition
+     */
+    void addFlow(const std::string& name, const std::string& expression);
+    /**
+     * @brief declare a hard link from a material flow to a compartment
+     * (flow added to the gradient) or from a compartment to a material
+     * flow (flow removed from the gradient)
+     */
+    void addLinkTo(const std::string& flow, const std::string& compName);
+    void addLinkFrom(const std::string& flow, const std::string& compName);
+
+    /**
+     * @brief parse the flows and differentiate them
+     * @return true if computeArray() and jacobian() are available
+     */
+    bool translate();
+    const std::string& error() const
+    { return mError; }
+
+    std::string computeArrayBody() const;
+    std::string jacobianBody() const;
+
+private:
+    struct Node;
+    typedef std::shared_ptr<const Node> NodePtr;
+    class Parser;
+
+    struct Flow
+    {
+        std::string name;
+        std::string expression;
+        NodePtr     tree;
+        bool        parsing;
+        std::vector<NodePtr> derivatives; //by compartment
+    };
+
+    void resolveLinks(
+            std::vector<std::pair<std::string, std::string>>& pending,
+            std::vector<std::vector<std::size_t>>& links);
+    NodePtr parseFlow(std::size_t flow);
+    NodePtr derivative(const NodePtr& node, std::size_t comp);
+    NodePtr flowDerivative(std::size_t flow, std::size_t comp);
+
+    std::string print(const NodePtr& node) const;
+    void printNode(const NodePtr& node, std::string& out) const;
+    void printChild(const NodePtr& child, int minPrecedence,
+            std::string& out) const;
+    static int precedence(const NodePtr& node);
+    void collect(const NodePtr& node, std::vector<bool>& flows,
+            std::vector<bool>& params, bool& usesTime, bool& usesState) const;
+    std::string printLocals(const std::vector<bool>& flows,
+            const std::vector<bool>& params) const;
+    void orderFlow(std::size_t flow, std::vector<bool>& done,
+            std::vector<std::size_t>& order) const;
+    void collectFlow(std::size_t flow, std::vector<bool>& flows,
+            std::vector<bool>& params, bool& usesTime, bool& usesState) const;
+
+    static NodePtr number(double value, bool integral = false);
+    static bool isIntegral(const NodePtr& node);
+    static NodePtr add(const NodePtr& a, const NodePtr& b);
+    static NodePtr sub(const NodePtr& a, const NodePtr& b);
+    static NodePtr mul(const NodePtr& a, const NodePtr& b);
+    static NodePtr div(const NodePtr& a, const NodePtr& b);
+    static NodePtr neg(const NodePtr& a);
+    static NodePtr call(const std::string& fn, const NodePtr& a,
+            const NodePtr& b = NodePtr());
+    static bool isNumber(const NodePtr& node, double value);
+    static bool dependsOnState(const NodePtr& node);
+
+    std::vector<std::string>                    mComps;
+    std::vector<std::string>                    mParams;
+    std::vector<Flow>                           mFlows;
+    std::map<std::string, std::size_t>          mCompIndex;
+    std::map<std::string, std::size_t>          mParamIndex;
+    std::map<std::string, std::size_t>          mFlowIndex;
+    std::vector<std::vector<std::size_t>>       mLinksTo;   //by compartment
+    std::vector<std::vector<std::size_t>>       mLinksFrom; //by compartment
+    std::vector<std::pair<std::string, std::string>> mPendingTo;
+    std::vector<std::pair<std::string, std::string>> mPendingFrom;
+    bool                                        mTranslated;
+    std::string                                 mError;
+};
+
+}}//namespaces
+
+#endif
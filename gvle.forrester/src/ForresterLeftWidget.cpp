@@ -1516,6 +1516,8 @@ ForresterLeftWidget::ForresterLeftWidget(ForresterPanel*  f):
             this, SLOT(onCompUpdate(const QString&)));
     QObject::connect(ui->quantum, SIGNAL(valueChanged(double)),
             this, SLOT(qtChanged(double)));
+    QObject::connect(ui->arrayKernel, SIGNAL(toggled(bool)),
+            this, SLOT(onArrayKernelUpdate(bool)));
 
 }
 ForresterLeftWidget::~ForresterLeftWidget()
@@ -1539,6 +1541,9 @@ ForresterLeftWidget::reloadGeneral()
     bool oldBlock2 = ui->timeStep->blockSignals(true);
     bool oldBlock3 = ui->comboCompartment->blockSignals(true);
     bool oldBlock4 = ui->quantum->blockSignals(true);
+    bool oldBlock5 = ui->arrayKernel->blockSignals(true);
+
+    ui->arrayKernel->setChecked(forrester->cppMetadata->arrayKernel());
 
     if (meth == "euler") {
         ui->comboMethod->setCurrentIndex(0);
@@ -1583,6 +1588,7 @@ ForresterLeftWidget::reloadGeneral()
     ui->timeStep->blockSignals(oldBlock2);
     ui->comboCompartment->blockSignals(oldBlock3);
     ui->quantum->blockSignals(oldBlock4);
+    ui->arrayKernel->blockSignals(oldBlock5);
 }
 
 void
@@ -1646,4 +1652,10 @@ ForresterLeftWidget::qtChanged(double v)
             ui->comboCompartment->currentText(), v);
 }
 
+void
+ForresterLeftWidget::onArrayKernelUpdate(bool checked)
+{
+    forrester->cppMetadata->setArrayKernel(checked);
+}
+
 }} //namespaces
@@ -269,6 +269,7 @@ public slots:
    void tsChanged(double);
    void onCompUpdate(const QString& comp);
    void qtChanged(double);
+   void onArrayKernelUpdate(bool checked);
 
 
 };
@@ -41,6 +41,7 @@
 #include <vle/gvle/vlevpz.hpp>
 
 #include "vlesmForrester.h"
+#include "ForresterKernel.h"
 
 
 
@@ -685,6 +686,30 @@ vleSmForrester::linksFromComp(QString compName) const
     return links_from_comp;
 }
 
+bool
+vleSmForrester::arrayKernel() const
+{
+    QDomNode defNode = mDocSm->elementsByTagName("definition").item(0);
+    return DomFunctions::attributeValue(defNode, "kernel") == "array";
+}
+
+void
+vleSmForrester::setArrayKernel(bool val, bool snap)
+{
+    QDomNode defNode = mDocSm->elementsByTagName("definition").item(0);
+    if (snap) {
+        undoStackSm->snapshot(defNode);
+    }
+    if (val) {
+        defNode.toElement().setAttribute("kernel", "array");
+    } else {
+        defNode.toElement().removeAttribute("kernel");
+    }
+    if (snap) {
+        emit modified(NUMERICAL_INT);
+    }
+}
+
 /**
  * @brief get the numerical integration method
  */
@@ -1376,6 +1401,7 @@ vleSmForrester::getData()
         " * @@tagdepends: vle.ode @@endtagdepends\n"                    \
         "*/\n\n"                                                        \
         "#include <vle/DifferentialEquation.hpp>\n"                     \
+        "{{kernel_includes}}"                                           \
         "{{includes}}\n"                                                \
         "namespace vd = vle::devs;\n\n"                                 \
         "namespace vv = vle::value;\n\n"                                \
@@ -1406,6 +1432,7 @@ vleSmForrester::getData()
         "{{compute_str}}\n"                                             \
         "}\n"                                                           \
         "\n"                                                            \
+        "{{kernel}}"                                                    \
         "{{for i in obj}}"                                              \
         "    Var {{obj^i}};\n"                                          \
         "{{end for}}"                                                   \
@@ -1429,13 +1456,26 @@ vleSmForrester::getData()
 
     std::string compute_str;
 
+    std::vector<std::string> stateNames;
+    std::vector<std::string> kernelParams;
+    for (int i = 0; i < compsXml.length(); i++) {
+        stateNames.push_back(compsXml.item(i).attributes().namedItem(
+                "name").nodeValue().toStdString());
+    }
+    for (auto param : paramsNames) {
+        kernelParams.push_back(param.toStdString());
+    }
+    ForresterKernel kernel(stateNames, kernelParams);
+
     for (auto mat : matsNames) {
         vleTpl.listSymbol().append("obj", mat.toStdString());
         if (hasAdvancedEdition(mat)) {
             compute_str += "\n"+getCompute(mat).toStdString();
+            kernel.addFlow(mat.toStdString(), "");
         } else {
             compute_str += "\n"+mat.toStdString()+ " = "
                                 +getCompute(mat).toStdString()+";";
+            kernel.addFlow(mat.toStdString(), getCompute(mat).toStdString());
         }
     }
     compute_str += "\n";
@@ -1448,9 +1488,11 @@ vleSmForrester::getData()
         compute_str += "\n grad("+compName.toStdString()+") = 0";
         for (auto flow : linksToComp(compName)) {
             compute_str += "+ "+flow.toStdString()+"()";
+            kernel.addLinkTo(flow.toStdString(), compName.toStdString());
         }
         for (auto flow : linksFromComp(compName)) {
             compute_str += "- "+flow.toStdString()+"()";
+            kernel.addLinkFrom(flow.toStdString(), compName.toStdString());
         }
         compute_str += ";";
     }
@@ -1461,6 +1503,62 @@ vleSmForrester::getData()
     compute_str += "\n";
 
     vleTpl.stringSymbol().append("compute_str", compute_str);
+
+    //computeArray() and jacobian() are only generated on demand since
+    //vle.ode integrators do not call them
+    std::string kernel_str;
+    std::string kernel_includes;
+    if (arrayKernel()) {
+        kernel_includes = "#include <cmath>\n";
+        std::string state_names;
+        std::string get_state;
+        for (std::size_t i = 0; i < stateNames.size(); i++) {
+            state_names += (i == 0 ? "" : ", ") + stateNames[i];
+            get_state += "    x[" + std::to_string(i) + "] = "
+                + stateNames[i] + "();\n";
+        }
+        if (stateNames.empty()) {
+            get_state = "    (void)x;\n";
+        }
+        kernel.translate();
+        kernel_str = "/**\n"
+            " * Size of the state vector of computeArray() and jacobian(),\n"
+            " * one entry per compartment: " + state_names + "\n"
+            " */\n"
+            "static const int stateSize = "
+            + std::to_string(stateNames.size()) + ";\n"
+            "\n"
+            "void getState(double* x) const\n"
+            "{\n"
+            + get_state +
+            "}\n"
+            "\n"
+            "/**\n"
+            " * Gradients of the compartments at the state x, as compute()\n"
+            " * but without reading nor writing the Vars. Returns false if\n"
+            " * a flow can not be translated.\n"
+            " */\n"
+            "bool computeArray(const vle::devs::Time& t, const double* x,\n"
+            "        double* dx) const\n"
+            "{\n"
+            + kernel.computeArrayBody() +
+            "}\n"
+            "\n"
+            "/**\n"
+            " * Analytic Jacobian of computeArray(): jac[i * stateSize + j]\n"
+            " * is the derivative of the gradient of the compartment i by\n"
+            " * the compartment j. Returns false if a flow can not be\n"
+            " * differentiated.\n"
+            " */\n"
+            "bool jacobian(const vle::devs::Time& t, const double* x,\n"
+            "        double* jac) const\n"
+            "{\n"
+            + kernel.jacobianBody() +
+            "}\n"
+            "\n";
+    }
+    vleTpl.stringSymbol().append("kernel", kernel_str);
+    vleTpl.stringSymbol().append("kernel_includes", kernel_includes);
     vleTpl.stringSymbol().append("includes", getIncludesBody().toStdString());
     vleTpl.stringSymbol().append("construct", getConstructorBody().toStdString());
     vleTpl.stringSymbol().append("userSection", getUserSectionBody().toStdString());
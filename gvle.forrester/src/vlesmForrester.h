@@ -192,6 +192,13 @@ public:
     void setNumericalIntegration(QString method, bool snap=true);
     void setNumericalTimeStep(double ts, bool snap=true);
     void setNumericalQuantum(QString compName, double qt, bool snap=true);
+    /**
+     * @brief get, set whether computeArray() and jacobian() are generated
+     * next to compute(). They are not used by the vle.ode integrators,
+     * only by external ones, hence disabled by default.
+     */
+    bool arrayKernel() const;
+    void setArrayKernel(bool val, bool snap=true);
 
     /**
      * @brief Set the type: In, Out or In/0ut
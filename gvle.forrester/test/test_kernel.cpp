@@ -0,0 +1,132 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/unit-test.hpp>
+#include <ForresterKernel.h>
+
+#include <string>
+
+using gvle::forrester::ForresterKernel;
+
+static bool
+contains(const std::string& body, const std::string& line)
+{
+    return body.find(line) != std::string::npos;
+}
+
+/*
+ * Prey' = a Prey - b Prey Predator
+ * Predator' = d Prey Predator - c Predator
+ */
+static void
+lotkaVolterra(ForresterKernel& kernel, const std::string& growth)
+{
+    kernel.addFlow("Birth", "a()*Prey()");
+    kernel.addFlow("Predation", "b()*Prey()*Predator()");
+    kernel.addFlow("Growth", growth);
+    kernel.addFlow("Death", "c()*Predator()");
+    kernel.addLinkTo("Birth", "Prey");
+    kernel.addLinkFrom("Predation", "Prey");
+    kernel.addLinkTo("Growth", "Predator");
+    kernel.addLinkFrom("Death", "Predator");
+}
+
+void
+test_lotka_volterra()
+{
+    ForresterKernel kernel({"Prey", "Predator"}, {"a", "b", "c", "d"});
+    lotkaVolterra(kernel, "d()*Prey()*Predator()");
+
+    Ensures(kernel.translate());
+    EnsuresEqual(kernel.error(), "");
+
+    std::string gradients = kernel.computeArrayBody();
+    Ensures(contains(gradients, "const double p_a = a();\n"));
+    Ensures(contains(gradients,
+                     "const double f_Predation = p_b * x[0] * x[1];\n"));
+    Ensures(contains(gradients, "dx[0] = f_Birth - f_Predation; // Prey\n"));
+    Ensures(contains(gradients, "dx[1] = f_Growth - f_Death; // Predator\n"));
+    Ensures(contains(gradients, "return true;"));
+
+    std::string jacobian = kernel.jacobianBody();
+    Ensures(contains(jacobian,
+                     "jac[0] = p_a - p_b * x[1]; // d(Prey)/dPrey\n"));
+    Ensures(contains(jacobian,
+                     "jac[1] = -(p_b * x[0]); // d(Prey)/dPredator\n"));
+    Ensures(contains(jacobian,
+                     "jac[2] = p_d * x[1]; // d(Predator)/dPrey\n"));
+    Ensures(contains(jacobian,
+                     "jac[3] = p_d * x[0] - p_c; // d(Predator)/dPredator\n"));
+    Ensures(contains(jacobian, "return true;"));
+}
+
+void
+test_unsupported_operator()
+{
+    ForresterKernel kernel({"Prey", "Predator"}, {"a", "b", "c", "d"});
+    lotkaVolterra(kernel, "d()*Prey()^2");
+
+    Ensures(not kernel.translate());
+    EnsuresEqual(kernel.error(), "flow Growth: unexpected '^'");
+    Ensures(contains(kernel.computeArrayBody(),
+                     "return false; // flow Growth: unexpected '^'"));
+    Ensures(contains(kernel.jacobianBody(),
+                     "return false; // flow Growth: unexpected '^'"));
+    Ensures(not contains(kernel.jacobianBody(), "jac[0] ="));
+}
+
+void
+test_cyclic_flows()
+{
+    ForresterKernel kernel({"Stock"}, {"r"});
+    kernel.addFlow("In", "r()*Out() + Stock()");
+    kernel.addFlow("Out", "r()*In()");
+    kernel.addLinkTo("In", "Stock");
+    kernel.addLinkFrom("Out", "Stock");
+
+    Ensures(not kernel.translate());
+    Ensures(contains(kernel.error(), "cyclic dependency"));
+    Ensures(contains(kernel.computeArrayBody(), "return false;"));
+    Ensures(contains(kernel.jacobianBody(), "return false;"));
+}
+
+void
+test_advanced_edition()
+{
+    ForresterKernel kernel({"Prey", "Predator"}, {"a", "b", "c", "d"});
+    lotkaVolterra(kernel, "");
+
+    Ensures(not kernel.translate());
+    EnsuresEqual(kernel.error(), "flow Growth: advanced edition");
+}
+
+int main()
+{
+    test_lotka_volterra();
+    test_unsupported_operator();
+    test_cyclic_flows();
+    test_advanced_edition();
+
+    return unit_test::report_errors();
+}
@@ -43,6 +43,11 @@
 namespace vle {
 namespace gvle {
 
+// refresh period of the logs and of the streamed plans
+static const int refreshPeriod = 250;
+// number of slots of the stream between the simulation and the panel
+static const std::size_t streamCapacity = 16384;
+
 struct sim_log : utils::Context::LogFunctor
 {
     std::vector<std::string>& log_messages;
@@ -82,6 +87,7 @@ PlanSimSubpanelThread::PlanSimSubpanelThread(
   : output_map(nullptr)
   , mvpz(0)
   , mpkg(0)
+  , mstream(nullptr)
   , error_simu("")
   , log_messages(logMessages)
   , mdebug(debug)
@@ -92,10 +98,13 @@ PlanSimSubpanelThread::PlanSimSubpanelThread(
 PlanSimSubpanelThread::~PlanSimSubpanelThread()
 {}
 void
-PlanSimSubpanelThread::init(vleVpz* vpz, vle::utils::Package* pkg)
+PlanSimSubpanelThread::init(vleVpz* vpz,
+                            vle::utils::Package* pkg,
+                            PlanStreamBuffer* stream)
 {
     mvpz = vpz;
     mpkg = pkg;
+    mstream = stream;
 }
 
 void
@@ -117,7 +126,7 @@ PlanSimSubpanelThread::onStarted()
     }
 
     vle::manager::SimulationOptions doSpawn;
-    if (mdebug) {
+    if (mdebug or mstream) {
         doSpawn = vle::manager::SIMULATION_NONE;
     } else {
         doSpawn = vle::manager::SIMULATION_SPAWN_PROCESS;
@@ -146,7 +155,11 @@ PlanSimSubpanelThread::onStarted()
           vpz->project().experiment().views().outputs().end();
         for (; itb != ite; itb++) {
             vle::vpz::Output& output = itb->second;
-            if (output.location().empty()) {
+            if (mstream) {
+                // observations are sent to the panel, no matrix is kept
+                output.setStream(
+                  mstream->location(), "plan-stream", "gvle.simulating.plan");
+            } else if (output.location().empty()) {
                 mpkg->addDirectory("", "output", vle::utils::PKG_SOURCE);
                 output.setStreamLocation(
                   mpkg->getOutputDir(vle::utils::PKG_SOURCE));
@@ -158,7 +171,9 @@ PlanSimSubpanelThread::onStarted()
     if (vpz) {
         output_map = sim.run(std::move(vpz), &manerror);
     }
-    if (manerror.code != 0) {
+    if (manerror.code != 0 and mstream and mstream->aborted()) {
+        output_map.reset();
+    } else if (manerror.code != 0) {
         error_simu = QString("Error during simulation '%1'")
                        .arg(manerror.message.c_str());
         output_map.reset();
@@ -217,6 +232,8 @@ PlanSimSubpanel::PlanSimSubpanel()
 {
     QObject::connect(
       left->ui->runButton, SIGNAL(pressed()), this, SLOT(onRunPressed()));
+    QObject::connect(
+      left->ui->stopButton, SIGNAL(pressed()), this, SLOT(onStopPressed()));
     QObject::connect(left->ui->debugCombo,
                      SIGNAL(currentTextChanged(QString)),
                      this,
@@ -244,14 +261,19 @@ PlanSimSubpanel::PlanSimSubpanel()
 
 PlanSimSubpanel::~PlanSimSubpanel()
 {
-    delete left;
-    delete right;
-    delete sim_process;
+    // the simulation may be pushing into the stream: unblock it and wait
+    // for the thread before the stream and sim_process are released
+    if (stream) {
+        stream->abort();
+    }
     if (thread) {
         thread->quit();
         thread->wait();
         delete thread;
     }
+    delete left;
+    delete right;
+    delete sim_process;
 }
 void
 PlanSimSubpanel::init(vleVpz* vpz, vle::utils::Package* pkg, Logger* log)
@@ -365,6 +387,21 @@ PlanSimSubpanel::updateCustomPlot()
 {
     // get results
     //left->customPlot->clearGraphs();
+    if (stream) {
+        unsigned int nbPlans = 0;
+        for (const auto& p : portsToPlot) {
+            auto it = streamPlans.find(std::make_pair(p.view, p.port));
+            if (it != streamPlans.end()) {
+                mPlan.loadString(it->second);
+                if (mPlan.isValid()) {
+                    left->planView->loadPlan(&mPlan);
+                    nbPlans++;
+                }
+            }
+        }
+        showCustomPlot((nbPlans > 0));
+        return;
+    }
     if (not sim_process or not sim_process->output_map) {
         return;
     }
@@ -461,12 +498,16 @@ void
 PlanSimSubpanel::onSimulationFinished()
 {
     bool oldBlockTree = right->ui->treeSimViews->blockSignals(true);
-    right->ui->treeSimViews->clear();
+    if (not stream) {
+        right->ui->treeSimViews->clear();
+    }
     onTimeout();
     timer.stop();
     if (sim_process and not sim_process->error_simu.isEmpty()) {
         mLog->logExt(sim_process->error_simu, true);
-    } else if (sim_process and sim_process->output_map) {
+    } else if (stream and stream->aborted()) {
+        mLog->logExt("Simulation aborted", false);
+    } else if (not stream and sim_process and sim_process->output_map) {
         const vle::value::Map& simu = *sim_process->output_map;
         QList<QTreeWidgetItem*> views_items;
         vle::value::Map::const_iterator itb = simu.begin();
@@ -487,15 +528,7 @@ PlanSimSubpanel::onSimulationFinished()
                     if (res.get(i, 0) and res.get(i, 0)->isString()) {
                         QString portName = res.getString(i, 0).c_str();
                         if (portName.contains("AchievedPlan")) {
-                            QTreeWidgetItem* pItem = new QTreeWidgetItem();
-                            pItem->setText(0, portName);
-                            pItem->setFlags(vItem->flags() |
-                                            Qt::ItemIsUserCheckable);
-                            pItem->setCheckState(0, Qt::Unchecked);
-                            pItem->setData(0, Qt::UserRole + 0, "port");
-                            pItem->setData(0, Qt::UserRole + 1, viewName);
-                            pItem->setData(0, Qt::UserRole + 2, portName);
-                            vItem->addChild(pItem);
+                            addPortItem(vItem, viewName, portName);
                         }
                     }
                 }
@@ -514,8 +547,7 @@ PlanSimSubpanel::onSimulationFinished()
     thread = 0;
 
     left->ui->runButton->setEnabled(true);
-
-
+    left->ui->stopButton->setEnabled(false);
 }
 
 void
@@ -534,20 +566,32 @@ PlanSimSubpanel::onRunPressed()
     showCustomPlot(false);
     portsToPlot.erase(portsToPlot.begin(), portsToPlot.end());
 
+    // prepare the stream, the tree is then filled during the simulation
+    streamPlans.clear();
+    if (left->ui->streamCheck->isChecked()) {
+        stream.reset(new PlanStreamBuffer(streamCapacity));
+        bool oldBlockTree = right->ui->treeSimViews->blockSignals(true);
+        right->ui->treeSimViews->clear();
+        right->ui->treeSimViews->blockSignals(oldBlockTree);
+        left->ui->stopButton->setEnabled(true);
+    } else {
+        stream.reset();
+    }
+
     // prepare new thread for simulation
     log_messages.clear();
     index_message = 0;
     delete sim_process;
     sim_process =
       new PlanSimSubpanelThread(log_messages, debug, nbthreads, blockSize);
-    sim_process->init(mvpz, mpkg);
+    sim_process->init(mvpz, mpkg, stream.get());
 
     // delete set
     delete thread;
     thread = new QThread();
 
     // move to thread
-    timer.start(1000);
+    timer.start(refreshPeriod);
     sim_process->moveToThread(thread);
     connect(thread, SIGNAL(started()), sim_process, SLOT(onStarted()));
     connect(sim_process,
@@ -557,6 +601,15 @@ PlanSimSubpanel::onRunPressed()
     thread->start();
 }
 
+void
+PlanSimSubpanel::onStopPressed()
+{
+    if (stream) {
+        stream->abort();
+    }
+    left->ui->stopButton->setEnabled(false);
+}
+
 void
 PlanSimSubpanel::onDebugChanged(QString val)
 {
@@ -648,6 +701,86 @@ PlanSimSubpanel::onTimeout()
         mLog->logExt(QString(log_messages[i].c_str()), false);
     }
     index_message = log_messages.size();
+
+    if (stream) {
+        drainStream();
+    }
+}
+
+QTreeWidgetItem*
+PlanSimSubpanel::addViewItem(QString viewName)
+{
+    QTreeWidget* tree = right->ui->treeSimViews;
+    for (int i = 0; i < tree->topLevelItemCount(); i++) {
+        QTreeWidgetItem* vItem = tree->topLevelItem(i);
+        if (vItem->data(0, Qt::UserRole + 1).toString() == viewName) {
+            return vItem;
+        }
+    }
+    QTreeWidgetItem* vItem = new QTreeWidgetItem();
+    vItem->setText(0, viewName);
+    vItem->setData(0, Qt::UserRole + 0, "view");
+    vItem->setData(0, Qt::UserRole + 1, viewName);
+    tree->addTopLevelItem(vItem);
+    return vItem;
+}
+
+void
+PlanSimSubpanel::addPortItem(QTreeWidgetItem* vItem,
+                             QString viewName,
+                             QString portName)
+{
+    QTreeWidgetItem* pItem = new QTreeWidgetItem();
+    pItem->setText(0, portName);
+    pItem->setFlags(vItem->flags() | Qt::ItemIsUserCheckable);
+    pItem->setCheckState(0, Qt::Unchecked);
+    pItem->setData(0, Qt::UserRole + 0, "port");
+    pItem->setData(0, Qt::UserRole + 1, viewName);
+    pItem->setData(0, Qt::UserRole + 2, portName);
+    vItem->addChild(pItem);
+}
+
+void
+PlanSimSubpanel::drainStream()
+{
+    // Only the last plan of each port is kept: the rows are dropped as
+    // soon as they are read and the view is repainted once per refresh.
+    bool plotted = false;
+    bool oldBlockTree = right->ui->treeSimViews->blockSignals(true);
+
+    for (int round = 0; round < 16; round++) {
+        streamRows.clear();
+        if (stream->pop(streamRows, streamCapacity) == 0) {
+            break;
+        }
+        for (const auto& row : streamRows) {
+            if (row.type != PlanStreamRow::TEXT) {
+                continue;
+            }
+            QString viewName = QString::fromStdString(row.view);
+            QString portName = QString::fromStdString(row.port);
+            if (not portName.contains("AchievedPlan")) {
+                continue;
+            }
+            auto key = std::make_pair(viewName, portName);
+            auto it = streamPlans.find(key);
+            if (it == streamPlans.end()) {
+                streamPlans.emplace(key, QString::fromStdString(row.text));
+                addPortItem(addViewItem(viewName), viewName, portName);
+            } else {
+                it->second = QString::fromStdString(row.text);
+            }
+            if (getPortToPlot(viewName, portName)) {
+                plotted = true;
+            }
+        }
+    }
+    streamRows.clear();
+    right->ui->treeSimViews->blockSignals(oldBlockTree);
+
+    if (plotted) {
+        updateCustomPlot();
+    }
 }
 
 void
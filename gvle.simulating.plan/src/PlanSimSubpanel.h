@@ -29,8 +29,12 @@
 #include <QDebug>
 #include <QTreeWidgetItem>
 
+#include "PlanStream.h"
 #include "svgview.h"
 
+#include <map>
+#include <memory>
+
 #include <vle/gvle/plugin_simpanel.h>
 #include <vle/gvle/vlevpz.hpp>
 
@@ -50,6 +54,7 @@ public:
     std::unique_ptr<vle::value::Map>     output_map;
     vleVpz*                   mvpz;
     vle::utils::Package*      mpkg;
+    PlanStreamBuffer*         mstream;
     QString                   error_simu;
     std::vector<std::string>& log_messages;
     //parameters
@@ -60,7 +65,8 @@ public:
     PlanSimSubpanelThread(std::vector<std::string>& logMessages,
             bool debug, int nbthreads, int blockSize);
     ~PlanSimSubpanelThread();
-    void init(vleVpz* vpz, vle::utils::Package* pkg);
+    void init(vleVpz* vpz, vle::utils::Package* pkg,
+              PlanStreamBuffer* stream = nullptr);
 public slots:
    void onStarted();
 signals:
@@ -147,6 +153,10 @@ public:
             unsigned int row, bool error_message);
     QString getString(const vle::value::Matrix& view, unsigned int col,
 		     unsigned int row, bool error_message);
+    QTreeWidgetItem* addViewItem(QString viewName);
+    void addPortItem(QTreeWidgetItem* vItem, QString viewName,
+                     QString portName);
+    void drainStream();
 
     //parameters
     bool debug;
@@ -169,10 +179,16 @@ public:
 
     vlePlan mPlan;
 
+    //streaming of the observations during the simulation
+    std::unique_ptr<PlanStreamBuffer> stream;
+    std::vector<PlanStreamRow> streamRows;
+    std::map<std::pair<QString, QString>, QString> streamPlans;
+
 
 public slots:
     void onSimulationFinished();
     void onRunPressed();
+    void onStopPressed();
     void onDebugChanged(QString);
     void onThreadsChanged(int);
     void onBlockSizeChanged(int);
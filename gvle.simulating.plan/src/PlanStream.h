@@ -0,0 +1,166 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2017-2017 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GVLE_SIMULATING_PLAN_STREAM_H
+#define GVLE_SIMULATING_PLAN_STREAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace gvle {
+
+/**
+ * @brief One observation sent by the simulation to the panel.
+ */
+struct PlanStreamRow
+{
+    enum Type
+    {
+        NUMBER, // double, integer or boolean, stored in number
+        TEXT    // string or any other value, stored in text
+    };
+
+    Type type = NUMBER;
+    double time = 0.0;
+    std::string view;
+    std::string port; // "model:port" as in the storage output
+    double number = 0.0;
+    std::string text;
+};
+
+/**
+ * @brief Lock-free single producer, single consumer ring buffer between
+ * the "plan-stream" output plugin (producer, the simulation thread) and
+ * the PlanSimSubpanel (consumer, the GUI thread).
+ *
+ * The producer never allocates a slot: when the ring is full push()
+ * returns false and the plugin waits, which bounds the memory used by a
+ * run whatever the number of observations.
+ */
+class PlanStreamBuffer
+{
+public:
+    explicit PlanStreamBuffer(std::size_t capacity = 4096)
+      : mSlots(roundCapacity(capacity))
+      , mMask(mSlots.size() - 1)
+      , mHead(0)
+      , mTail(0)
+      , mAborted(false)
+    {}
+
+    PlanStreamBuffer(const PlanStreamBuffer&) = delete;
+    PlanStreamBuffer& operator=(const PlanStreamBuffer&) = delete;
+
+    /** Producer side. @return false if the ring is full. */
+    bool push(PlanStreamRow& row)
+    {
+        const std::size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == mSlots.size())
+            return false;
+
+        mSlots[tail & mMask] = std::move(row);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side: move at most @e max rows at the end of @e out.
+     * @return the number of rows moved.
+     */
+    std::size_t pop(std::vector<PlanStreamRow>& out, std::size_t max)
+    {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+        const std::size_t tail = mTail.load(std::memory_order_acquire);
+        std::size_t nb = tail - head;
+        if (nb > max)
+            nb = max;
+
+        for (std::size_t i = 0; i != nb; ++i)
+            out.emplace_back(std::move(mSlots[(head + i) & mMask]));
+
+        mHead.store(head + nb, std::memory_order_release);
+        return nb;
+    }
+
+    /** Ask the producer to stop the simulation at the next observation. */
+    void abort() { mAborted.store(true, std::memory_order_release); }
+    bool aborted() const { return mAborted.load(std::memory_order_acquire); }
+
+    /**
+     * The buffer is given to the plugin through the location of the
+     * output: both live in the gvle process since streaming runs the
+     * simulation without spawning.
+     */
+    std::string location()
+    {
+        char buffer[64];
+        std::snprintf(buffer,
+                      sizeof(buffer),
+                      "%s%jx",
+                      prefix(),
+                      static_cast<std::uintmax_t>(
+                        reinterpret_cast<std::uintptr_t>(this)));
+        return buffer;
+    }
+
+    /** @return the buffer encoded by location() or nullptr. */
+    static PlanStreamBuffer* fromLocation(const std::string& location)
+    {
+        const std::string pre(prefix());
+        if (location.compare(0, pre.size(), pre) != 0)
+            return nullptr;
+
+        std::uintmax_t address = 0;
+        if (std::sscanf(location.c_str() + pre.size(), "%jx", &address) != 1)
+            return nullptr;
+
+        return reinterpret_cast<PlanStreamBuffer*>(
+          static_cast<std::uintptr_t>(address));
+    }
+
+private:
+    static const char* prefix() { return "gvle-plan-stream:"; }
+
+    static std::size_t roundCapacity(std::size_t capacity)
+    {
+        std::size_t result = 1;
+        while (result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    std::vector<PlanStreamRow> mSlots;
+    const std::size_t mMask;
+    alignas(64) std::atomic<std::size_t> mHead;
+    alignas(64) std::atomic<std::size_t> mTail;
+    std::atomic<bool> mAborted;
+};
+
+}
+} // namespaces
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2017-2017 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PlanStream.h"
+
+#include <vle/oov/Plugin.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/String.hpp>
+
+#include <chrono>
+#include <thread>
+
+namespace vle {
+namespace gvle {
+
+/**
+ * @brief Output plugin forwarding every observation to the
+ * PlanSimSubpanel through a PlanStreamBuffer instead of storing a
+ * matrix. It is installed by the panel on the outputs of the vpz when
+ * streaming is enabled and cannot be used from the command line.
+ */
+class PlanStreamPlugin : public vle::oov::Plugin
+{
+    PlanStreamBuffer* mBuffer;
+
+    void push(PlanStreamRow& row)
+    {
+        while (not mBuffer->push(row)) {
+            if (mBuffer->aborted())
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if (mBuffer->aborted())
+            throw vle::utils::InternalError("simulation aborted by user");
+    }
+
+public:
+    PlanStreamPlugin(const std::string& location)
+      : vle::oov::Plugin(location)
+      , mBuffer(nullptr)
+    {}
+
+    virtual ~PlanStreamPlugin() {}
+
+    virtual std::unique_ptr<vle::value::Matrix> matrix() const override
+    {
+        return {};
+    }
+
+    virtual std::string name() const override
+    {
+        return std::string("plan-stream");
+    }
+
+    virtual void onParameter(const std::string& /*plugin*/,
+                             const std::string& location,
+                             const std::string& /*file*/,
+                             std::unique_ptr<vle::value::Value> /*params*/,
+                             const double& /*time*/) override
+    {
+        mBuffer = PlanStreamBuffer::fromLocation(location);
+        if (not mBuffer)
+            throw vle::utils::ArgError(
+              "plan-stream: output only available from the gvle plan panel");
+    }
+
+    virtual void onNewObservable(const std::string& /*simulator*/,
+                                 const std::string& /*parent*/,
+                                 const std::string& /*port*/,
+                                 const std::string& /*view*/,
+                                 const double& /*time*/) override
+    {}
+
+    virtual void onDelObservable(const std::string& /*simulator*/,
+                                 const std::string& /*parent*/,
+                                 const std::string& /*port*/,
+                                 const std::string& /*view*/,
+                                 const double& /*time*/) override
+    {}
+
+    virtual void onValue(const std::string& simulator,
+                         const std::string& parent,
+                         const std::string& port,
+                         const std::string& view,
+                         const double& time,
+                         std::unique_ptr<vle::value::Value> value) override
+    {
+        if (not value)
+            return;
+
+        PlanStreamRow row;
+        row.time = time;
+        row.view = view;
+        row.port = parent + ":" + simulator + "." + port;
+
+        if (value->isDouble()) {
+            row.number = value->toDouble().value();
+        } else if (value->isInteger()) {
+            row.number = static_cast<double>(value->toInteger().value());
+        } else if (value->isBoolean()) {
+            row.number = value->toBoolean().value() ? 1.0 : 0.0;
+        } else if (value->isString()) {
+            row.type = PlanStreamRow::TEXT;
+            row.text = value->toString().value();
+        } else {
+            row.type = PlanStreamRow::TEXT;
+            row.text = value->writeToString();
+        }
+
+        push(row);
+    }
+
+    virtual std::unique_ptr<vle::value::Matrix> finish(
+      const double& /*time*/) override
+    {
+        return {};
+    }
+};
+
+}
+} // namespaces
+
+DECLARE_OOV_PLUGIN(vle::gvle::PlanStreamPlugin)
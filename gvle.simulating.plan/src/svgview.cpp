@@ -22,6 +22,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <QFile>
+#include <QFontMetricsF>
+#include <QGraphicsRectItem>
+#include <QGraphicsSimpleTextItem>
 #include <QGraphicsSvgItem>
 #include <QScrollBar>
 #include <QToolTip>
@@ -32,14 +35,42 @@
 #include "svgview.h"
 #include <iostream>
 
+/**
+ * @brief Retained graphics item of one activity of the plan, updated only
+ * when its position, size or color change between two steps.
+ */
+class SvgViewActivity : public QGraphicsRectItem
+{
+public:
+    SvgViewActivity(const QString &name, const QFont &font)
+        : QGraphicsRectItem(),
+          label(new QGraphicsSimpleTextItem(name, this)),
+          drawnX(-1), drawnY(-1), drawnWidth(-1), drawnOffset(-1)
+    {
+        label->setFont(font);
+        setZValue(1);
+    }
+
+    QGraphicsSimpleTextItem *label;
+    // Last drawn state
+    qreal   drawnX;
+    qreal   drawnY;
+    qreal   drawnWidth;
+    int     drawnOffset;
+    QString drawnColor;
+};
+
 SvgView::SvgView(QWidget *parent)
     : QGraphicsView(parent),
-    mGraphicItem(0)
+    mGraphicItem(0),
+    mBackground(0)
 {
+    // The scene index culls the activities outside of the viewport
     setScene(new QGraphicsScene(this));
+    scene()->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
     setTransformationAnchor(AnchorUnderMouse);
     setDragMode(ScrollHandDrag);
-    setViewportUpdateMode(FullViewportUpdate);
+    setViewportUpdateMode(SmartViewportUpdate);
     setAlignment(Qt::AlignLeft | Qt::AlignTop);
 
     mSvgRenderer = new QSvgRenderer();
@@ -109,15 +140,6 @@ void SvgView::loadPlan(vlePlan *plan)
     int planHeight = mGroupHeight * (3 + plan->countGroups());
     int planWidth  = (mMaxWidth * mZoomLevel);
 
-    // Create SVG document
-    QDomDocument planSVG("xml");
-    // Create root element
-    QDomElement e = planSVG.createElement("svg");
-    e.setAttribute("width",   QString(planWidth));
-    e.setAttribute("height",  QString(planHeight));
-    e.setAttribute("viewBox", QString("0 0 %1 %2").arg(planWidth).arg(planHeight));
-    e.setAttribute("version", "1.1");
-
     QDate dateStart = plan->dateStart();
     QDate dateEnd   = plan->dateEnd();
     int nbDays = dateStart.daysTo(dateEnd);
@@ -138,6 +160,41 @@ void SvgView::loadPlan(vlePlan *plan)
     //         << "[" << mPixelPerDay << "pixel per day]";
     }
 
+    // The time rule and the group headers only depend on the layout
+    QString layout = QString("%1;%2;%3;%4;%5;%6")
+        .arg(planWidth).arg(planHeight)
+        .arg(dateStart.toString(Qt::ISODate))
+        .arg(dateEnd.toString(Qt::ISODate))
+        .arg(mPixelPerDay).arg(mZoomLevel);
+    for (int i = 0; i < plan->countGroups(); i++)
+        layout += ";" + plan->getGroup(i)->getName();
+
+    if (layout != mLayout)
+    {
+        loadBackground(plan, planWidth, planHeight);
+        mLayout = layout;
+    }
+
+    updateActivities(plan);
+    scene()->setSceneRect(0, 0, planWidth, planHeight);
+
+    mPlan = plan;
+}
+
+void SvgView::loadBackground(vlePlan *plan, int planWidth, int planHeight)
+{
+    // Create SVG document
+    QDomDocument planSVG("xml");
+    // Create root element
+    QDomElement e = planSVG.createElement("svg");
+    e.setAttribute("width",   QString(planWidth));
+    e.setAttribute("height",  QString(planHeight));
+    e.setAttribute("viewBox", QString("0 0 %1 %2").arg(planWidth).arg(planHeight));
+    e.setAttribute("version", "1.1");
+
+    QDate dateStart = plan->dateStart();
+    QDate dateEnd   = plan->dateEnd();
+
     // First insert the time rule
     QDomElement timeGrp = mTplHeader.cloneNode().toElement();
     updateField(timeGrp, "{{name}}", "");
@@ -231,13 +288,10 @@ void SvgView::loadPlan(vlePlan *plan)
     }
     e.appendChild(timeGrp);
 
-    // Insert all the known groups
+    // Insert the headers of all the known groups
     for (int i=0; i < plan->countGroups(); i++)
     {
         vlePlanGroup *planGroup = plan->getGroup(i);
-        vlePlanActivity *prevActivity = 0;
-        int prevLen = 0;
-        int prevOffset = 0;
 
         // Create a new Group
         QDomElement newGrp = mTplHeader.cloneNode().toElement();
@@ -245,6 +299,45 @@ void SvgView::loadPlan(vlePlan *plan)
         updatePos  (newGrp, 0, ((i + 1) * mGroupHeight));
         updateAttr (newGrp, "header_background", "width", QString::number(planWidth));
 
+        e.appendChild(newGrp);
+    }
+    planSVG.appendChild( e );
+
+    QByteArray data;
+    QTextStream stream(&data);
+    planSVG.save(stream, QDomNode::EncodingFromTextStream);
+
+#ifdef PLAN_OUT
+    QFile File("planOut.svg");
+    File.open( QIODevice::WriteOnly );
+    QTextStream TextStream(&File);
+    planSVG.save(TextStream, 0);
+    File.close();
+    mFilename = "planOut.svg";
+#else
+    mFilename.clear();
+#endif
+
+    QXmlStreamReader xData(data);
+    mSvgRenderer->load(&xData);
+    refresh();
+}
+
+void SvgView::updateActivities(vlePlan *plan)
+{
+    QHash<QString, SvgViewActivity *> activities;
+    QDate dateStart = plan->dateStart();
+    qreal ascent = QFontMetricsF(mTaskFont).ascent();
+
+    for (int i=0; i < plan->countGroups(); i++)
+    {
+        vlePlanGroup *planGroup = plan->getGroup(i);
+        vlePlanActivity *prevActivity = 0;
+        int prevLen = 0;
+        int prevOffset = 0;
+        QHash<QString, int> occurrences;
+        qreal groupPos = ((i + 1) * mGroupHeight);
+
         for (int j = 0; j < planGroup->count(); j++)
         {
             vlePlanActivity *planActivity = planGroup->getActivity(j);
@@ -256,11 +349,6 @@ void SvgView::loadPlan(vlePlan *plan)
             if (actLength < 1)
                 actLength = 1;
 
-            QDomElement newAct = mTplTask.cloneNode().toElement();
-            updateField(newAct, "{{name}}", planActivity->getName());
-
-            updateAttr (newAct, "activity_block", "width", QString::number(actLength));
-
             QString cfgColor("#00edda");
             QString activityClass = planActivity->getClass();
             if ( ! activityClass.isEmpty() )
@@ -269,55 +357,76 @@ void SvgView::loadPlan(vlePlan *plan)
                 if ( ! cfg.isEmpty() )
                     cfgColor = cfg;
             }
-            QString fillStyle = QString(";fill:%1").arg(cfgColor);
-            updateAttr (newAct, "activity_block", "style", fillStyle, false);
 
             int date = dateStart.daysTo(planActivity->dateStart());
             int aPos = (date * mPixelPerDay * mZoomLevel);
 
+            int labelOffset = 15;
             if (prevActivity)
             {
                 if (prevLen > aPos)
                 {
                     if (prevOffset < 40)
                         prevOffset += 15;
-                    updateAttr(newAct, "activity_name", "y", QString::number(prevOffset));
+                    labelOffset = prevOffset;
                 }
                 else
                     prevOffset = 15;
             }
 
-            updatePos(newAct, aPos, 0);
-            newGrp.appendChild(newAct);
+            // Reuse the item drawn at the previous step, if any
+            QString name = planActivity->getName();
+            QString key = QString("%1\n%2\n%3").arg(planGroup->getName())
+                .arg(name).arg(occurrences[name]++);
+            SvgViewActivity *item = mActivities.take(key);
+            if (item == 0)
+            {
+                item = new SvgViewActivity(name, mTaskFont);
+                item->setPen(mTaskPen);
+                scene()->addItem(item);
+            }
+
+            qreal x = aPos + mTaskRect.x();
+            qreal y = groupPos + mTaskRect.y();
+            if ( (item->drawnX != x) || (item->drawnY != y) ||
+                 (item->drawnWidth != actLength) ||
+                 (item->drawnOffset != labelOffset) )
+            {
+                item->setRect(x, y, actLength, mTaskRect.height());
+                item->label->setPos(x + mTaskLabel.x(),
+                                    groupPos + mTaskLabel.y() +
+                                    labelOffset - 15 - ascent);
+                item->drawnX = x;
+                item->drawnY = y;
+                item->drawnWidth = actLength;
+                item->drawnOffset = labelOffset;
+            }
+            if (item->drawnColor != cfgColor)
+            {
+                item->setBrush(QColor(cfgColor));
+                item->drawnColor = cfgColor;
+            }
+            activities.insert(key, item);
 
             prevActivity = planActivity;
-            prevLen = aPos + (planActivity->getName().size() * 8);
+            prevLen = aPos + (name.size() * 8);
         }
-
-        e.appendChild(newGrp);
     }
-    planSVG.appendChild( e );
-
-    QByteArray data;
-    QTextStream stream(&data);
-    planSVG.save(stream, QDomNode::EncodingFromTextStream);
 
-#ifdef PLAN_OUT
-    QFile File("planOut.svg");
-    File.open( QIODevice::WriteOnly );
-    QTextStream TextStream(&File);
-    planSVG.save(TextStream, 0);
-    File.close();
-    mFilename = "planOut.svg";
-#else
-    mFilename.clear();
-#endif
-
-    mPlan = plan;
+    // Remove the activities that are not in the plan anymore
+    clearActivities();
+    mActivities.swap(activities);
+}
 
-    QXmlStreamReader xData(data);
-    mSvgRenderer->load(&xData);
-    refresh();
+void SvgView::clearActivities(void)
+{
+    QHash<QString, SvgViewActivity *>::iterator it;
+    for (it = mActivities.begin(); it != mActivities.end(); ++it)
+    {
+        scene()->removeItem(it.value());
+        delete it.value();
+    }
+    mActivities.clear();
 }
 
 void SvgView::loadFile(QString fileName)
@@ -325,6 +434,8 @@ void SvgView::loadFile(QString fileName)
     qWarning() << "SVG load file " << fileName;
 
     mFilename = fileName;
+    mLayout.clear();
+    clearActivities();
 
     QFile file(fileName);
     file.open(QIODevice::ReadOnly);
@@ -509,6 +620,7 @@ bool SvgView::loadTemplate()
             qWarning() << "SVG group with no template : " << n.attribute("id");
     }
     mTplRoot = e;
+    loadTaskStyle();
 
     return true;
 }
@@ -555,13 +667,13 @@ bool SvgView::loadTemplate(QString fileName)
             qWarning() << "SVG group with no template : " << n.attribute("id");
     }
     mTplRoot = e;
+    loadTaskStyle();
 
     return true;
 }
 
 void SvgView::refresh(void)
 {
-    QGraphicsScene *s = scene();
     QPixmap Image(mSvgRenderer->defaultSize());
     QPainter Painter;
 
@@ -570,8 +682,70 @@ void SvgView::refresh(void)
     Painter.begin(&Image);
     mSvgRenderer->render(&Painter);
     Painter.end();
-    s->clear();
-    s->addPixmap(Image);
+
+    // Only the background is replaced, the activities are kept
+    if (mBackground == 0)
+    {
+        mBackground = scene()->addPixmap(Image);
+        mBackground->setZValue(0);
+    }
+    else
+        mBackground->setPixmap(Image);
+}
+
+static QDomElement findSelector(const QDomElement &e, const QString &selector)
+{
+    if (e.attribute("vle:selector") == selector)
+        return e;
+
+    for(QDomElement n = e.firstChildElement(); !n.isNull(); n = n.nextSiblingElement())
+    {
+        QDomElement found = findSelector(n, selector);
+        if ( ! found.isNull())
+            return found;
+    }
+    return QDomElement();
+}
+
+static QString styleValue(const QDomElement &e, const QString &key)
+{
+    QStringList fields = e.attribute("style").split(QChar(';'));
+    for (int i = 0; i < fields.count(); i++)
+    {
+        QStringList pair = fields.at(i).split(QChar(':'));
+        if ((pair.count() == 2) && (pair.at(0).trimmed() == key))
+            return pair.at(1).trimmed();
+    }
+    return QString();
+}
+
+void SvgView::loadTaskStyle(void)
+{
+    // Geometry and stroke of the activity block
+    QDomElement block = findSelector(mTplTask, "activity_block");
+    mTaskRect = QRectF(block.attribute("x", "120").toDouble(),
+                       block.attribute("y", "20").toDouble(),
+                       block.attribute("width", "100").toDouble(),
+                       block.attribute("height", "30").toDouble());
+
+    QString stroke = styleValue(block, "stroke");
+    mTaskPen = QPen(QColor(stroke.isEmpty() ? QString("#000000") : stroke));
+    mTaskPen.setWidthF(styleValue(block, "stroke-width").toDouble());
+
+    // Position and font of the activity name
+    QDomElement label = findSelector(mTplTask, "activity_name");
+    QDomElement span = label.firstChildElement("tspan");
+    if (span.isNull())
+        span = label;
+    mTaskLabel = QPointF(span.attribute("x", "125").toDouble() - mTaskRect.x(),
+                         span.attribute("y", "42.5").toDouble());
+
+    mTaskFont = QFont(styleValue(label, "font-family"));
+    QString size = styleValue(span, "font-size");
+    if (size.isEmpty())
+        size = styleValue(label, "font-size");
+    size.remove("px");
+    mTaskFont.setPixelSize(size.isEmpty() ? 12 : qRound(size.toDouble()));
 }
 
 void SvgView::reload(void)
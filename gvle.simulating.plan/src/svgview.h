@@ -24,7 +24,11 @@
 #ifndef SVGVIEW_H
 #define SVGVIEW_H
 
+#include <QGraphicsPixmapItem>
 #include <QGraphicsView>
+#include <QFont>
+#include <QHash>
+#include <QPen>
 #include <QSvgRenderer>
 #include <QtXml>
 #include <QMouseEvent>
@@ -45,6 +49,8 @@ private:
     QMap<QString, QString> mConfig;
 };
 
+class SvgViewActivity;
+
 class SvgView: public QGraphicsView
 {
     Q_OBJECT
@@ -69,6 +75,10 @@ private:
 		     QString attr, QString value, bool replace = true);
     void updateField(QDomNode    &e, QString tag,  QString value);
     void updatePos  (QDomElement &e, int x, int y);
+    void loadBackground(vlePlan *plan, int planWidth, int planHeight);
+    void loadTaskStyle(void);
+    void updateActivities(vlePlan *plan);
+    void clearActivities(void);
 protected:
     void mouseMoveEvent(QMouseEvent *event);
     void wheelEvent(QWheelEvent* event);
@@ -76,12 +86,22 @@ private:
     // Widget variables
     QGraphicsItem *mGraphicItem;
     QSvgRenderer  *mSvgRenderer;
+    QGraphicsPixmapItem *mBackground;
+    // Retained activities, by group, name and occurrence
+    QHash<QString, SvgViewActivity *> mActivities;
+    // Signature of the time rule and group headers currently drawn
+    QString        mLayout;
     // SVG template variables
     QDomDocument   mTplDocument;
     QDomElement    mTplRoot;
     QDomElement    mTplHeader;
     QDomElement    mTplTask;
     QDomElement    mTplTime;
+    // Activity style read from the task template
+    QRectF         mTaskRect;
+    QPointF        mTaskLabel;
+    QPen           mTaskPen;
+    QFont          mTaskFont;
     //
     vlePlan       *mPlan;
     int            mMaxWidth;
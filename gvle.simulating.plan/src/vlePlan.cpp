@@ -41,6 +41,9 @@ void vlePlan::clear(void)
         delete mGroups.takeFirst();
     // Mark current plan as invalid
     mValid = false;
+    // Invalidate the date caches
+    mDateStart = QDate();
+    mDateEnd   = QDate();
 }
 
 QDate vlePlan::dateEnd(void)
@@ -22,6 +22,9 @@
 #include <vle/devs/Dynamics.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/utils/Rand.hpp>
+#include <vle/value/Tuple.hpp>
+
+#include <vector>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846264338327
@@ -40,23 +43,29 @@ namespace vv = vle::value;
  * @brief VLE dynamics that computes the value of ExBohachevsky function
  * for two inputs. The minimal value of this function is 0 for
  * (x1,x2) = (0,0)
+ *
+ * If the condition has a port "warm_start_runs" (n), the model runs in
+ * warm start mode: x1, x2 and seed are tuples with one value per run,
+ * the run k is observed at time k and the model resets its state to the
+ * run k at time k - 0.5 (see test/warm_start.hpp).
  */
 class ExBohachevsky: public vd::Dynamics
 {
 
 public:
     ExBohachevsky(const vd::DynamicsInit& init, const vd::InitEventList& events) :
-        vd::Dynamics(init,events)
+        vd::Dynamics(init,events), mrun(0), mruns(0)
     {
-        x1 = events.getDouble("x1");
-        x2 = events.getDouble("x2");
-
-        my = pow(x1,2) + 2 * pow(x2,2) - 0.3 * cos(3 * M_PI * x1)
-                - 0.4 * cos(4 * M_PI * x2) + 0.7;
-
-        mrand.seed(events.getInt("seed"));
-        double noise = mrand.normal(0,0.1);
-        my_noise = my + noise;
+        if (events.exist("warm_start_runs")) {
+            mruns = events.getInt("warm_start_runs");
+            mx1 = events.getTuple("x1").value();
+            mx2 = events.getTuple("x2").value();
+            mseeds = events.getTuple("seed").value();
+            reset(mx1[0], mx2[0], static_cast<int>(mseeds[0]));
+        } else {
+            reset(events.getDouble("x1"), events.getDouble("x2"),
+                  events.getInt("seed"));
+        }
     }
 
     virtual ~ExBohachevsky()
@@ -64,8 +73,20 @@ public:
     }
     vd::Time init(vd::Time /* time */) override
     {
+        return timeAdvance();
+    }
+    vd::Time timeAdvance() const override
+    {
+        if (mrun + 1 < mruns) {
+            return mrun == 0 ? 0.5 : 1.0;
+        }
         return vd::infinity;
     }
+    void internalTransition(vd::Time /* time */) override
+    {
+        mrun++;
+        reset(mx1[mrun], mx2[mrun], static_cast<int>(mseeds[mrun]));
+    }
     std::unique_ptr<value::Value> observation(
             const vd::ObservationEvent& event) const override
     {
@@ -93,6 +114,33 @@ private:
     double my_noise;
     vle::utils::Rand mrand;
 
+    /**
+     * @brief Warm start mode: current run, number of runs and the
+     * inputs of each run
+     */
+    unsigned int mrun;
+    unsigned int mruns;
+    std::vector<double> mx1;
+    std::vector<double> mx2;
+    std::vector<double> mseeds;
+
+    /**
+     * @brief Reset hook: sets the state of the model as the constructor
+     * does for the inputs (x1, x2, seed)
+     */
+    void reset(double in_x1, double in_x2, int seed)
+    {
+        x1 = in_x1;
+        x2 = in_x2;
+
+        my = pow(x1,2) + 2 * pow(x2,2) - 0.3 * cos(3 * M_PI * x1)
+                - 0.4 * cos(4 * M_PI * x2) + 0.7;
+
+        mrand.seed(seed);
+        double noise = mrand.normal(0,0.1);
+        my_noise = my + noise;
+    }
+
 };
 
 }}}// namespaces
@@ -0,0 +1,285 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_TEST_MANAGER_AGGREGATORS_HPP
+#define VLE_TEST_MANAGER_AGGREGATORS_HPP 1
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327
+#endif
+
+namespace vle {
+namespace recursive {
+namespace test {
+
+/**
+ * @brief Streaming mean and variance (Welford). Two partial aggregates,
+ * from two slots or two ranks, are combined with merge (Chan et al.).
+ */
+class MeanVariance
+{
+public:
+    MeanVariance()
+        : mCount(0), mMean(0.0), mM2(0.0)
+    {}
+
+    void add(double x)
+    {
+        mCount++;
+        double delta = x - mMean;
+        mMean += delta / mCount;
+        mM2 += delta * (x - mMean);
+    }
+
+    void merge(const MeanVariance& other)
+    {
+        if (other.mCount == 0) {
+            return;
+        }
+
+        double count = mCount + other.mCount;
+        double delta = other.mMean - mMean;
+        mMean += delta * other.mCount / count;
+        mM2 += other.mM2 + delta * delta * mCount * other.mCount / count;
+        mCount += other.mCount;
+    }
+
+    unsigned long count() const { return mCount; }
+    double mean() const { return mMean; }
+
+    /**
+     * @brief the sample variance, 0 with less than two values.
+     */
+    double variance() const
+    { return mCount > 1 ? mM2 / (mCount - 1) : 0.0; }
+
+private:
+    unsigned long mCount;
+    double mMean;
+    double mM2;
+};
+
+/**
+ * @brief Streaming minimum and maximum.
+ */
+class MinMax
+{
+public:
+    MinMax()
+        : mMin(std::numeric_limits<double>::infinity()),
+          mMax(-std::numeric_limits<double>::infinity())
+    {}
+
+    void add(double x)
+    {
+        mMin = std::min(mMin, x);
+        mMax = std::max(mMax, x);
+    }
+
+    void merge(const MinMax& other)
+    {
+        if (other.empty()) {
+            return;
+        }
+
+        add(other.mMin);
+        add(other.mMax);
+    }
+
+    bool empty() const { return mMin > mMax; }
+    double min() const { return mMin; }
+    double max() const { return mMax; }
+
+private:
+    double mMin;
+    double mMax;
+};
+
+/**
+ * @brief Streaming mean squared error of a simulated trajectory against
+ * observations. Each simulation folds its values at the observation
+ * times.
+ */
+class SquaredError
+{
+public:
+    SquaredError()
+        : mCount(0), mSum(0.0)
+    {}
+
+    void add(double simulated, double observed)
+    {
+        mCount++;
+        mSum += (simulated - observed) * (simulated - observed);
+    }
+
+    void merge(const SquaredError& other)
+    {
+        mCount += other.mCount;
+        mSum += other.mSum;
+    }
+
+    double mse() const { return mCount ? mSum / mCount : 0.0; }
+
+private:
+    unsigned long mCount;
+    double mSum;
+};
+
+/**
+ * @brief Streaming quantiles with a merging t-digest: values are kept in
+ * at most about compression centroids, small near the extreme quantiles
+ * and large near the median. Digests are merged by merging their
+ * centroids.
+ */
+class QuantileDigest
+{
+public:
+    typedef std::pair<double, double> Centroid; /* mean, weight */
+
+    explicit QuantileDigest(double compression = 100.0)
+        : mCompression(compression), mWeight(0.0)
+    {}
+
+    void add(double x, double weight = 1.0)
+    {
+        mMinMax.add(x);
+        mBuffer.push_back(Centroid(x, weight));
+        if (mBuffer.size() >= 5 * mCompression) {
+            compress();
+        }
+    }
+
+    void merge(const QuantileDigest& other)
+    {
+        if (other.mMinMax.empty()) {
+            return;
+        }
+
+        mMinMax.merge(other.mMinMax);
+        mBuffer.insert(mBuffer.end(), other.mCentroids.begin(),
+                       other.mCentroids.end());
+        mBuffer.insert(mBuffer.end(), other.mBuffer.begin(),
+                       other.mBuffer.end());
+        compress();
+    }
+
+    /**
+     * @brief the estimated quantile q in [0, 1], NaN without values.
+     */
+    double quantile(double q)
+    {
+        compress();
+
+        if (mCentroids.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        double target = q * mWeight;
+        double cumul = 0.0;
+        double prevCenter = 0.0;
+        double prevMean = mMinMax.min();
+
+        for (const auto& c : mCentroids) {
+            double center = cumul + c.second / 2.0;
+            if (target < center) {
+                double t = (target - prevCenter) / (center - prevCenter);
+                return prevMean + t * (c.first - prevMean);
+            }
+            prevCenter = center;
+            prevMean = c.first;
+            cumul += c.second;
+        }
+
+        double t = (target - prevCenter) / (mWeight - prevCenter);
+        return prevMean + t * (mMinMax.max() - prevMean);
+    }
+
+    std::size_t centroids()
+    {
+        compress();
+        return mCentroids.size();
+    }
+
+private:
+    double scale(double q) const
+    { return mCompression / (2.0 * M_PI) * std::asin(2.0 * q - 1.0); }
+
+    double inverseScale(double k) const
+    {
+        k = std::min(k, mCompression / 4.0);
+        return (std::sin(k * 2.0 * M_PI / mCompression) + 1.0) / 2.0;
+    }
+
+    void compress()
+    {
+        if (mBuffer.empty()) {
+            return;
+        }
+
+        mBuffer.insert(mBuffer.end(), mCentroids.begin(), mCentroids.end());
+        mCentroids.clear();
+        std::sort(mBuffer.begin(), mBuffer.end());
+
+        mWeight = 0.0;
+        for (const auto& c : mBuffer) {
+            mWeight += c.second;
+        }
+
+        mCentroids.push_back(mBuffer.front());
+        double done = mBuffer.front().second;
+        double limit = inverseScale(scale(0.0) + 1.0);
+
+        for (std::size_t i = 1; i < mBuffer.size(); ++i) {
+            const Centroid& c = mBuffer[i];
+            if ((done + c.second) / mWeight <= limit) {
+                Centroid& last = mCentroids.back();
+                last.second += c.second;
+                last.first += (c.first - last.first) * c.second / last.second;
+            } else {
+                limit = inverseScale(scale(done / mWeight) + 1.0);
+                mCentroids.push_back(c);
+            }
+            done += c.second;
+        }
+
+        mBuffer.clear();
+    }
+
+    double mCompression;
+    double mWeight;
+    MinMax mMinMax;
+    std::vector<Centroid> mCentroids;
+    std::vector<Centroid> mBuffer;
+};
+
+}}} // namespaces
+
+#endif
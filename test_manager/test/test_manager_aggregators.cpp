@@ -0,0 +1,281 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//@@tagtest@@
+//@@tagdepends: @@endtagdepends
+
+
+#include <vle/value/Map.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/manager/Manager.hpp>
+
+#include "aggregators.hpp"
+
+#include <iostream>
+
+namespace vrt = vle::recursive::test;
+
+void test_aggregators_merge()
+{
+    vrt::MeanVariance mv[2], mvAll;
+    vrt::MinMax mm[2], mmAll;
+    vrt::QuantileDigest qd[2], qdAll;
+
+    for (int i = 1; i <= 10000; ++i) {
+        double x = (i * 7919) % 10000;
+        mv[i % 2].add(x);
+        mm[i % 2].add(x);
+        qd[i % 2].add(x);
+        mvAll.add(x);
+        mmAll.add(x);
+        qdAll.add(x);
+    }
+
+    mv[0].merge(mv[1]);
+    mm[0].merge(mm[1]);
+    qd[0].merge(qd[1]);
+
+    Ensures(mv[0].count() == 10000);
+    EnsuresApproximatelyEqual(mv[0].mean(), 4999.5, 10e-6);
+    EnsuresApproximatelyEqual(mv[0].mean(), mvAll.mean(), 10e-6);
+    EnsuresApproximatelyEqual(mv[0].variance(), mvAll.variance(), 10e-3);
+    EnsuresApproximatelyEqual(mv[0].variance(), 8334166.6667, 10e-3);
+    Ensures(mm[0].min() == 0 and mm[0].max() == 9999);
+    Ensures(mmAll.min() == 0 and mmAll.max() == 9999);
+
+    //constant size state, quantiles within 1% of the range
+    Ensures(qdAll.centroids() <= 100);
+    Ensures(qd[0].centroids() <= 100);
+    EnsuresApproximatelyEqual(qd[0].quantile(0.5), 5000, 100);
+    EnsuresApproximatelyEqual(qdAll.quantile(0.5), 5000, 100);
+    EnsuresApproximatelyEqual(qd[0].quantile(0.01), 100, 100);
+    EnsuresApproximatelyEqual(qd[0].quantile(0.99), 9900, 100);
+
+    vrt::SquaredError se[2], seAll;
+    for (int i = 0; i < 10; ++i) {
+        se[i % 2].add(i, 0.0);
+        seAll.add(i, 0.0);
+    }
+    se[0].merge(se[1]);
+    EnsuresApproximatelyEqual(se[0].mse(), 28.5, 10e-6);
+    EnsuresApproximatelyEqual(seAll.mse(), 28.5, 10e-6);
+}
+
+void test_aggregators_merge_empty()
+{
+    //an idle slot or rank contributes an empty partial aggregate
+    vrt::MeanVariance mv, mvEmpty;
+    vrt::MinMax mm, mmEmpty;
+    vrt::QuantileDigest qd, qdEmpty;
+
+    for (int i = 1; i <= 100; ++i) {
+        mv.add(i);
+        mm.add(i);
+        qd.add(i);
+    }
+
+    mv.merge(mvEmpty);
+    mm.merge(mmEmpty);
+    qd.merge(qdEmpty);
+
+    Ensures(mv.count() == 100);
+    EnsuresApproximatelyEqual(mv.mean(), 50.5, 10e-6);
+    Ensures(mm.min() == 1 and mm.max() == 100);
+    EnsuresApproximatelyEqual(qd.quantile(0.0), 1, 10e-6);
+    EnsuresApproximatelyEqual(qd.quantile(1.0), 100, 10e-6);
+    EnsuresApproximatelyEqual(qd.quantile(0.5), 50.5, 1);
+
+    //and the other way around
+    mmEmpty.merge(mm);
+    qdEmpty.merge(qd);
+    Ensures(mmEmpty.min() == 1 and mmEmpty.max() == 100);
+    EnsuresApproximatelyEqual(qdEmpty.quantile(0.0), 1, 10e-6);
+    EnsuresApproximatelyEqual(qdEmpty.quantile(1.0), 100, 10e-6);
+
+    //two empty partials stay empty
+    vrt::MinMax mmNone;
+    vrt::QuantileDigest qdNone;
+    mmNone.merge(vrt::MinMax());
+    qdNone.merge(vrt::QuantileDigest());
+    Ensures(mmNone.empty());
+    Ensures(std::isnan(qdNone.quantile(0.5)));
+}
+
+std::unique_ptr<vle::value::Map> run_ExBohachevsky(const vle::value::Set& seeds,
+                                                   bool mean)
+{
+    namespace vv = vle::value;
+    namespace vm = vle::manager;
+
+    vv::Tuple x1(2);
+    x1[0] = 3.0;
+    x1[1] = 0.0;
+    vv::Tuple x2(2);
+    x2[0] = -10;
+    x2[1] = 0.0;
+
+    vv::Map config;
+    config.addString("parallel_option","mono");
+    config.addInt("nb_slots",1);
+
+    vv::Map init;
+    init.addString("package","test_manager");
+    init.addString("vpz","ExBohachevsky.vpz");
+    init.add("input_cond.x1", x1.clone());
+    init.add("input_cond.x2", x2.clone());
+    init.add("replicate_cond.seed", seeds.clone());
+    vv::Map& conf_ynoise = init.addMap("output_ynoise");
+    conf_ynoise.addString("path", "view/ExBohachevsky:ExBohachevsky.y_noise");
+    conf_ynoise.addString("integration","max");
+    if (mean) {
+        conf_ynoise.addString("aggregation_replicate","mean");
+    }
+
+    auto ctx = vle::utils::make_context();
+    vm::Manager manager(ctx, config);
+
+    vle::manager::Error err;
+    std::unique_ptr<vv::Map> res = manager.runPlan(init, err);
+
+    if (err.code ==-1) {
+        std::cout << " error: " << err.message << "\n";
+    }
+    return res;
+}
+
+void test_replicate_streaming()
+{
+    namespace vv = vle::value;
+
+    const int seeds[] = { 1235, 7234, 9531, 4242, 1111, 8080 };
+
+    //one aggregate per input and per slot, each replicate is folded
+    //when its simulation is finished
+    vrt::MeanVariance mv[2][2];
+    vrt::MinMax mm[2][2];
+    vrt::QuantileDigest qd[2][2];
+
+    vv::Set all;
+    for (int r = 0; r < 6; ++r) {
+        all.addInt(seeds[r]);
+
+        vv::Set one;
+        one.addInt(seeds[r]);
+        std::unique_ptr<vv::Map> res = run_ExBohachevsky(one, true);
+        Ensures(res->getTable("ynoise").width() == 2);
+
+        for (int input = 0; input < 2; ++input) {
+            double y = res->getTable("ynoise")(input, 0);
+            mv[r % 2][input].add(y);
+            mm[r % 2][input].add(y);
+            qd[r % 2][input].add(y);
+        }
+    }
+
+    std::unique_ptr<vv::Map> res = run_ExBohachevsky(all, true);
+
+    for (int input = 0; input < 2; ++input) {
+        mv[0][input].merge(mv[1][input]);
+        mm[0][input].merge(mm[1][input]);
+        qd[0][input].merge(qd[1][input]);
+
+        Ensures(mv[0][input].count() == 6);
+        EnsuresApproximatelyEqual(mv[0][input].mean(),
+                res->getTable("ynoise")(input, 0), 10e-6);
+        Ensures(mm[0][input].min() <= mv[0][input].mean());
+        Ensures(mm[0][input].max() >= mv[0][input].mean());
+        Ensures(qd[0][input].quantile(0.5) >= mm[0][input].min());
+        Ensures(qd[0][input].quantile(0.5) <= mm[0][input].max());
+    }
+}
+
+void test_mse_streaming()
+{
+    namespace vv = vle::value;
+    namespace vm = vle::manager;
+
+    vv::Tuple x(2);
+    x[0] = 3.0;
+    x[1] = 0.0;
+
+    const double obs[] = { 2.7, 3.42, 3.75 };
+    const int times[] = { 4, 10, 16 };
+
+    vv::Tuple y_obs(3);
+    vv::Tuple y_times(3);
+    for (int i = 0; i < 3; ++i) {
+        y_obs[i] = obs[i];
+        y_times[i] = times[i];
+    }
+
+    vv::Map config;
+    config.addString("parallel_option","mono");
+    config.addInt("nb_slots",1);
+
+    vv::Map init;
+    init.addString("package","test_manager");
+    init.addString("vpz","LogEx.vpz");
+    init.add("input_cond.init_value_x", x.clone());
+    vv::Map& conf_msey = init.addMap("output_msey");
+    conf_msey.addString("path", "view/LogEx:LogEx.y");
+    conf_msey.addString("integration","mse");
+    conf_msey.add("mse_observations", y_obs.clone());
+    conf_msey.add("mse_times", y_times.clone());
+    vv::Map& conf_y = init.addMap("output_y");
+    conf_y.addString("path", "view/LogEx:LogEx.y");
+    conf_y.addString("integration","all");
+
+    auto ctx = vle::utils::make_context();
+    vm::Manager manager(ctx, config);
+
+    vle::manager::Error err;
+    std::unique_ptr<vv::Map> res = manager.runPlan(init, err);
+
+    if (err.code ==-1) {
+        std::cout << " error: " << err.message << "\n";
+    }
+
+    for (int input = 0; input < 2; ++input) {
+        vrt::SquaredError se;
+        for (int i = 0; i < 3; ++i) {
+            se.add(res->getTable("y")(input, times[i]), obs[i]);
+        }
+        EnsuresApproximatelyEqual(se.mse(),
+                res->getTable("msey")(input, 0), 10e-6);
+    }
+}
+
+int main()
+{
+    test_aggregators_merge();
+    test_aggregators_merge_empty();
+    test_replicate_streaming();
+    test_mse_streaming();
+
+    return unit_test::report_errors();
+}
@@ -0,0 +1,341 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//@@tagtest@@
+//@@tagdepends: @@endtagdepends
+
+/*
+ * Scaling benchmark of vle::manager::Manager::runPlan. Each model is
+ * simulated on plans of increasing size, with replicates and a simulation
+ * duration that sets the cost of each run, for each parallel option and
+ * number of slots. Each configuration reports the throughput, the mean
+ * time per simulation, the memory and the speedup against the "mono"
+ * option. The memory is the increase of the resident set size sampled
+ * during the plan, per slot, for the options "mono" and "threads"; for
+ * "mpi", the simulations run in child processes and it is the peak
+ * resident set size of the largest child process so far. The sweep is set by the environment
+ * variables (comma separated lists):
+ *
+ *  - TEST_MANAGER_BENCH_MODELS: models (LogEx,SIRnoise). LogEx costs
+ *    little per step, SIRnoise stores all the steps of a timed view.
+ *  - TEST_MANAGER_BENCH_SIZES: numbers of combinations (10,100).
+ *  - TEST_MANAGER_BENCH_REPLICATES: numbers of replicates (1,3).
+ *  - TEST_MANAGER_BENCH_DURATIONS: simulation durations (1,30).
+ *  - TEST_MANAGER_BENCH_OPTIONS: parallel options (mono,threads); "mpi"
+ *    requires cvle.
+ *  - TEST_MANAGER_BENCH_SLOTS: numbers of slots (1,2).
+ *
+ * The defaults are small so that the benchmark runs as a test; a full
+ * sweep uses for example sizes 10,1000,100000 and durations 1,1000,100000.
+ */
+
+#include <vle/value/Map.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/manager/Manager.hpp>
+
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vv = vle::value;
+namespace vm = vle::manager;
+
+struct BenchResult
+{
+    BenchResult()
+        : ok(false), seconds(0.0), memory(0)
+    {}
+
+    bool ok;
+    double seconds;
+    long memory; /* KiB, see the header */
+    std::unique_ptr<vv::Table> y;
+};
+
+std::vector<std::string> bench_list(const char* variable,
+                                    const char* defaults)
+{
+    const char* value = std::getenv(variable);
+    std::istringstream in(value ? value : defaults);
+    std::vector<std::string> result;
+    std::string item;
+
+    while (std::getline(in, item, ',')) {
+        if (not item.empty()) {
+            result.push_back(item);
+        }
+    }
+
+    return result;
+}
+
+std::vector<int> bench_ints(const char* variable, const char* defaults)
+{
+    std::vector<std::string> items = bench_list(variable, defaults);
+    std::vector<int> result;
+
+    for (const auto& item : items) {
+        result.push_back(std::atoi(item.c_str()));
+    }
+
+    return result;
+}
+
+/* current resident set size in KiB, 0 if unknown */
+long bench_current_memory()
+{
+    std::ifstream statm("/proc/self/statm");
+    long size = 0, resident = 0;
+
+    if (not (statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* peak resident set size in KiB of the terminated child processes */
+long bench_children_memory()
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_CHILDREN, &usage);
+    return usage.ru_maxrss;
+}
+
+/*
+ * Samples the resident set size of the process in a thread, from the
+ * construction to stop(), and keeps the highest value.
+ */
+class BenchMemorySampler
+{
+public:
+    BenchMemorySampler()
+        : m_stop(false), m_peak(bench_current_memory())
+        , m_thread(&BenchMemorySampler::run, this)
+    {}
+
+    ~BenchMemorySampler()
+    {
+        stop();
+    }
+
+    long stop()
+    {
+        if (m_thread.joinable()) {
+            m_stop = true;
+            m_thread.join();
+        }
+        return m_peak;
+    }
+
+private:
+    void run()
+    {
+        while (not m_stop) {
+            m_peak = std::max(m_peak, bench_current_memory());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        m_peak = std::max(m_peak, bench_current_memory());
+    }
+
+    std::atomic<bool> m_stop;
+    long m_peak;
+    std::thread m_thread;
+};
+
+/*
+ * Builds the plan of a model: the size values of one input, the
+ * replicates on the seed and the output of the last value of a variable.
+ */
+void bench_plan(vv::Map& init, const std::string& model, int size,
+                int replicates, int duration)
+{
+    vv::Tuple durations(size);
+    vv::Tuple x(size);
+    vv::Tuple seeds(replicates);
+    for (int i = 0; i < size; ++i) {
+        durations[i] = duration;
+    }
+
+    init.addString("package", "test_manager");
+    init.add("input_simulation_engine.duration", durations.clone());
+    vv::Map& conf_y = init.addMap("output_y");
+    conf_y.addString("integration", "last");
+    conf_y.addString("aggregation_replicate", "mean");
+
+    if (model == "SIRnoise") {
+        for (int i = 0; i < size; ++i) {
+            x[i] = 50 + i % 100;
+        }
+        for (int i = 0; i < replicates; ++i) {
+            seeds[i] = 45694 + 10001 * i;
+        }
+        init.addString("vpz", "SIRnoise.vpz");
+        init.add("input_condSIRnoise.init_value_S", x.clone());
+        init.add("replicate_condSIRnoise.init_value_seed", seeds.clone());
+        conf_y.addString("path", "view/top:SIRnoise.S");
+    } else {
+        vv::Set intSeeds;
+        for (int i = 0; i < size; ++i) {
+            x[i] = i;
+        }
+        for (int i = 0; i < replicates; ++i) {
+            intSeeds.addInt(1235 + i);
+        }
+        init.addString("vpz", "LogEx.vpz");
+        init.add("input_cond.init_value_x", x.clone());
+        init.add("replicate_cond.seed", intSeeds.clone());
+        conf_y.addString("path", "view/LogEx:LogEx.y");
+    }
+}
+
+BenchResult bench_run(const std::string& model, const std::string& option,
+                      int slots, int size, int replicates, int duration)
+{
+    vv::Map config;
+    config.addString("parallel_option", option);
+    config.addInt("nb_slots", slots);
+
+    vv::Map init;
+    bench_plan(init, model, size, replicates, duration);
+
+    BenchResult result;
+    auto ctx = vle::utils::make_context();
+    vm::Manager manager(ctx, config);
+    vle::manager::Error err;
+
+    long before = bench_current_memory();
+    BenchMemorySampler sampler;
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<vv::Map> res = manager.runPlan(init, err);
+    auto end = std::chrono::steady_clock::now();
+    long peak = sampler.stop();
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.memory = (option == "mpi") ? bench_children_memory()
+                                      : (peak - before) / slots;
+
+    if (err.code == -1 or not res or not res->exist("y")) {
+        std::cout << " error (" << model << ", " << option << "): "
+                  << err.message << "\n";
+        return result;
+    }
+
+    result.ok = true;
+    result.y.reset(new vv::Table(res->getTable("y")));
+    return result;
+}
+
+void test_bench()
+{
+    std::vector<std::string> models =
+        bench_list("TEST_MANAGER_BENCH_MODELS", "LogEx,SIRnoise");
+    std::vector<int> sizes = bench_ints("TEST_MANAGER_BENCH_SIZES", "10,100");
+    std::vector<int> replicates =
+        bench_ints("TEST_MANAGER_BENCH_REPLICATES", "1,3");
+    std::vector<int> durations =
+        bench_ints("TEST_MANAGER_BENCH_DURATIONS", "1,30");
+    std::vector<std::string> options =
+        bench_list("TEST_MANAGER_BENCH_OPTIONS", "mono,threads");
+    std::vector<int> slots = bench_ints("TEST_MANAGER_BENCH_SLOTS", "1,2");
+
+    std::printf("%-8s %-8s %5s %8s %5s %8s %10s %12s %12s %10s %8s\n",
+                "model", "option", "slots", "size", "repl", "duration",
+                "time(s)", "sims/s", "us/sim", "mem(KiB)", "speedup");
+
+    for (const auto& model : models) {
+        for (int size : sizes) {
+            for (int repl : replicates) {
+                for (int duration : durations) {
+                    BenchResult mono = bench_run(model, "mono", 1, size, repl,
+                                                 duration);
+                    Ensures(mono.ok);
+                    if (not mono.ok) {
+                        continue;
+                    }
+                    Ensures(mono.y->width() == (std::size_t)size);
+
+                    for (const auto& option : options) {
+                        for (int slot : slots) {
+                            if (option == "mono" and slot != 1) {
+                                continue;
+                            }
+
+                            BenchResult other;
+                            if (option != "mono") {
+                                other = bench_run(model, option, slot, size,
+                                                  repl, duration);
+                            }
+
+                            const BenchResult& r =
+                                (option == "mono") ? mono : other;
+                            Ensures(r.ok);
+                            if (not r.ok) {
+                                continue;
+                            }
+
+                            double sims = (double)size * repl;
+                            std::printf("%-8s %-8s %5d %8d %5d %8d %10.4f "
+                                        "%12.1f %12.2f %10ld %8.2f\n",
+                                        model.c_str(), option.c_str(), slot,
+                                        size, repl, duration, r.seconds,
+                                        sims / r.seconds,
+                                        1e6 * r.seconds / sims, r.memory,
+                                        mono.seconds / r.seconds);
+
+                            /* the results do not depend on the option */
+                            Ensures(r.y->width() == (std::size_t)size);
+                            for (int i = 0; i < size; ++i) {
+                                EnsuresApproximatelyEqual((*r.y)(i, 0),
+                                                          (*mono.y)(i, 0),
+                                                          10e-6);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    test_bench();
+
+    return unit_test::report_errors();
+}
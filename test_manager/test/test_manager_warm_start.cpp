@@ -0,0 +1,126 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//@@tagtest@@
+//@@tagdepends: @@endtagdepends
+
+
+#include <vle/value/Map.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/utils/unit-test.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/manager/Manager.hpp>
+
+#include "warm_start.hpp"
+
+#include <chrono>
+#include <iostream>
+
+void test_warm_start_ExBohachevsky()
+{
+    namespace vv = vle::value;
+    namespace vm = vle::manager;
+
+    const unsigned int size = 20;
+
+    vv::Tuple x1(size);
+    vv::Tuple x2(size);
+    vv::Tuple seeds(size);
+    vv::Set seedsPlan;
+    for (unsigned int i = 0; i < size; ++i) {
+        x1[i] = -2.0 + 0.2 * i;
+        x2[i] = 1.0 - 0.1 * i;
+        seeds[i] = 1235 + i;
+        seedsPlan.addInt(1235 + i);
+    }
+
+    vv::Map config;
+    config.addString("parallel_option","mono");
+    config.addInt("nb_slots",1);
+
+    vv::Map init;
+    init.addString("package","test_manager");
+    init.addString("vpz","ExBohachevsky.vpz");
+    init.add("input_cond.x1", x1.clone());
+    init.add("input_cond.x2", x2.clone());
+    init.add("input_cond.seed", seedsPlan.clone());
+    init.addString("output_ynoise",
+            "view/ExBohachevsky:ExBohachevsky.y_noise");
+
+    auto ctx = vle::utils::make_context();
+    vm::Manager manager(ctx, config);
+
+    vle::manager::Error err;
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<vv::Map> res = manager.runPlan(init, err);
+    double planTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+    if (err.code ==-1) {
+        std::cout << " error: " << err.message << "\n";
+    }
+    Ensures(res->getTable("ynoise").width() == size);
+
+    start = std::chrono::steady_clock::now();
+    vle::recursive::test::WarmStart warm(ctx, "test_manager",
+            "ExBohachevsky.vpz");
+    vv::Map inputs;
+    inputs.add("cond.x1", x1.clone());
+    inputs.add("cond.x2", x2.clone());
+    inputs.add("cond.seed", seeds.clone());
+
+    vle::manager::Error error;
+    std::unique_ptr<vv::Map> out = warm.run(inputs, size, &error);
+    double warmTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    EnsuresEqual(error.code, 0);
+    Ensures(out != nullptr);
+    if (not out) {
+        return;
+    }
+
+    //viewNoise is a timed view of y_noise with a timestep of 1
+    std::vector<double> ynoise = vle::recursive::test::WarmStart::perRun(
+            out->getMatrix("viewNoise"),
+            "ExBohachevsky:ExBohachevsky.y_noise", size);
+    EnsuresEqual(ynoise.size(), size);
+    for (unsigned int i = 0; i < size; ++i) {
+        EnsuresApproximatelyEqual(ynoise[i],
+                res->getTable("ynoise")(i, 0), 10e-6);
+    }
+
+    std::cout << " runPlan: " << planTime << "s, warm start: "
+              << warmTime << "s for " << size << " runs\n";
+}
+
+int main()
+{
+    test_warm_start_ExBohachevsky();
+
+    return unit_test::report_errors();
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2014-2014 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_TEST_MANAGER_WARM_START_HPP
+#define VLE_TEST_MANAGER_WARM_START_HPP 1
+
+#include <vle/version.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/manager/Simulation.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace recursive {
+namespace test {
+
+/**
+ * @brief Runs many combinations of one vpz in a single simulation, so
+ * that the vpz, the coupled model and the dynamics are built once per
+ * worker instead of once per combination as with
+ * vle::manager::Manager::runPlan.
+ *
+ * The dynamics of the vpz have to provide a reset hook (see
+ * src/ExBohachevsky.cpp): their condition gets a port "warm_start_runs"
+ * (n) and each input port a tuple of n values. The run k is observed at
+ * time k and the models reset their state to the run k at time k - 0.5.
+ *
+ * A worker (a thread or a rank) owns one WarmStart.
+ */
+class WarmStart
+{
+public:
+    WarmStart(vle::utils::ContextPtr ctx, const std::string& package,
+              const std::string& vpz)
+        : mCtx(ctx)
+    {
+        vle::utils::Package pack(mCtx, package);
+        mVpz.reset(new vle::vpz::Vpz(
+                pack.getExpFile(vpz, vle::utils::PKG_BINARY)));
+
+        vle::vpz::Outputs::iterator itb =
+            mVpz->project().experiment().views().outputs().begin();
+        vle::vpz::Outputs::iterator ite =
+            mVpz->project().experiment().views().outputs().end();
+        for (; itb != ite; itb++) {
+            std::unique_ptr<vle::value::Map> configOutput(
+                    new vle::value::Map());
+            configOutput->addString("header","top");
+            vle::vpz::Output& output = itb->second;
+            output.setStream("", "storage", "vle.output");
+            output.setData(std::move(configOutput));
+        }
+    }
+
+    /**
+     * @brief Simulates 'runs' combinations in one simulation.
+     * @param inputs, a map "cond.port" -> tuple of 'runs' values
+     * @param runs, the number of combinations (> 0)
+     * @return the views or a null pointer on error.
+     */
+    std::unique_ptr<vle::value::Map> run(const vle::value::Map& inputs,
+            unsigned int runs, vle::manager::Error* error)
+    {
+        std::unique_ptr<vle::vpz::Vpz> vpz(new vle::vpz::Vpz(*mVpz));
+        vle::vpz::Conditions& conds =
+            vpz->project().experiment().conditions();
+
+        for (const auto& in : inputs) {
+            std::string::size_type dot = in.first.find('.');
+            vle::vpz::Condition& cond = conds.get(in.first.substr(0, dot));
+            cond.setValueToPort(in.first.substr(dot + 1),
+                    in.second->clone());
+            cond.add("warm_start_runs");
+            cond.setValueToPort("warm_start_runs",
+                    vle::value::Integer::create(runs));
+        }
+        conds.get("simulation_engine").setValueToPort("duration",
+                vle::value::Double::create(runs - 0.5));
+
+#if VLE_VERSION >= 200100
+        vle::manager::Simulation sim(mCtx, vle::manager::SIMULATION_NONE,
+                std::chrono::milliseconds(0));
+#else
+        vle::manager::Simulation sim(mCtx, vle::manager::LOG_NONE,
+                vle::manager::SIMULATION_NONE,
+                std::chrono::milliseconds(0), &std::cout);
+#endif
+        return sim.run(std::move(vpz), error);
+    }
+
+    /**
+     * @brief Values of a column of a timed view for each run, i.e. at
+     * the times 0, 1, ..., runs - 1.
+     */
+    static std::vector<double> perRun(const vle::value::Matrix& view,
+            const std::string& header, unsigned int runs)
+    {
+        std::vector<double> res(runs,
+                std::numeric_limits<double>::quiet_NaN());
+        for (unsigned int j = 1; j < view.columns(); j++) {
+            if (view.getString(j, 0) != header) {
+                continue;
+            }
+            for (unsigned int i = 1; i < view.rows(); i++) {
+                double t = view.getDouble(0, i);
+                if (t == std::floor(t) and t >= 0 and t < runs) {
+                    res[static_cast<unsigned int>(t)] = view.getDouble(j, i);
+                }
+            }
+        }
+        return res;
+    }
+
+private:
+    vle::utils::ContextPtr mCtx;
+    std::unique_ptr<vle::vpz::Vpz> mVpz;
+};
+
+}}} // namespaces
+
+#endif
@@ -67,6 +67,11 @@ typedef strings_t::iterator strings_it;
  * - dyn_allow (boolean) (mandatory) : set to true (mandatory value by convention)
  *   enables an automatic management of variables
  * - PlansLocation (string) : the package name where to find plan files
+ * - archive_activities (boolean) : archive the activities that can no
+ *   longer change to bound the cost of long simulations (default false)
+ * - archive_capacity (integer) : number of records of archived activities
+ *   kept, the older ones are only counted (default 1024). The
+ *   AchievedPlan port lists the activities whose record is kept.
  *
  * The rotation map stores define where an when to load plans
  * The key of the map is used as a location.
@@ -635,18 +640,20 @@ ack_plan(const std::string&activityname,
 
 void manageDeadlines()
 {
-    for (auto activity : activities()) {
-        if (activity.second.isInWaitState() &&
-            activity.second.params().exist("_deadline")) {
+    ved::Activities& acts = plan().activities();
+    for (ved::Activities::iterator activity = acts.begin();
+         activity != acts.end(); ++activity) {
+        if (activity->second.isInWaitState() &&
+            activity->second.params().exist("_deadline")) {
             bool deadlineToAdd = true;
-            for (ved::Rules::const_iterator it = activity.second.getRules().begin();
-                 it !=  activity.second.getRules().end(); ++it) {
+            for (ved::Rules::const_iterator it = activity->second.getRules().begin();
+                 it !=  activity->second.getRules().end(); ++it) {
                 if (it->first == "rDeadline") {
                     deadlineToAdd = false;
                 }
             }
             if (deadlineToAdd) {
-                plan().activities().get(activity.first)->second.addRule("rDeadline", KnowledgeBase::rules().get("rDeadline"));
+                activity->second.addRule("rDeadline", KnowledgeBase::rules().get("rDeadline"));
             }
         }
     }
@@ -675,7 +682,10 @@ void loadPlan(const std::string& activityname,
                     filePath = getPackageDataFile(*jt + ".txt");
                 }
 
-                std::ifstream fileStream(filePath.c_str());
+                if (not library().existTemplate(filePath)) {
+                    std::ifstream fileStream(filePath.c_str());
+                    library().addTemplate(filePath, fileStream);
+                }
 
                 int counter = mPlanPerLocationCounter.find(it->first)->second++;
                 std::stringstream ss;
@@ -687,7 +697,8 @@ void loadPlan(const std::string& activityname,
                     suf = "@" + it->first + ":" + ss.str();
                 }
 
-                KnowledgeBase::plan().fill(fileStream, current_date, suf);
+                KnowledgeBase::plan().instantiate(
+                    library().getTemplate(filePath), current_date, suf);
                 manageDeadlines();
             }
         }
@@ -1007,6 +1018,17 @@ std::string getShortDate(const vd::Time& time) const
     }
 }
 
+void writeAchieved(std::stringstream& out, const std::string& name,
+                   const vd::Time& started, const vd::Time& done) const
+{
+    if (name.find("_reset_") == std::string::npos) {
+        out << name << ";"
+            << getLocationName(name) << ";"
+            << getShortDate(started) << ";"
+            << getShortDate(done) << std::endl;
+    }
+}
+
 std::unique_ptr<vle::value::Value>
 observation(const devs::ObservationEvent& event) const
 {
@@ -1014,16 +1036,27 @@ observation(const devs::ObservationEvent& event) const
     const std::string port = event.getPortName();
     if (port == "AchievedPlan") {
         std::stringstream out;
-        ved::Activities::const_iterator activity;
-        for (activity = activities().begin();
-             activity != activities().end(); ++activity) {
-            const ved::Activity& act(activity->second);
-            std::size_t found = activity->first.find("_reset_");
-            if (act.isInDoneState() && found == std::string::npos) {
-                out << activity->first  << ";"
-                    << getLocationName(activity->first) << ";"
-                    << getShortDate(act.startedDate()) << ";"
-                    << getShortDate(act.doneDate()) << std::endl;
+        ved::Activities::const_iterator activity = activities().begin();
+        ved::Activities::archived_t::const_iterator archived =
+            activities().archived().begin();
+        while (activity != activities().end() or
+               archived != activities().archived().end()) {
+            if (archived == activities().archived().end() or
+                (activity != activities().end() and
+                 activity->first < archived->first)) {
+                const ved::Activity& act(activity->second);
+                if (act.isInDoneState()) {
+                    writeAchieved(out, activity->first, act.startedDate(),
+                                  act.doneDate());
+                }
+                ++activity;
+            } else {
+                if (archived->second.state == ved::Activity::DONE) {
+                    writeAchieved(out, archived->first,
+                                  archived->second.started,
+                                  archived->second.done);
+                }
+                ++archived;
             }
         }
         return std::unique_ptr<vle::value::Value>(new value::String(out.str()));
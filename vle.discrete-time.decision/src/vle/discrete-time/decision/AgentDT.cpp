@@ -23,6 +23,7 @@
 
 
 #include <vle/discrete-time/decision/AgentDT.hpp>
+#include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/DateTime.hpp>
@@ -37,7 +38,8 @@ namespace decision {
 AgentDT::AgentDT(const devs::DynamicsInit& mdl,
       const devs::InitEventList& events)
     : DiscreteTimeDyn(mdl, events), KnowledgeBase(context()),
-      mdefaultValues(), begin_date(), current_date()
+      mdefaultValues(), begin_date(), current_date(),
+      archive_activities(false)
 {
     if (!(events.exist("begin_date") &&
             events.get("begin_date")->isString())) {
@@ -50,6 +52,20 @@ AgentDT::AgentDT(const devs::DynamicsInit& mdl,
             events.getString("begin_date"));
     current_date = begin_date;
 
+    if (events.exist("archive_activities")) {
+        archive_activities = events.getBoolean("archive_activities");
+    }
+
+    if (events.exist("archive_capacity")) {
+        int capacity = events.getInt("archive_capacity");
+        if (capacity < 0) {
+            throw vle::utils::FileError(
+                vle::utils::format("[%s] archive_capacity must be >= 0",
+                        getModelName().c_str()));
+        }
+        KnowledgeBase::setArchiveCapacity(capacity);
+    }
+
     if (! events.exist("output_nil")) {
         global_output_nils(true);
     }
@@ -95,6 +111,10 @@ AgentDT::compute(const vle::devs::Time& t)
 
     KnowledgeBase::Result mNextChangeTime = KnowledgeBase::processChanges(current_date);
 
+    if (archive_activities) {
+        KnowledgeBase::archiveActivities();
+    }
+
     Variables&  vars = getVariables();
     Variables::const_iterator itb = vars.begin();
     Variables::const_iterator ite = vars.end();
@@ -128,57 +148,11 @@ AgentDT::outputVar(const vle::vpz::AtomicModel& model,
 {
     current_date = begin_date + time;
 
-    struct classcomp {
-        bool operator() (ActivityList::const_iterator lhs,
-                         ActivityList::const_iterator rhs) const
-        {return (*lhs)->first < (*rhs)->first;}
-    };
-
-    std::set <ActivityList::const_iterator, classcomp> outputList;
-    {
-        const ActivityList& lst = latestWaitedActivities();
-        ActivityList::const_iterator it = lst.begin();
-        for (; it != lst.end(); ++it) {
-            outputList.insert(it);
-        }
-    }
-    {
-        const ActivityList& lst = latestStartedActivities();
-        ActivityList::const_iterator it = lst.begin();
-        for (; it != lst.end(); ++it) {
-            outputList.insert(it);
-
-        }
-    }
-    {
-        const ActivityList& lst = latestFailedActivities();
-        ActivityList::const_iterator it = lst.begin();
-        for (; it != lst.end(); ++it) {
-            outputList.insert(it);
-        }
+    const ActivityList& lst = latestChangedActivities();
+    ActivityList::const_iterator it = lst.begin();
+    for (; it != lst.end(); ++it) {
+        (*it)->second.output((*it)->first, output);
     }
-    {
-        const ActivityList& lst = latestDoneActivities();
-        ActivityList::const_iterator it = lst.begin();
-        for (; it != lst.end(); ++it) {
-            outputList.insert(it);
-
-        }
-    }
-    {
-        const ActivityList& lst = latestEndedActivities();
-        ActivityList::const_iterator it = lst.begin();
-        for (; it != lst.end(); ++it) {
-            outputList.insert(it);
-        }
-    }
-
-    std::set <ActivityList::const_iterator, classcomp>::const_iterator it =
-        outputList.begin();
-    for (; it != outputList.end(); ++it) {
-        (*(*it))->second.output((*(*it))->first, output);
-    }
-
 
     DiscreteTimeDyn::outputVar(model, time, output);
 }
@@ -209,12 +183,15 @@ AgentDT::handleExtEvt(const vle::devs::Time& t,
             }
         } else {
             DiscreteTimeDyn::handleExtVar(t, port, *(it->attributes()));
+            KnowledgeBase::invalidatePredicates();
         }
     }
+    const vdec::FactsTable& facts =
+        static_cast < const vdec::KnowledgeBase& >(*this).facts();
     for (devs::ExternalEventList::const_iterator it = ext.begin();
              it != ext.end(); ++it) {
         const std::string& port(it->getPortName());
-        if (KnowledgeBase::facts().exist(port)) {
+        if (facts.exist(port)) {
             applyFact(port, *it->attributes());
         }
     }
@@ -237,11 +214,30 @@ AgentDT::observation(const devs::ObservationEvent& event) const
         out << activities();
         return std::unique_ptr<vle::value::Value>(
                 new value::String(out.str()));
+    } else if (port == "Activities(table)") {
+        return activitiesTable(event.getViewName(), false);
+    } else if (port == "Activities(changed)") {
+        return activitiesTable(event.getViewName(), true);
+    } else if (port == "Activities(names)") {
+        std::unique_ptr<value::Set> names(new value::Set());
+        for (const auto& name : activitiesObserver().names()) {
+            names->addString(name);
+        }
+        return std::move(names);
+    } else if ((port.compare(0, 16, "Activity(tuple)_") == 0) and port.size() > 16) {
+        std::string activity(port, 16, std::string::npos);
+        std::unique_ptr<value::Tuple> tuple(activityTuple(activity));
+        if (tuple) {
+            return std::move(tuple);
+        }
     } else if ((port.compare(0, 9, "Activity_") == 0) and port.size() > 9) {
         std::string activity(port, 9, std::string::npos);
-        const vdec::Activity& act(activities().get(activity)->second);
         std::stringstream out;
-        out << act.state();
+        if (activities().isArchived(activity)) {
+            out << activities().archived().find(activity)->second.state;
+        } else {
+            out << activities().get(activity)->second.state();
+        }
         return std::unique_ptr<vle::value::Value>(new value::String(out.str()));
     } else if ((port.compare(0, 16, "Activity(state)_") == 0) and port.size() > 16) {
         std::string activity(port, 16, std::string::npos);
@@ -251,6 +247,11 @@ AgentDT::observation(const devs::ObservationEvent& event) const
             out << act.state();
             return std::unique_ptr<vle::value::Value>(
                 new value::String(out.str()));
+        } else if (activities().isArchived(activity)) {
+            std::stringstream out;
+            out << activities().archived().find(activity)->second.state;
+            return std::unique_ptr<vle::value::Value>(
+                new value::String(out.str()));
         }
     } else if ((port.compare(0, 20, "Activity(resources)_") == 0) and port.size() > 20) {
         std::string activity(port, 20, std::string::npos);
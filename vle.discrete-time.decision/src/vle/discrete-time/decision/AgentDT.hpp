@@ -63,6 +63,8 @@ public:
     vle::value::Map mdefaultValues;
     int begin_date;
     int current_date;
+    bool archive_activities; /**< archive the activities that can no
+                                longer change after each step. */
 };
 
 }}} // namespace vle ext decision
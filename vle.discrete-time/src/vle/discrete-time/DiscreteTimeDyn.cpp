@@ -36,7 +36,8 @@ DiscreteTimeDyn::DiscreteTimeDyn(
         const vle::devs::InitEventList& events):
         vle::devs::Dynamics(model, events),
         TemporalValuesProvider(this->getModelName(), events),
-        mpimpl(new Pimpl(static_cast<TemporalValuesProvider&>(*this), events))
+        mpimpl(new Pimpl(static_cast<TemporalValuesProvider&>(*this),
+                getModel().getParent(), events))
 
 {
 }
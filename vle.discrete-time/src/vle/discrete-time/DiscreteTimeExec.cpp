@@ -36,13 +36,15 @@ DiscreteTimeExec::DiscreteTimeExec(
         const vle::devs::InitEventList& events):
         vle::devs::Executive(model, events),
         TemporalValuesProvider(this->getModelName(), events),
-        mpimpl(new Pimpl(static_cast<TemporalValuesProvider&>(*this), events))
+        mpimpl(new Pimpl(static_cast<TemporalValuesProvider&>(*this),
+                getModel().getParent(), events))
 
 {
 }
 
 DiscreteTimeExec::~DiscreteTimeExec()
 {
+    unregisterTemplates(mpimpl->devs_scope);
     delete mpimpl;
 }
 
@@ -138,6 +140,19 @@ DiscreteTimeExec::getOptions()
     return mpimpl->getOptions();
 }
 
+void
+DiscreteTimeExec::registerTemplate(const std::string& name,
+        const vle::devs::InitEventList& events)
+{
+    vle::discrete_time::registerTemplate(mpimpl->devs_scope, name, events);
+}
+
+void
+DiscreteTimeExec::unregisterTemplate(const std::string& name)
+{
+    vle::discrete_time::unregisterTemplate(mpimpl->devs_scope, name);
+}
+
 
 
  void
@@ -77,6 +77,16 @@ public:
     bool firstCompute() const;
     DEVS_Options& getOptions();
 
+    /**
+     * @brief Register initialization values shared by the models this
+     * executive creates (see the free registerTemplate). The template is
+     * only visible to the models of the coupled model of this executive
+     * and is removed with the executive.
+     */
+    void registerTemplate(const std::string& name,
+            const vle::devs::InitEventList& events);
+    void unregisterTemplate(const std::string& name);
+
     /*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
     //////////////////////
     //DEVS implementation
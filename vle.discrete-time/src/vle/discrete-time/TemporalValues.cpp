@@ -165,7 +165,7 @@ VarInterface::initHistoryVar(const std::string& varName,
 {
     switch (getType()) {
     case MONO: {
-        VarMono* itVar = dynamic_cast<VarMono*>(this);
+        VarMono* itVar = static_cast<VarMono*>(this);
         if (itVar->init_value) {
             if (itVar->init_value->isTuple()) {
                 const vle::value::Tuple& tuple =
@@ -203,7 +203,7 @@ VarInterface::initHistoryVar(const std::string& varName,
         }
         break;
     } case MULTI: {
-        VarMulti* itVar = dynamic_cast<VarMulti*>(this);
+        VarMulti* itVar = static_cast<VarMulti*>(this);
         if (itVar->init_value) {
             if (itVar->init_value->isTuple()) {
                 const vle::value::Tuple& tuple = itVar->init_value->toTuple();
@@ -239,7 +239,7 @@ VarInterface::initHistoryVar(const std::string& varName,
         }
         break;
     } case VALUE_VLE: {
-        VarValue* itVar = dynamic_cast<VarValue*>(this);
+        VarValue* itVar = static_cast<VarValue*>(this);
         if (itVar->init_value) {
             for (unsigned int h = 0; h < itVar->history_size ; h++) {
                 itVar->history.push_front(
@@ -704,8 +704,7 @@ void
 Var::init(TemporalValuesProvider* tvpin, const std::string& varName,
         const devs::InitEventList& initMap)
 {
-    devs::InitEventList::const_iterator ite = initMap.end();
-    devs::InitEventList::const_iterator itf = ite;
+    const vle::value::Value* init = 0;
     std::string port;
 
     name.assign(varName);
@@ -717,41 +716,42 @@ Var::init(TemporalValuesProvider* tvpin, const std::string& varName,
                 "already declared \n",
                 tvpin->get_model_name().c_str(),  name.c_str()));
     }
-    itVar = dynamic_cast<VarMono*>(resInsert.first->second);
+    itVar = static_cast<VarMono*>(resInsert.first->second);
+    tvpin->indexVar(resInsert.first->first, itVar);
 
     port.assign("error_no_sync_");
     port += name;
-    itf = initMap.find(port);
-    if (itf != ite) {
-        itVar->error_no_sync = itf->second->toBoolean().value();
+    init = tvpin->getInit(initMap, port);
+    if (init) {
+        itVar->error_no_sync = init->toBoolean().value();
     } else {
         itVar->error_no_sync = false;//Default
     }
 
     port.assign("keep_first_value_");
     port += name;
-    itf = initMap.find(port);
-    if (itf != ite) {
-        itVar->allow_update = itf->second->toBoolean().value();
+    init = tvpin->getInit(initMap, port);
+    if (init) {
+        itVar->allow_update = init->toBoolean().value();
     } else {
         itVar->allow_update = false;//Default
     }
 
     port.assign("history_size_");
     port += name;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->history_size = 3;
     itVar->history_size_given = false;
-    if (itf != ite) {
-        itVar->history_size = itf->second->toInteger().value();
+    if (init) {
+        itVar->history_size = init->toInteger().value();
         itVar->history_size_given = true;
     }
 
     port.assign("init_value_");
     port += name;
-    itf = initMap.find(port);
-    if (itf != ite) {
-        itVar->init_value = itf->second->clone();
+    init = tvpin->getInit(initMap, port);
+    if (init) {
+        itVar->init_value = init->clone();
     }
 
 }
@@ -902,18 +902,17 @@ void
 Vect::init(TemporalValuesProvider* tvpin, const std::string& varName,
         const devs::InitEventList& initMap)
 {
-    devs::InitEventList::const_iterator ite = initMap.end();
-    devs::InitEventList::const_iterator itf = ite;
+    const vle::value::Value* init = 0;
     std::string port;
 
     name.assign(varName);
 
     port.assign("dim_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     unsigned int dim = 2;//Default
-    if (itf != ite) {
-        dim = itf->second->toInteger().value();
+    if (init) {
+        dim = init->toInteger().value();
     }
 
     std::pair<Variables::iterator, bool> resInsert =
@@ -924,31 +923,32 @@ Vect::init(TemporalValuesProvider* tvpin, const std::string& varName,
                 "already declared \n", tvpin->get_model_name().c_str(),
                 name.c_str()));
     }
-    itVar = dynamic_cast<VarMulti*>(resInsert.first->second);
+    itVar = static_cast<VarMulti*>(resInsert.first->second);
+    tvpin->indexVar(resInsert.first->first, itVar);
     itVar->dim = dim;
 
     port.assign("error_no_sync_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->error_no_sync = false;
-    if (itf != ite) {
-        itVar->error_no_sync = itf->second->toBoolean().value();
+    if (init) {
+        itVar->error_no_sync = init->toBoolean().value();
     }
 
     port.assign("allow_update_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->allow_update = false; //Default
-    if (itf != ite) {
-        itVar->allow_update = itf->second->toBoolean().value();
+    if (init) {
+        itVar->allow_update = init->toBoolean().value();
     }
 
     port.assign("init_value_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->init_value  = 0;
-    if (itf != ite) {
-        itVar->init_value = itf->second->clone();
+    if (init) {
+        itVar->init_value = init->clone();
     }
 }
 
@@ -961,13 +961,13 @@ Vect::history_size(unsigned int s)
 void
 Vect::dim(unsigned int s)
 {
-    dynamic_cast<VarMulti*>(itVar)->dim = s;
+    itVar->dim = s;
 }
 
 unsigned int
 Vect::dim() const
 {
-    return dynamic_cast<const VarMulti*>(itVar)->dim;
+    return itVar->dim;
 }
 
 Vect_i
@@ -1001,8 +1001,7 @@ void
 ValueVle::init(TemporalValuesProvider* tvpin, const std::string& varName,
         const devs::InitEventList& initMap)
 {
-    devs::InitEventList::const_iterator ite = initMap.end();
-    devs::InitEventList::const_iterator itf = ite;
+    const vle::value::Value* init = 0;
     std::string port;
 
     name.assign(varName);
@@ -1015,40 +1014,41 @@ ValueVle::init(TemporalValuesProvider* tvpin, const std::string& varName,
                 "already declared \n", tvpin->get_model_name().c_str(),
                 name.c_str()));
     }
-    itVar = dynamic_cast<VarValue*>(resInsert.first->second);
+    itVar = static_cast<VarValue*>(resInsert.first->second);
+    tvpin->indexVar(resInsert.first->first, itVar);
 
     port.assign("history_size_");
     port += name;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->history_size = 3;//Default
     itVar->history_size_given = false;
-    if (itf != ite) {
-        itVar->history_size = itf->second->toInteger().value();
+    if (init) {
+        itVar->history_size = init->toInteger().value();
         itVar->history_size_given = true;
     }
 
     port.assign("init_value_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->init_value  = 0;
-    if (itf != ite) {
-        itVar->init_value = itf->second->clone();
+    if (init) {
+        itVar->init_value = init->clone();
     }
 
     port.assign("error_no_sync_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->error_no_sync = false;
-    if (itf != ite) {
-        itVar->error_no_sync = itf->second->toBoolean().value();
+    if (init) {
+        itVar->error_no_sync = init->toBoolean().value();
     }
 
     port.assign("allow_update_");
     port += varName;
-    itf = initMap.find(port);
+    init = tvpin->getInit(initMap, port);
     itVar->allow_update = false; //Default
-    if (itf != ite) {
-        itVar->allow_update = itf->second->toBoolean().value();
+    if (init) {
+        itVar->allow_update = init->toBoolean().value();
     }
 
 }
@@ -1056,7 +1056,7 @@ ValueVle::init(TemporalValuesProvider* tvpin, const std::string& varName,
 void
 ValueVle::history_size(unsigned int s)
 {
-    dynamic_cast<VarValue*>(itVar)->history_size = s;
+    itVar->history_size = s;
 }
 
 const vle::value::Value&
@@ -1088,13 +1088,15 @@ ValueVle::operator=(const vle::value::Value& val)
 
 
 TemporalValuesProvider::TemporalValuesProvider():
-        model_name("unknown"), variables(), current_time(0), delta(1)
+        model_name("unknown"), variables(), monos(), multis(), values(),
+        current_time(0), delta(1)
 {
 }
 
 TemporalValuesProvider::TemporalValuesProvider(const std::string& modelname,
         const vle::devs::InitEventList& initMap):
-        model_name(modelname), variables(), current_time(0), delta(1.0)
+        model_name(modelname), variables(), monos(), multis(), values(),
+        current_time(0), delta(1.0)
 {
     auto itf = initMap.find("time_step");
     auto ite = initMap.end();
@@ -1103,6 +1105,37 @@ TemporalValuesProvider::TemporalValuesProvider(const std::string& modelname,
     }
 }
 
+void
+TemporalValuesProvider::setSharedInit(
+        std::shared_ptr<const vle::value::Map> shared,
+        const vle::devs::InitEventList& initMap)
+{
+    shared_init = shared;
+    if (initMap.find("time_step") == initMap.end()) {
+        auto itf = shared_init->find("time_step");
+        if (itf != shared_init->end()) {
+            delta = itf->second->toDouble().value();
+        }
+    }
+}
+
+const vle::value::Value*
+TemporalValuesProvider::getInit(const vle::devs::InitEventList& initMap,
+        const std::string& key) const
+{
+    auto itf = initMap.find(key);
+    if (itf != initMap.end()) {
+        return itf->second.get();
+    }
+    if (shared_init) {
+        auto its = shared_init->find(key);
+        if (its != shared_init->end()) {
+            return its->second.get();
+        }
+    }
+    return 0;
+}
+
 TemporalValuesProvider::~TemporalValuesProvider()
 {
     Variables::iterator itb = variables.begin();
@@ -1125,38 +1158,47 @@ TemporalValuesProvider::initHistory(const vle::devs::Time& t)
 void
 TemporalValuesProvider::snapshot(SNAPSHOT_ID idSnap)
 {
-    Variables::iterator itb = variables.begin();
-    Variables::iterator ite = variables.end();
-    for (; itb != ite; itb++) {
-        switch(itb->second->getType()) {
-        case MONO: {
-            VarMono* itv = dynamic_cast<VarMono*>(itb->second);
-            if (itv->history.size() == 0){
-                throw vle::utils::ModellingError(
-                        vu::format("[%s] Error snapshot of variable '%s'"
-                                " (maybe you forgot to call initHistory)\n",
-                                get_model_name().c_str(), itb->first.c_str()));
-            }
-            itv->addSnapshot(idSnap, itv->history.back()->value);
-            break;
-        } case MULTI: {
-            VarMulti* itv = dynamic_cast<VarMulti*>(itb->second);
-            if (itv->history.size() == 0){
-                throw vle::utils::ModellingError(
-                        vu::format("[%s] Error snapshot of variable '%s'"
-                                " (maybe you forgot to call initHistory)\n",
-                                get_model_name().c_str(), itb->first.c_str()));
-            }
-            itv->addSnapshot(idSnap, itv->history.back()->value);
-            break;
-        } case VALUE_VLE: {
-            VarValue* itv = dynamic_cast<VarValue*>(itb->second);
-            itv->addSnapshot(idSnap, *(itv->history.back()->value));
-            break;
-        }}
+    for (auto& m : monos) {
+        if (m.second->history.size() == 0){
+            throw vle::utils::ModellingError(
+                    vu::format("[%s] Error snapshot of variable '%s'"
+                            " (maybe you forgot to call initHistory)\n",
+                            get_model_name().c_str(), m.first->c_str()));
+        }
+        m.second->addSnapshot(idSnap, m.second->history.back()->value);
+    }
+    for (auto& m : multis) {
+        if (m.second->history.size() == 0){
+            throw vle::utils::ModellingError(
+                    vu::format("[%s] Error snapshot of variable '%s'"
+                            " (maybe you forgot to call initHistory)\n",
+                            get_model_name().c_str(), m.first->c_str()));
+        }
+        m.second->addSnapshot(idSnap, m.second->history.back()->value);
+    }
+    for (auto& m : values) {
+        m.second->addSnapshot(idSnap, *(m.second->history.back()->value));
     }
 }
 
+void
+TemporalValuesProvider::indexVar(const std::string& name, VarMono* v)
+{
+    monos.emplace_back(&name, v);
+}
+
+void
+TemporalValuesProvider::indexVar(const std::string& name, VarMulti* v)
+{
+    multis.emplace_back(&name, v);
+}
+
+void
+TemporalValuesProvider::indexVar(const std::string& name, VarValue* v)
+{
+    values.emplace_back(&name, v);
+}
+
 unsigned int
 TemporalValuesProvider::dim(const Vect& v) const
 {
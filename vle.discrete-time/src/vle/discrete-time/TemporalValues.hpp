@@ -29,6 +29,7 @@
 #include <vector>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <vle/devs/Time.hpp>
 #include <vle/devs/InitEventList.hpp>
 #include <vle/value/Value.hpp>
@@ -310,11 +311,47 @@ public:
      void setCurrentTime(const vle::devs::Time& t);
      std::string getVarName(VarInterface* v);
 
+     /**
+      * @brief Set the initialization values shared by all the instances
+      * of a template (see DiscreteTimeExec::registerTemplate).
+      * @param shared the initialization values of the template.
+      * @param initMap the initialization values of this instance, which
+      * override the shared ones.
+      */
+     void setSharedInit(std::shared_ptr<const vle::value::Map> shared,
+             const vle::devs::InitEventList& initMap);
+
+     /**
+      * @brief Get an initialization value from the instance values or,
+      * if missing, from the shared values.
+      * @return the value or a null pointer.
+      */
+     const vle::value::Value* getInit(const vle::devs::InitEventList& initMap,
+             const std::string& key) const;
+
+     /**
+      * @brief Register a declared variable in the per-type index, so that
+      * snapshot() runs without dispatching on the variable type. Every
+      * insertion into the Variables map (Var/Vect/ValueVle::init and the
+      * dyn_allow variables) must be followed by a call to indexVar.
+      * @param name the key of the variable into the Variables map: the
+      * index keeps its address, so the entry must never be erased from
+      * the map (variables are only deleted with the provider).
+      * @param v the variable.
+      */
+     void indexVar(const std::string& name, VarMono* v);
+     void indexVar(const std::string& name, VarMulti* v);
+     void indexVar(const std::string& name, VarValue* v);
+
 private:
      std::string model_name;
      Variables variables;
+     std::vector<std::pair<const std::string*, VarMono*>> monos;
+     std::vector<std::pair<const std::string*, VarMulti*>> multis;
+     std::vector<std::pair<const std::string*, VarValue*>> values;
      vle::devs::Time current_time;
      double delta;
+     std::shared_ptr<const vle::value::Map> shared_init;
 
 };
 
@@ -27,6 +27,7 @@
 #include <vle/devs/Executive.hpp>
 #include <vle/discrete-time/TemporalValues.hpp>
 #include <vle/discrete-time/details/DiscreteTimeGen.hpp>
+#include <mutex>
 
 
 namespace vle {
@@ -36,12 +37,93 @@ namespace vu = vle::utils;
 namespace vz = vle::vpz;
 
 
+typedef std::map<std::string, std::shared_ptr<const DiscreteTimeTemplate>>
+    DiscreteTimeTemplates;
+
+//templates by coupled model of the executive that registered them
+static std::mutex templates_mutex;
+static std::map<const vz::CoupledModel*, DiscreteTimeTemplates> templates;
+
+void
+registerTemplate(const vz::CoupledModel* scope, const std::string& name,
+        const vle::devs::InitEventList& events)
+{
+    std::shared_ptr<DiscreteTimeTemplate> tpl(new DiscreteTimeTemplate());
+    tpl->events.reset(new vle::value::Map(events));
+    {
+        TemporalValuesProvider tvp(name, events);
+        Pimpl parser(tvp, scope, events);
+        tpl->options.assign(parser.devs_options);
+    }
+
+    std::lock_guard<std::mutex> lock(templates_mutex);
+    templates[scope][name] = tpl;
+}
+
+void
+unregisterTemplate(const vz::CoupledModel* scope, const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(templates_mutex);
+    auto its = templates.find(scope);
+    if (its != templates.end()) {
+        its->second.erase(name);
+        if (its->second.empty()) {
+            templates.erase(its);
+        }
+    }
+}
+
+void
+unregisterTemplates(const vz::CoupledModel* scope)
+{
+    std::lock_guard<std::mutex> lock(templates_mutex);
+    templates.erase(scope);
+}
+
+static std::shared_ptr<const DiscreteTimeTemplate>
+findTemplate(const vz::CoupledModel* scope, const std::string& model_name,
+        const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(templates_mutex);
+    auto its = templates.find(scope);
+    if (its != templates.end()) {
+        DiscreteTimeTemplates::const_iterator itf = its->second.find(name);
+        if (itf != its->second.end()) {
+            return itf->second;
+        }
+    }
+    throw vu::ArgError(vu::format("[%s] unknown dt_template '%s'",
+            model_name.c_str(), name.c_str()));
+}
+
 Pimpl::Pimpl(TemporalValuesProvider& tempvp,
+        const vle::vpz::CoupledModel* scope,
         const vle::devs::InitEventList&  events):
                 tvp(tempvp), devs_state(INIT), devs_options(), devs_guards(),
                 devs_internal(), mfirstCompute(true), declarationOn(true),
-                currentTimeStep(0), devs_atom(0)
+                currentTimeStep(0), devs_atom(0), devs_scope(scope)
 {
+    vle::devs::InitEventList::const_iterator itf = events.find("dt_template");
+    if (itf != events.end()) {
+        std::shared_ptr<const DiscreteTimeTemplate> tpl = findTemplate(devs_scope,
+                tvp.get_model_name(), itf->second->toString().value());
+        devs_options.assign(tpl->options);
+        tvp.setSharedInit(tpl->events, events);
+
+        //the values of the instance override those of the template
+        vle::devs::InitEventList::const_iterator itb = events.begin();
+        vle::devs::InitEventList::const_iterator ite = events.end();
+        for (; itb != ite; itb++) {
+            const std::string& event_name = itb->first;
+            if (!event_name.compare(0, 5, "sync_")) {
+                devs_options.syncs.erase(event_name.substr(5));
+            } else if (!event_name.compare(0, 11, "output_nil_")) {
+                devs_options.outputNils.erase(event_name.substr(11));
+            } else if (!event_name.compare(0, 14, "output_period_")) {
+                devs_options.outputPeriods.erase(event_name.substr(14));
+            }
+        }
+    }
     initializeFromInitEventList(events);
 }
 
@@ -512,7 +594,19 @@ Pimpl::updateDynState(const vle::devs::Time& t)
                                                  sync));
         v->init_value = devs_options.dyn_init_value->clone();
 
-        current_vars.insert(std::make_pair(vname, v));
+        const std::string& key =
+            current_vars.insert(std::make_pair(vname, v)).first->first;
+        switch (devs_options.dyn_type) {
+        case MONO:
+            tvp.indexVar(key, static_cast<VarMono*>(v));
+            break;
+        case MULTI:
+            tvp.indexVar(key, static_cast<VarMulti*>(v));
+            break;
+        case VALUE_VLE:
+            tvp.indexVar(key, static_cast<VarValue*>(v));
+            break;
+        }
         v->initHistoryVar(vname, t);
     }
     //remove variables
@@ -986,6 +1080,56 @@ DEVS_Options::~DEVS_Options()
     dyn_init_value.reset();
 }
 
+void
+DEVS_Options::assign(const DEVS_Options& other)
+{
+    bags_to_eat = other.bags_to_eat;
+    dt = other.dt;
+    syncs = other.syncs;
+    outputPeriods = other.outputPeriods;
+    outputNils = other.outputNils;
+    delete forcingEvents;
+    forcingEvents = 0;
+    if (other.forcingEvents) {
+        forcingEvents = new ForcingEvents(*other.forcingEvents);
+    }
+    delete allowUpdates;
+    allowUpdates = 0;
+    if (other.allowUpdates) {
+        allowUpdates = new AllowUpdates(*other.allowUpdates);
+    }
+    denys = other.denys;
+    delete outputPeriodsGlobal;
+    outputPeriodsGlobal = 0;
+    if (other.outputPeriodsGlobal) {
+        outputPeriodsGlobal = new vle::value::Integer(
+                other.outputPeriodsGlobal->value());
+    }
+    delete outputNilsGlobal;
+    outputNilsGlobal = 0;
+    if (other.outputNilsGlobal) {
+        outputNilsGlobal = new vle::value::Boolean(
+                other.outputNilsGlobal->value());
+    }
+    delete outputInitGlobal;
+    outputInitGlobal = 0;
+    if (other.outputInitGlobal) {
+        outputInitGlobal = new vle::value::Boolean(
+                other.outputInitGlobal->value());
+    }
+    snapshot_before = other.snapshot_before;
+    snapshot_after = other.snapshot_after;
+    dyn_allow = other.dyn_allow;
+    dyn_type = other.dyn_type;
+    dyn_sync = other.dyn_sync;
+    dyn_sync_out = other.dyn_sync_out;
+    dyn_init_value.reset();
+    if (other.dyn_init_value) {
+        dyn_init_value = other.dyn_init_value->clone();
+    }
+    dyn_dim = other.dyn_dim;
+}
+
 void
 DEVS_Options::setGlobalOutputNils(bool nil)
 {
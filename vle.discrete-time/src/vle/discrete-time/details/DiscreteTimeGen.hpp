@@ -119,6 +119,12 @@ struct  DEVS_Options
     DEVS_Options();
     ~DEVS_Options();
 
+    /**
+     * @brief Deep copy of the options of another model.
+     */
+    void
+    assign(const DEVS_Options& other);
+
     void
     setGlobalOutputNils(bool type);
 
@@ -203,6 +209,42 @@ struct  DEVS_Options
 
 
 
+/**
+ * @brief Initialization values shared by many instances of discrete-time
+ * models, and the options parsed from them once.
+ */
+struct DiscreteTimeTemplate
+{
+    std::shared_ptr<const vle::value::Map> events;
+    DEVS_Options options;
+};
+
+/**
+ * @brief Parse once the initialization values shared by many instances
+ * and register them under a name. The models of the coupled model
+ * @e scope whose initialization values contain "dt_template" with this
+ * name start from the parsed options and the shared values; their own
+ * values (per instance) override them. Templates of different coupled
+ * models (or of different simulations) never see each other.
+ * @param scope the coupled model of the executive that owns the template.
+ * @param name the name of the template.
+ * @param events the shared initialization values.
+ */
+void registerTemplate(const vle::vpz::CoupledModel* scope,
+        const std::string& name,
+        const vle::devs::InitEventList& events);
+
+/**
+ * @brief Remove a template. Instances already built are not affected.
+ */
+void unregisterTemplate(const vle::vpz::CoupledModel* scope,
+        const std::string& name);
+
+/**
+ * @brief Remove all the templates of a coupled model.
+ */
+void unregisterTemplates(const vle::vpz::CoupledModel* scope);
+
 /**
  * @brief Internal State
  */
@@ -228,8 +270,10 @@ struct Pimpl
     bool declarationOn;
     unsigned int currentTimeStep;
     ComputeInterface*  devs_atom;
+    const vle::vpz::CoupledModel* devs_scope; //scope of the dt_template
 
     Pimpl(TemporalValuesProvider& tempvp,
+            const vle::vpz::CoupledModel* scope,
             const vle::devs::InitEventList&  events);
     void time_step(double val);
     void init_value(const std::string& v, const vle::value::Value& val);
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2014-2014 INRA http://www.inra.fr
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+//@@tagdynamic@@
+
+
+#include <vle/DiscreteTime.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Tuple.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace vle {
+namespace discrete_time {
+namespace generic {
+
+/**
+ * @brief Aggregates all its inputs into statistics. Inputs are the Var
+ * (one value per port) and the Vect (one value per dimension, for the
+ * ports with a dim_ parameter) of the model, including those added with
+ * dyn_allow. At each step their values
+ * are gathered into one contiguous array (or the array of a single Vect
+ * input is used as is) and reduced in one pass.
+ *
+ * Parameters:
+ * - aggregations (Set of String, default sum, mean, min, max, variance):
+ *   the computed statistics among sum, mean, min, max, variance (sample
+ *   variance), weighted_mean and quantiles. They are written on the Var
+ *   Sum, Mean, Min, Max, Variance, WeightedMean and Quantile_0,
+ *   Quantile_1...
+ * - weights (Tuple): one weight per input value, for weighted_mean.
+ * - quantiles (Tuple): the probabilities of the quantiles, estimated by
+ *   linear interpolation between order statistics.
+ */
+class GenericAggregate : public DiscreteTimeDyn
+{
+public:
+    GenericAggregate(const vle::devs::DynamicsInit& init,
+                     const vle::devs::InitEventList& events)
+        : DiscreteTimeDyn(init, events), mVariables(0)
+    {
+        std::vector<std::string> aggregations;
+        if (events.exist("aggregations")) {
+            const value::Set& set = events.getSet("aggregations");
+            for (unsigned int i = 0; i < set.size(); i++) {
+                aggregations.push_back(set.getString(i));
+            }
+        } else {
+            aggregations = { "sum", "mean", "min", "max", "variance" };
+        }
+
+        for (const auto& agg : aggregations) {
+            if (agg == "sum") {
+                addOutput(Sum, "Sum", events);
+            } else if (agg == "mean") {
+                addOutput(Mean, "Mean", events);
+            } else if (agg == "min") {
+                addOutput(Min, "Min", events);
+            } else if (agg == "max") {
+                addOutput(Max, "Max", events);
+            } else if (agg == "variance") {
+                addOutput(Variance, "Variance", events);
+            } else if (agg == "weighted_mean") {
+                const value::Tuple& w = events.getTuple("weights");
+                weights.assign(w.value().begin(), w.value().end());
+                addOutput(WeightedMean, "WeightedMean", events);
+            } else if (agg == "quantiles") {
+                const value::Tuple& q = events.getTuple("quantiles");
+                probabilities.assign(q.value().begin(), q.value().end());
+                Quantiles.resize(probabilities.size());
+                for (unsigned int i = 0; i < Quantiles.size(); i++) {
+                    addOutput(Quantiles[i], vle::utils::format(
+                                  "Quantile_%u", i), events);
+                }
+            } else {
+                throw vle::utils::ArgError(vle::utils::format(
+                        "[%s] unknown aggregation '%s'",
+                        getModelName().c_str(), agg.c_str()));
+            }
+        }
+
+        vle::vpz::ConnectionList::const_iterator itb =
+                getModel().getInputPortList().begin();
+        vle::vpz::ConnectionList::const_iterator ite =
+                getModel().getInputPortList().end();
+        for (; itb != ite; itb++) {
+            if (getVariables().find(itb->first) != getVariables().end()) {
+                continue;
+            }
+            if (events.exist("dim_" + itb->first)) {
+                Vect v;
+                v.init(this, itb->first, events);
+            } else {
+                Var v;
+                v.init(this, itb->first, events);
+            }
+            getOptions().syncs.insert(std::make_pair(itb->first, 1));
+        }
+    }
+
+    virtual ~GenericAggregate()
+    {
+    }
+
+    void compute(const vle::devs::Time& t)
+    {
+        if (getVariables().size() != mVariables) {
+            updateInputs();
+        }
+
+        const double* x = values.data();
+        std::size_t n = values.size();
+        if (monos.empty() and multis.size() == 1) {
+            const std::vector<double>& v = multis.front()->getVal(t, 0.0);
+            x = v.data();
+            n = v.size();
+        } else {
+            std::size_t k = 0;
+            for (VarMono* v : monos) {
+                values[k++] = v->getVal(t, 0.0);
+            }
+            for (VarMulti* v : multis) {
+                const std::vector<double>& vals = v->getVal(t, 0.0);
+                std::copy(vals.begin(), vals.end(), values.begin() + k);
+                k += vals.size();
+            }
+        }
+
+        if (n == 0) {
+            return;
+        }
+
+        double sum = 0.0;
+        double min = x[0];
+        double max = x[0];
+        for (std::size_t i = 0; i < n; i++) {
+            sum += x[i];
+            min = std::min(min, x[i]);
+            max = std::max(max, x[i]);
+        }
+        double mean = sum / n;
+
+        if (Sum.itVar) {
+            Sum = sum;
+        }
+        if (Mean.itVar) {
+            Mean = mean;
+        }
+        if (Min.itVar) {
+            Min = min;
+        }
+        if (Max.itVar) {
+            Max = max;
+        }
+        if (Variance.itVar) {
+            double sq = 0.0;
+            for (std::size_t i = 0; i < n; i++) {
+                sq += (x[i] - mean) * (x[i] - mean);
+            }
+            Variance = n > 1 ? sq / (n - 1) : 0.0;
+        }
+        if (WeightedMean.itVar) {
+            if (weights.size() != n) {
+                throw vle::utils::ModellingError(vle::utils::format(
+                        "[%s] %u weights for %u inputs",
+                        getModelName().c_str(),
+                        (unsigned int)weights.size(), (unsigned int)n));
+            }
+            double wsum = 0.0;
+            double wxsum = 0.0;
+            for (std::size_t i = 0; i < n; i++) {
+                wsum += weights[i];
+                wxsum += weights[i] * x[i];
+            }
+            WeightedMean = wxsum / wsum;
+        }
+        if (not Quantiles.empty()) {
+            sorted.assign(x, x + n);
+            for (unsigned int i = 0; i < Quantiles.size(); i++) {
+                double h = (n - 1) * probabilities[i];
+                std::size_t lo = std::min((std::size_t)std::floor(h), n - 1);
+                std::nth_element(sorted.begin(), sorted.begin() + lo,
+                                 sorted.end());
+                double xlo = sorted[lo];
+                double xhi = xlo;
+                if (lo + 1 < n) {
+                    xhi = *std::min_element(sorted.begin() + lo + 1,
+                                            sorted.end());
+                }
+                Quantiles[i] = xlo + (h - lo) * (xhi - xlo);
+            }
+        }
+    }
+
+    Var Sum;
+    Var Mean;
+    Var Min;
+    Var Max;
+    Var Variance;
+    Var WeightedMean;
+    std::vector<Var> Quantiles;
+
+private:
+    void addOutput(Var& var, const std::string& name,
+                   const vle::devs::InitEventList& events)
+    {
+        var.init(this, name, events);
+        outputs.push_back(var.itVar);
+    }
+
+    /**
+     * @brief Collects the inputs: every variable but the outputs, in the
+     * order of their names.
+     */
+    void updateInputs()
+    {
+        monos.clear();
+        multis.clear();
+        std::size_t n = 0;
+
+        Variables::const_iterator itb = getVariables().begin();
+        Variables::const_iterator ite = getVariables().end();
+        for (; itb != ite; itb++) {
+            if (std::find(outputs.begin(), outputs.end(), itb->second) !=
+                outputs.end()) {
+                continue;
+            }
+            if (itb->second->getType() == MONO) {
+                monos.push_back(static_cast<VarMono*>(itb->second));
+                n++;
+            } else if (itb->second->getType() == MULTI) {
+                multis.push_back(static_cast<VarMulti*>(itb->second));
+                n += multis.back()->dim;
+            }
+        }
+
+        values.resize(n);
+        mVariables = getVariables().size();
+    }
+
+    std::vector<VarInterface*> outputs;
+    std::vector<VarMono*> monos;
+    std::vector<VarMulti*> multis;
+    std::vector<double> values;
+    std::vector<double> sorted;
+    std::vector<double> weights;
+    std::vector<double> probabilities;
+    std::size_t mVariables;
+};
+
+}}}
+
+DECLARE_DYNAMICS(vle::discrete_time::generic::GenericAggregate)
@@ -0,0 +1,91 @@
+/*
+ * @file vle/examples/fsa/FDDevs3.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2007 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2011 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: vle.extension.fsa @@endtagdepends
+ */
+
+#include <vle/extension/fsa/FDDevs.hpp>
+#include <memory>
+
+namespace vle { namespace examples { namespace fsa {
+
+namespace vf = vle::extension::fsa;
+namespace vd = vle::devs;
+
+enum State { a = 1, b, c };
+
+/**
+ * @brief The model of FDDevs1, built once and shared by all the
+ * instances.
+ */
+class devs3 : public vf::FDDevs
+{
+public:
+    devs3(const vd::DynamicsInit& init,
+          const vd::InitEventList& events) :
+        vf::FDDevs(init, events, definition())
+    {}
+
+    virtual ~devs3() { }
+
+    static std::shared_ptr < const vf::FDDevsDefinition > definition()
+    {
+        static std::shared_ptr < const vf::FDDevsDefinition > def = []() {
+            auto d = std::make_shared < vf::FDDevsDefinition >();
+
+            d->addState(a);
+            d->addState(b);
+            d->addState(c);
+
+            d->durations()[a] = 6;
+            d->durations()[b] = 5;
+            d->durations()[c] = 2;
+
+            d->internals()[a] = b;
+            d->internals()[b] = a;
+            d->internals()[c] = a;
+
+            d->outputFuncs()[a] = [](const vd::Time& /*time*/,
+                                     vd::ExternalEventList& output) {
+                output.emplace_back("out");
+            };
+
+            d->externals(a)["in"] = c;
+            d->externals(b)["in"] = c;
+
+            d->initialState(a);
+            return d;
+        }();
+
+        return def;
+    }
+};
+
+DECLARE_DYNAMICS(devs3)
+
+}}} // namespace vle examples fsa
@@ -0,0 +1,70 @@
+/*
+ * @file vle/examples/fsa/FDDevs4.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2007 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2011 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: vle.extension.fsa @@endtagdepends
+ */
+
+#include <vle/extension/fsa/FDDevs.hpp>
+
+namespace vle { namespace examples { namespace fsa {
+
+namespace vf = vle::extension::fsa;
+namespace vd = vle::devs;
+
+enum State { a = 1, b };
+
+/**
+ * @brief A model without external transition: the events it receives
+ * must only consume the elapsed time, so that it changes its state every
+ * 20 time units whatever its inputs.
+ */
+class devs4 : public vf::FDDevs
+{
+public:
+    devs4(const vd::DynamicsInit& init,
+          const vd::InitEventList& events) :
+        vf::FDDevs(init, events)
+    {
+        states(this) << a << b;
+
+        duration(this, a) << 20;
+        duration(this, b) << 20;
+
+        internal(this, a) >> b;
+        internal(this, b) >> a;
+
+        initialState(a);
+    }
+
+    virtual ~devs4() { }
+};
+
+DECLARE_DYNAMICS(devs4)
+
+}}} // namespace vle examples fsa
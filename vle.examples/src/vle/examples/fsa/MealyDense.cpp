@@ -0,0 +1,86 @@
+/*
+ * @file vle/examples/fsa/MealyDense.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2007 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2011 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: vle.extension.fsa @@endtagdepends
+ */
+
+#include <vle/extension/fsa/Mealy.hpp>
+#include <algorithm>
+
+namespace vle { namespace examples { namespace fsa {
+
+namespace vf = vle::extension::fsa;
+namespace vd = vle::devs;
+
+enum DenseState { a = 1, b, c };
+
+/**
+ * The machine of mealy1, with the states declared in the reverse order
+ * (their dense indexes differ from their values) and an input port
+ * "noise" that no transition uses: its events must be ignored.
+ */
+class mealyDense : public vf::Mealy
+{
+public:
+    mealyDense(const vd::DynamicsInit& init,
+               const vd::InitEventList& events) :
+        vf::Mealy(init, events)
+    {
+        states(this) << c << b << a;
+
+        transition(this, a, c) << event("in1")
+                               << send(std::string("out1"));
+        transition(this, a, c) << event("in2")
+                               << send(std::string("out2"));
+        transition(this, b, a) << event("in1")
+                               << send(std::string("out1"));
+        transition(this, c, a) << event("in2");
+        transition(this, c, b) << event("in1");
+
+        initialState(a);
+    }
+
+    virtual vd::ExternalEventList select(
+        const vd::ExternalEventList& events)
+    {
+        // in2 have a greater priority than the other ports
+        vd::ExternalEventList list(events);
+
+        std::stable_partition(list.begin(), list.end(),
+                              [](const vd::ExternalEvent& event)
+                              { return event.onPort("in2"); });
+        return list;
+    }
+
+    virtual ~mealyDense() { }
+};
+
+DECLARE_DYNAMICS(mealyDense)
+
+}}} // namespace vle examples fsa
@@ -26,6 +26,7 @@
  */
 
 
+#include <vle/examples/gens/StructureJournal.hpp>
 #include <vle/devs/Executive.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/value/Set.hpp>
@@ -40,12 +41,17 @@ class GenExecutive : public devs::Executive
 
     std::stack < std::string >  m_stacknames;
     state                       m_state;
+    mutable StructureJournal    m_journal;
 
 public:
     GenExecutive(const devs::ExecutiveInit& mdl,
                  const devs::InitEventList& events) :
         devs::Executive(mdl, events), m_state(INIT)
     {
+        if (events.exist("snapshot_interval")) {
+            m_journal.setSnapshotInterval(
+                events.getInt("snapshot_interval"));
+        }
     }
 
     virtual ~GenExecutive()
@@ -113,6 +119,8 @@ public:
             std::ostringstream out;
             coupledmodel().writeXML(out);
             return value::String::create(out.str());
+        } else if (ev.onPort("structure_delta")) {
+            return m_journal.observe(coupledmodel());
         } else if (ev.onPort("adjacency_matrix")) {
             auto ret = vle::value::Set::create();
             auto& set = ret->toSet();
@@ -155,6 +163,9 @@ public:
         createModel(name, std::vector < std::string >(), outputs, "gensbeep");
         addConnection(name, "out", "counter", "in");
 
+        m_journal.addModel(name);
+        m_journal.addConnection(name, "counter");
+
         m_stacknames.push(name);
     }
 
@@ -167,6 +178,7 @@ public:
         }
 
         delModel(m_stacknames.top());
+        m_journal.delModel(m_stacknames.top());
         m_stacknames.pop();
     }
 
@@ -0,0 +1,298 @@
+/*
+ * @file vle/examples/gens/StructureJournal.hpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2007 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2011 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EXAMPLES_GENS_STRUCTURE_JOURNAL_HPP
+#define EXAMPLES_GENS_STRUCTURE_JOURNAL_HPP
+
+#include <vle/value/Map.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <map>
+#include <set>
+#include <string>
+
+namespace vle { namespace examples { namespace gens {
+
+/**
+ * Records the structural changes made by an executive, to observe the
+ * structure of its coupled model at a cost that does not grow with the
+ * size of the model.
+ *
+ * Models get integer ids, never reused. Each call to observe() returns a
+ * value::Map:
+ * - every @e interval observations (and at the first one), a snapshot of
+ *   the coupled model in CSR form: "ids" and "names" of the models,
+ *   "offsets" (size ids + 1) and "indices", the ids of the destinations
+ *   of the connections of each model;
+ * - otherwise, the net changes since the previous observation, only the
+ *   non empty keys: "add" (ids) and "names", "del" (ids), "connect" and
+ *   "disconnect" (flat pairs of source and destination ids). The
+ *   connections of a deleted model are listed in "disconnect".
+ *
+ * Connections are tracked between models, whatever the ports. The
+ * observation consumes the changes: attach the port to a single view.
+ */
+class StructureJournal
+{
+public:
+    explicit StructureJournal(unsigned int interval = 100)
+        : m_next(0), m_interval(interval), m_observations(0)
+    {
+    }
+
+    void setSnapshotInterval(unsigned int interval)
+    {
+        m_interval = interval;
+    }
+
+    void addModel(const std::string& name)
+    {
+        if (m_ids.find(name) != m_ids.end()) {
+            return;
+        }
+
+        int id = m_next++;
+        m_ids[name] = id;
+        m_added[id] = name;
+    }
+
+    void delModel(const std::string& name)
+    {
+        auto it = m_ids.find(name);
+        if (it == m_ids.end()) {
+            return;
+        }
+
+        int id = it->second;
+        m_ids.erase(it);
+
+        for (const auto& dst : m_out[id]) {
+            if (dst.first != id) {
+                m_in[dst.first].erase(id);
+            }
+            removed(id, dst.first);
+        }
+        for (int src : m_in[id]) {
+            if (src != id) {
+                m_out[src].erase(id);
+                removed(src, id);
+            }
+        }
+        m_out.erase(id);
+        m_in.erase(id);
+
+        if (m_added.erase(id) == 0) {
+            m_deleted.insert(id);
+        }
+    }
+
+    void addConnection(const std::string& src, const std::string& dst)
+    {
+        auto s = m_ids.find(src);
+        auto d = m_ids.find(dst);
+        if (s == m_ids.end() or d == m_ids.end()) {
+            return;
+        }
+
+        if (++m_out[s->second][d->second] == 1) {
+            m_in[d->second].insert(s->second);
+
+            std::pair<int, int> edge(s->second, d->second);
+            if (m_disconnected.erase(edge) == 0) {
+                m_connected.insert(edge);
+            }
+        }
+    }
+
+    void delConnection(const std::string& src, const std::string& dst)
+    {
+        auto s = m_ids.find(src);
+        auto d = m_ids.find(dst);
+        if (s == m_ids.end() or d == m_ids.end()) {
+            return;
+        }
+
+        auto out = m_out.find(s->second);
+        if (out == m_out.end()) {
+            return;
+        }
+
+        auto edge = out->second.find(d->second);
+        if (edge != out->second.end() and --edge->second == 0) {
+            out->second.erase(edge);
+            m_in[d->second].erase(s->second);
+            removed(s->second, d->second);
+        }
+    }
+
+    /**
+     * @return the snapshot or the changes since the previous call.
+     * @param coupled the coupled model of the executive, only read to
+     * build the snapshots.
+     */
+    std::unique_ptr<value::Value> observe(const vpz::CoupledModel& coupled)
+    {
+        bool full = m_interval == 0 ? m_observations == 0
+                                    : m_observations % m_interval == 0;
+        m_observations++;
+
+        return full ? snapshot(coupled) : delta();
+    }
+
+private:
+    void removed(int src, int dst)
+    {
+        std::pair<int, int> edge(src, dst);
+        if (m_connected.erase(edge) == 0) {
+            m_disconnected.insert(edge);
+        }
+    }
+
+    static std::unique_ptr<value::Tuple> pairs(
+        const std::set<std::pair<int, int>>& edges)
+    {
+        auto ret = value::Tuple::create();
+        for (const auto& edge : edges) {
+            ret->add(edge.first);
+            ret->add(edge.second);
+        }
+        return ret;
+    }
+
+    std::unique_ptr<value::Value> delta()
+    {
+        auto ret = value::Map::create();
+
+        if (not m_added.empty()) {
+            auto ids = value::Tuple::create();
+            auto names = value::Set::create();
+            for (const auto& model : m_added) {
+                ids->add(model.first);
+                names->addString(model.second);
+            }
+            ret->add("add", std::move(ids));
+            ret->add("names", std::move(names));
+        }
+        if (not m_deleted.empty()) {
+            auto ids = value::Tuple::create();
+            for (int id : m_deleted) {
+                ids->add(id);
+            }
+            ret->add("del", std::move(ids));
+        }
+        if (not m_connected.empty()) {
+            ret->add("connect", pairs(m_connected));
+        }
+        if (not m_disconnected.empty()) {
+            ret->add("disconnect", pairs(m_disconnected));
+        }
+
+        clearChanges();
+        return ret;
+    }
+
+    std::unique_ptr<value::Value> snapshot(const vpz::CoupledModel& coupled)
+    {
+        const vpz::ModelList& models = coupled.getModelList();
+
+        std::map<std::string, int> ids;
+        for (const auto& model : models) {
+            auto it = m_ids.find(model.first);
+            ids[model.first] = it != m_ids.end() ? it->second : m_next++;
+        }
+        m_ids.swap(ids);
+        m_out.clear();
+        m_in.clear();
+        clearChanges();
+
+        auto ret = value::Map::create();
+        auto idList = value::Tuple::create();
+        auto names = value::Set::create();
+        auto offsets = value::Tuple::create();
+        auto indices = value::Tuple::create();
+        std::size_t nb = 0;
+
+        offsets->add(0);
+        for (const auto& model : models) {
+            int src = m_ids[model.first];
+            auto& out = m_out[src];
+
+            for (const auto& port : model.second->getOutputPortList()) {
+                for (const auto& dst : port.second) {
+                    auto it = m_ids.find(dst.first->getName());
+                    if (dst.first->getParent() == &coupled and
+                        it != m_ids.end() and ++out[it->second] == 1) {
+                        m_in[it->second].insert(src);
+                    }
+                }
+            }
+
+            for (const auto& dst : out) {
+                indices->add(dst.first);
+            }
+            nb += out.size();
+
+            idList->add(src);
+            names->addString(model.first);
+            offsets->add(nb);
+        }
+
+        ret->add("ids", std::move(idList));
+        ret->add("names", std::move(names));
+        ret->add("offsets", std::move(offsets));
+        ret->add("indices", std::move(indices));
+        return ret;
+    }
+
+    void clearChanges()
+    {
+        m_added.clear();
+        m_deleted.clear();
+        m_connected.clear();
+        m_disconnected.clear();
+    }
+
+    std::map<std::string, int>          m_ids;
+    int                                 m_next;
+    std::map<int, std::map<int, int>>   m_out; // multiplicity by source
+    std::map<int, std::set<int>>        m_in;
+
+    std::map<int, std::string>          m_added;
+    std::set<int>                       m_deleted;
+    std::set<std::pair<int, int>>       m_connected;
+    std::set<std::pair<int, int>>       m_disconnected;
+
+    unsigned int                        m_interval;
+    unsigned int                        m_observations;
+};
+
+}}} // namespace vle examples gens
+
+#endif
@@ -234,6 +234,57 @@ void test_mealy2()
     EnsuresEqual(result.getInt(3,100), 2);
 }
 
+static std::unique_ptr<value::Map> run_fsa(const std::string& vpz)
+{
+    auto ctx = vle::utils::make_context(); vle::utils::Package pack(ctx, "vle.examples");
+    std::unique_ptr<vpz::Vpz> file(new vpz::Vpz(pack.getExpFile(vpz)));
+
+    vpz::Output& o(file->project().experiment().views().outputs().get("view"));
+    o.setStream("", "storage", "vle.output");
+
+    manager::Error error;
+#if VLE_VERSION >= 200100
+    manager::Simulation sim(ctx, manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0));
+#else
+    manager::Simulation sim(ctx, manager::LOG_NONE,
+            manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0), &std::cout);
+#endif
+    std::unique_ptr<value::Map> out = sim.run(std::move(file), &error);
+
+    EnsuresEqual(error.code, 0);
+    return out;
+}
+
+void test_mealy_dense_tables()
+{
+    std::unique_ptr<value::Map> reference = run_fsa("mealy.vpz");
+    std::unique_ptr<value::Map> dense = run_fsa("mealyDense.vpz");
+
+    Ensures(reference != NULL);
+    Ensures(dense != NULL);
+
+    value::Matrix& expected = reference->getMatrix("view");
+    value::Matrix& result = dense->getMatrix("view");
+
+    EnsuresEqual(result.columns(), 4);
+    EnsuresEqual(result.rows(), 101);
+
+    // permuted state indexes and the ignored port do not change the
+    // trajectory of mealy1
+    for (unsigned int r = 0; r < result.rows(); ++r) {
+        EnsuresEqual(result.getInt(1, r), expected.getInt(1, r));
+        EnsuresEqual(result.getInt(2, r), expected.getInt(2, r));
+        EnsuresEqual(result.getInt(3, r), expected.getInt(3, r));
+    }
+
+    EnsuresEqual(result.getInt(3,0), 1);
+    EnsuresEqual(result.getInt(3,14), 2);
+    EnsuresEqual(result.getInt(3,22), 1);
+    EnsuresEqual(result.getInt(3,61), 3);
+}
+
 void test_statechart1()
 {
     auto ctx = vle::utils::make_context(); vle::utils::Package pack(ctx, "vle.examples");
@@ -794,6 +845,88 @@ void test_statechartMultipleSend()
     EnsuresEqual(out->size(), 1);
 }
 
+static std::unique_ptr<value::Map> run_fddevs(const std::string& library)
+{
+    auto ctx = vle::utils::make_context(); vle::utils::Package pack(ctx, "vle.examples");
+    std::unique_ptr<vpz::Vpz> file(new vpz::Vpz(pack.getExpFile("fddevs.vpz")));
+
+    vpz::Output& o(file->project().experiment().views().outputs().get("view"));
+    o.setStream("", "storage", "vle.output");
+    file->project().dynamics().get("dyn1").setLibrary(library);
+
+    manager::Error error;
+#if VLE_VERSION >= 200100
+    manager::Simulation sim(ctx, manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0));
+#else
+    manager::Simulation sim(ctx, manager::LOG_NONE,
+            manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0), &std::cout);
+#endif
+    std::unique_ptr<value::Map> out = sim.run(std::move(file), &error);
+
+    EnsuresEqual(error.code, 0);
+    return out;
+}
+
+void test_fddevs_shared_definition()
+{
+    std::unique_ptr<value::Map> own = run_fddevs("FDDevs1");
+    std::unique_ptr<value::Map> shared = run_fddevs("FDDevs3");
+
+    Ensures(own != NULL);
+    Ensures(shared != NULL);
+
+    value::Matrix& expected = own->getMatrix("view");
+    value::Matrix& result = shared->getMatrix("view");
+
+    EnsuresEqual(result.columns(), expected.columns());
+    EnsuresEqual(result.rows(), expected.rows());
+    EnsuresEqual(result.rows(), 1001);
+
+    for (unsigned int r = 0; r < result.rows(); ++r) {
+        EnsuresEqual(result.getInt(1, r), expected.getInt(1, r));
+        EnsuresEqual(result.getInt(2, r), expected.getInt(2, r));
+    }
+
+    // hand-computed trajectory (a = 1, b = 2, c = 3), the same as before
+    // the shared definitions: m2 ignores the event of m1 at t = 6, then
+    // the models alternate with a period of 16 from t = 14.
+    const int trajectory[][3] = {
+        { 3, 1, 1 }, { 7, 3, 2 }, { 9, 1, 2 }, { 12, 1, 1 },
+        { 15, 2, 3 }, { 17, 2, 1 }, { 20, 1, 1 }, { 23, 3, 2 },
+        { 25, 1, 2 }, { 28, 1, 1 }, { 999, 3, 2 } };
+
+    for (const auto& row : trajectory) {
+        EnsuresEqual(result.getInt(1, row[0]), row[1]);
+        EnsuresEqual(result.getInt(2, row[0]), row[2]);
+    }
+}
+
+void test_fddevs_elapsed_time()
+{
+    std::unique_ptr<value::Map> out = run_fsa("fddevsElapsed.vpz");
+
+    Ensures(out != NULL);
+
+    value::Matrix& result = out->getMatrix("view");
+
+    EnsuresEqual(result.rows(), 101);
+
+    // m1 sends at t = 6, 17, 28... m2 ignores these events: its last
+    // transition time starts at the init time and is updated on each
+    // event, so it keeps changing state every 20 time units.
+    const int trajectory[][3] = {
+        { 3, 1, 1 }, { 7, 2, 1 }, { 12, 1, 1 }, { 19, 2, 1 },
+        { 21, 2, 2 }, { 38, 1, 2 }, { 42, 2, 1 }, { 59, 1, 1 },
+        { 62, 2, 2 }, { 97, 2, 1 } };
+
+    for (const auto& row : trajectory) {
+        EnsuresEqual(result.getInt(1, row[0]), row[1]);
+        EnsuresEqual(result.getInt(2, row[0]), row[2]);
+    }
+}
+
 int main()
 {
     F fixture;
@@ -801,11 +934,14 @@ int main()
     test_moore2();
     test_mealy1();
     test_mealy2();
+    test_mealy_dense_tables();
     test_statechart1();
     test_statechart7();
     test_statechart10();
     test_statechart11();
     test_statechartMultipleSend();
+    test_fddevs_shared_definition();
+    test_fddevs_elapsed_time();
 
     return unit_test::report_errors();
 }
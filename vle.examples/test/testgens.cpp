@@ -31,6 +31,7 @@
 #include <string>
 #include <stdexcept>
 #include <iostream>
+#include <set>
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/Simulation.hpp>
 #include <vle/vpz/Vpz.hpp>
@@ -39,6 +40,8 @@
 
 #include <vle/vle.hpp>
 #include <vle/value/Matrix.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/Tuple.hpp>
 #include <vle/version.hpp>
 
 struct F
@@ -114,6 +117,116 @@ void test_gens()
 
 }
 
+void test_gens_structure_delta()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Package pack(ctx, "vle.examples");
+    std::unique_ptr<vpz::Vpz> file(new vpz::Vpz(pack.getExpFile("gens.vpz")));
+
+    /* observe the structure changes on view2 */
+    vpz::Output& o(file->project().experiment().views().outputs().get("view1"));
+    vpz::Output& o2(file->project().experiment().views().outputs().get("view2"));
+    o.setStream("", "storage", "vle.output");
+    o2.setStream("", "storage", "vle.output");
+    file->project().experiment().views().observables().get("obs2")
+        .add("structure_delta").add("view2");
+
+    /* run the simulation */
+
+    manager::Error error;
+#if VLE_VERSION >= 200100
+    manager::Simulation sim(ctx, manager::SIMULATION_NONE,
+                std::chrono::milliseconds(0));
+#else
+    manager::Simulation sim(ctx, manager::LOG_NONE,
+            manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0), &std::cout);
+#endif
+    std::unique_ptr<value::Map> out = sim.run(std::move(file), &error);
+
+    /* begin check */
+    EnsuresEqual(error.code, 0);
+    Ensures(out != NULL);
+
+    value::Matrix& nbmodel = out->getMatrix("view1");
+    value::Matrix& result = out->getMatrix("view2");
+    EnsuresEqual(result.rows(), 101);
+
+    /* the first observation is a snapshot */
+    unsigned int col = 0;
+    for (unsigned int c = 1; c < result.columns(); ++c) {
+        if (result.get(c, 0) and result.get(c, 0)->isMap() and
+            result.get(c, 0)->toMap().exist("offsets")) {
+            col = c;
+        }
+    }
+    Ensures(col != 0);
+
+    /* replay the snapshots and the changes */
+    std::set<int> models;
+    std::set<std::pair<int, int>> edges;
+    for (unsigned int row = 0; row < result.rows(); ++row) {
+        const value::Map& obs = result.get(col, row)->toMap();
+
+        if (obs.exist("offsets")) {
+            EnsuresEqual(row % 100, 0);
+            const auto& ids = obs.getTuple("ids").value();
+            const auto& offsets = obs.getTuple("offsets").value();
+            const auto& indices = obs.getTuple("indices").value();
+            EnsuresEqual(offsets.size(), ids.size() + 1);
+
+            models.clear();
+            edges.clear();
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                int src = static_cast<int>(ids[i]);
+                models.insert(src);
+                for (auto k = static_cast<std::size_t>(offsets[i]);
+                     k < static_cast<std::size_t>(offsets[i + 1]); ++k) {
+                    edges.insert(std::make_pair(
+                            src, static_cast<int>(indices[k])));
+                }
+            }
+        } else {
+            if (obs.exist("del")) {
+                for (double id : obs.getTuple("del").value()) {
+                    EnsuresEqual(models.erase(static_cast<int>(id)), 1);
+                }
+            }
+            if (obs.exist("disconnect")) {
+                const auto& pairs = obs.getTuple("disconnect").value();
+                for (std::size_t i = 0; i + 1 < pairs.size(); i += 2) {
+                    EnsuresEqual(edges.erase(std::make_pair(
+                            static_cast<int>(pairs[i]),
+                            static_cast<int>(pairs[i + 1]))), 1);
+                }
+            }
+            if (obs.exist("add")) {
+                EnsuresEqual(obs.getTuple("add").size(),
+                             obs.getSet("names").size());
+                for (double id : obs.getTuple("add").value()) {
+                    Ensures(models.insert(static_cast<int>(id)).second);
+                }
+            }
+            if (obs.exist("connect")) {
+                const auto& pairs = obs.getTuple("connect").value();
+                for (std::size_t i = 0; i + 1 < pairs.size(); i += 2) {
+                    int src = static_cast<int>(pairs[i]);
+                    int dst = static_cast<int>(pairs[i + 1]);
+                    Ensures(models.count(src) == 1);
+                    Ensures(models.count(dst) == 1);
+                    edges.insert(std::make_pair(src, dst));
+                }
+            }
+        }
+
+        /* the counter, the executive and the beeps connected to the
+         * counter */
+        int nb = nbmodel.getInt(2, row);
+        EnsuresEqual(models.size(), nb + 1);
+        EnsuresEqual(edges.size(), nb);
+    }
+}
+
 void test_gens_with_class()
 {
     auto ctx = vle::utils::make_context(); vle::utils::Package pack(ctx, "vle.examples");
@@ -270,6 +383,7 @@ int main()
 {
     F fixture;
     test_gens();
+    test_gens_structure_delta();
     test_gens_with_class();
     test_gens_with_graph();
     test_gens_delete_connection();
@@ -33,11 +33,82 @@
 #include <vle/devs/Dynamics.hpp>
 #include <numeric>
 #include <algorithm>
+#include <iterator>
 
 namespace vd = vle::devs;
 
 namespace vle { namespace extension { namespace decision {
 
+const unsigned int ActivitiesObserver::npos;
+
+unsigned int ActivitiesObserver::id(const std::string& activity)
+{
+    std::map < std::string, unsigned int >::iterator it =
+        mIds.insert(std::make_pair(activity, mNames.size())).first;
+
+    if (it->second == mNames.size()) {
+        mNames.push_back(activity);
+    }
+
+    return it->second;
+}
+
+unsigned int ActivitiesObserver::id(std::size_t index,
+                                    const std::string& activity)
+{
+    if (index >= mIdsByIndex.size()) {
+        mIdsByIndex.resize(index + 1, npos);
+    }
+
+    if (mIdsByIndex[index] == npos) {
+        mIdsByIndex[index] = id(activity);
+    }
+
+    return mIdsByIndex[index];
+}
+
+void ActivitiesObserver::release(std::size_t index)
+{
+    if (index < mIdsByIndex.size()) {
+        mIdsByIndex[index] = npos;
+    }
+}
+
+void ActivitiesObserver::record(unsigned int id)
+{
+    for (std::map < std::string, View >::iterator it = mViews.begin();
+         it != mViews.end(); ++it) {
+        View& view = it->second;
+        if (id >= view.pending.size()) {
+            view.pending.resize(mNames.size(), false);
+        }
+        if (not view.pending[id]) {
+            view.pending[id] = true;
+            view.changed.push_back(id);
+        }
+    }
+}
+
+bool ActivitiesObserver::observe(const std::string& view,
+                                 std::vector < unsigned int >& ids)
+{
+    ids.clear();
+
+    std::map < std::string, View >::iterator it = mViews.find(view);
+    if (it == mViews.end()) {
+        mViews.insert(std::make_pair(view, View()));
+        return false;
+    }
+
+    ids.swap(it->second.changed);
+    for (std::vector < unsigned int >::const_iterator jt = ids.begin();
+         jt != ids.end(); ++jt) {
+        it->second.pending[*jt] = false;
+    }
+    std::sort(ids.begin(), ids.end());
+    return true;
+}
+
 //https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
 // trim from start (in place)
 static inline void ltrim(std::string &s) {
@@ -70,7 +141,18 @@ Activity& Activities::add(const std::string& name, const Activity& act,
                 "Decision: activity '%s' already exist", name.c_str()));
     }
 
-    Activity& a((*m_lst.insert(value_type(name, act)).first).second);
+    if (isArchived(name)) {
+        throw utils::ArgError(vle::utils::format(
+                "Decision: activity '%s' already archived", name.c_str()));
+    }
+
+    iterator inserted = m_lst.insert(value_type(name, act)).first;
+    m_activeAct.insert(inserted);
+    inserted->second.setIndex(allocateIndex());
+    inserted->second.setChangeFunction(
+        std::bind(&Activities::touch, this, inserted));
+
+    Activity& a(inserted->second);
     if (out) {
         a.addOutputFunction(out);
     }
@@ -93,7 +175,18 @@ Activity& Activities::add(const std::string& name,
                 "Decision: activity '%s' already exist", name.c_str()));
     }
 
-    Activity& a((*m_lst.insert(value_type(name, Activity())).first).second);
+    if (isArchived(name)) {
+        throw utils::ArgError(vle::utils::format(
+                "Decision: activity '%s' already archived", name.c_str()));
+    }
+
+    iterator inserted = m_lst.insert(value_type(name, Activity())).first;
+    m_activeAct.insert(inserted);
+    inserted->second.setIndex(allocateIndex());
+    inserted->second.setChangeFunction(
+        std::bind(&Activities::touch, this, inserted));
+
+    Activity& a(inserted->second);
     if (out) {
         a.addOutputFunction(out);
     }
@@ -129,13 +222,126 @@ void Activities::remove(const std::string& name)
 {
     iterator it(m_lst.find(name));
 
-    if (it != m_lst.end()) {
+    if (it == m_lst.end()) {
         throw utils::ArgError("Decision: activity does not exist");
     }
 
+    erase(it);
+}
+
+void Activities::erase(iterator it)
+{
+    unindex(it);
+
+    removeAct(m_waitedAct, it);
+    removeAct(m_startedAct, it);
+    removeAct(m_failedAct, it);
+    removeAct(m_ffAct, it);
+    removeAct(m_endedAct, it);
+
+    removeAct(m_latestWaitedAct, it);
+    removeAct(m_latestStartedAct, it);
+    removeAct(m_latestFailedAct, it);
+    removeAct(m_latestFFAct, it);
+    removeAct(m_latestEndedAct, it);
+    removeAct(m_latestChangedAct, it);
+
+    freeRessources(it->first);
+    m_graph.remove(it);
+    m_observer.release(it->second.index());
+    m_freeIndexes.push_back(it->second.index());
     m_lst.erase(it);
 }
 
+std::size_t Activities::allocateIndex()
+{
+    if (m_freeIndexes.empty()) {
+        return m_lst.size() - 1;
+    }
+
+    std::size_t index = m_freeIndexes.back();
+    m_freeIndexes.pop_back();
+    return index;
+}
+
+bool Activities::isLatest(iterator it) const
+{
+    return std::find(m_latestWaitedAct.begin(), m_latestWaitedAct.end(),
+                     it) != m_latestWaitedAct.end() or
+        std::find(m_latestStartedAct.begin(), m_latestStartedAct.end(),
+                  it) != m_latestStartedAct.end() or
+        std::find(m_latestFailedAct.begin(), m_latestFailedAct.end(),
+                  it) != m_latestFailedAct.end() or
+        std::find(m_latestFFAct.begin(), m_latestFFAct.end(),
+                  it) != m_latestFFAct.end() or
+        std::find(m_latestEndedAct.begin(), m_latestEndedAct.end(),
+                  it) != m_latestEndedAct.end();
+}
+
+bool Activities::isResolved(iterator it) const
+{
+    PrecedencesGraph::findOut out = m_graph.findPrecedenceOut(it);
+
+    for (PrecedencesGraph::iteratorOut jt = out.first; jt != out.second;
+         ++jt) {
+        const Activity& successor(jt->second()->second);
+        if (not successor.isInDoneState() and
+            not successor.isInFailedState()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Activities::size_type Activities::archive()
+{
+    result_t candidates(m_retiredEndedAct.begin(), m_retiredEndedAct.end());
+    candidates.insert(candidates.end(), m_retiredFailedAct.begin(),
+                      m_retiredFailedAct.end());
+
+    size_type nb = 0;
+    for (result_t::iterator it = candidates.begin(); it != candidates.end();
+         ++it) {
+        if (isLatest(*it) or not isResolved(*it)) {
+            continue;
+        }
+
+        const Activity& act((*it)->second);
+        if (act.state() == Activity::DONE) {
+            ++m_archivedDone;
+        } else {
+            ++m_archivedFailed;
+        }
+
+        if (m_archiveCapacity > 0) {
+            ArchivedActivity record;
+            record.state = act.state();
+            record.started = act.startedDate();
+            record.ff = act.ffDate();
+            record.done = act.doneDate();
+            m_archiveOrder.push_back(
+                m_archived.insert(std::make_pair((*it)->first,
+                                                 record)).first);
+        }
+
+        erase(*it);
+        ++nb;
+    }
+
+    setArchiveCapacity(m_archiveCapacity);
+    return nb;
+}
+
+void Activities::setArchiveCapacity(size_type capacity)
+{
+    m_archiveCapacity = capacity;
+
+    while (m_archiveOrder.size() > m_archiveCapacity) {
+        m_archived.erase(m_archiveOrder.front());
+        m_archiveOrder.pop_front();
+    }
+}
+
 void Activities::addStartToStartConstraint(const std::string& acti,
                                            const std::string& actj,
                                            const devs::Time& mintimelag,
@@ -170,13 +376,150 @@ devs::Time Activities::nextDate(const devs::Time& time)
 {
     devs::Time result = devs::infinity;
 
-    for (iterator activity = begin(); activity != end(); ++activity) {
-        result = std::min(result, activity->second.nextTime(time));
+    for (index_t::iterator activity = m_activeAct.begin();
+         activity != m_activeAct.end(); ++activity) {
+        result = std::min(result, (*activity)->second.nextTime(time));
+    }
+
+    for (wakeup_t::iterator activity = m_wakeUpAct.begin();
+         activity != m_wakeUpAct.end(); ++activity) {
+        if (time <= activity->first) {
+            result = std::min(result, activity->first);
+            break;
+        }
+        result = std::min(result, activity->second->second.nextTime(time));
     }
 
     return result;
 }
 
+devs::Time Activities::wakeUpDate(const Activity& activity)
+{
+    if (activity.date() & Activity::START) {
+        return activity.start();
+    }
+    return activity.minstart();
+}
+
+void Activities::touch(iterator it)
+{
+    m_graph.invalidate(it);
+
+    if (m_activeAct.find(it) != m_activeAct.end()) {
+        return;
+    }
+
+    unindex(it);
+    m_activeAct.insert(it);
+}
+
+void Activities::unindex(iterator it)
+{
+    if (m_activeAct.erase(it)) {
+        return;
+    }
+
+    // The state may have changed since the activity left the index, look
+    // into every container.
+    sleeping_t::iterator sleeping = m_sleepingAct.find(it);
+    if (sleeping != m_sleepingAct.end()) {
+        m_wakeUpAct.erase(sleeping->second);
+        m_sleepingAct.erase(sleeping);
+        return;
+    }
+
+    if (not m_retiredEndedAct.erase(it)) {
+        m_retiredFailedAct.erase(it);
+    }
+}
+
+void Activities::wakeUpActivities(const devs::Time& time)
+{
+    while (not m_wakeUpAct.empty() and
+           m_wakeUpAct.begin()->first <= time) {
+        iterator it = m_wakeUpAct.begin()->second;
+        m_wakeUpAct.erase(m_wakeUpAct.begin());
+        m_sleepingAct.erase(it);
+        m_activeAct.insert(it);
+    }
+}
+
+void Activities::updateIndex(const devs::Time& time)
+{
+    index_t::iterator it = m_activeAct.begin();
+    while (it != m_activeAct.end()) {
+        const Activity& activity((*it)->second);
+
+        switch (activity.state()) {
+        case Activity::WAIT:
+            if (activity.isBeforeTimeConstraint(time)) {
+                wakeup_t::iterator entry = m_wakeUpAct.insert(
+                    std::make_pair(wakeUpDate(activity), *it));
+                m_sleepingAct.insert(std::make_pair(*it, entry));
+                it = m_activeAct.erase(it);
+            } else {
+                ++it;
+            }
+            break;
+        case Activity::DONE:
+            // Until the finish time constraint is reached, a done activity
+            // is reported as failed, it must stay in the index.
+            if (not activity.isBeforeFinishTimeConstraint(time)) {
+                m_retiredEndedAct.insert(*it);
+                it = m_activeAct.erase(it);
+            } else {
+                ++it;
+            }
+            break;
+        case Activity::FAILED:
+            m_retiredFailedAct.insert(*it);
+            it = m_activeAct.erase(it);
+            break;
+        case Activity::STARTED:
+        case Activity::FF:
+            ++it;
+            break;
+        }
+    }
+}
+
+void Activities::mergeByName(result_t& lst, result_t::size_type front,
+                             bool sorted)
+{
+    // A nested process call may have rebuilt the list.
+    front = std::min(front, lst.size());
+    if (not sorted) {
+        std::sort(lst.begin() + front, lst.end(), CompareName());
+    }
+    std::inplace_merge(lst.begin(), lst.begin() + front, lst.end(),
+                       CompareName());
+}
+
+bool Activities::topologicalOrder(result_t& order)
+{
+    order.assign(m_activeAct.begin(), m_activeAct.end());
+    if (m_graph.empty() or m_graph.maxRank() == 0) {
+        return true;
+    }
+
+    // Counting sort by rank, the activities of a rank stay ordered by
+    // name.
+    std::vector < result_t::size_type > first(m_graph.maxRank() + 2, 0);
+    for (result_t::const_iterator it = order.begin(); it != order.end();
+         ++it) {
+        ++first[m_graph.rank(*it) + 1];
+    }
+    std::partial_sum(first.begin(), first.end(), first.begin());
+
+    result_t sorted(order.size());
+    for (result_t::const_iterator it = order.begin(); it != order.end();
+         ++it) {
+        sorted[first[m_graph.rank(*it)]++] = *it;
+    }
+    order.swap(sorted);
+    return false;
+}
+
 Activities::const_result_t
 Activities::beforeTimeHorizonAct(
     const devs::Time& lowerBound,
@@ -257,6 +600,8 @@ void Activities::addEndedAct(Activities::iterator it)
 
 void Activities::setWaitedAct(Activities::iterator it)
 {
+    touch(it);
+
     switch (it->second.state()) {
     case Activity::WAIT:
         removeWaitedAct(it);
@@ -288,6 +633,8 @@ void Activities::setWaitedAct(Activities::iterator it)
 
 void Activities::setStartedAct(Activities::iterator it)
 {
+    touch(it);
+
     switch (it->second.state()) {
     case Activity::WAIT:
         removeWaitedAct(it);
@@ -315,6 +662,8 @@ void Activities::setStartedAct(Activities::iterator it)
 
 void Activities::setFailedAct(Activities::iterator it)
 {
+    touch(it);
+
     switch (it->second.state()) {
     case Activity::WAIT:
         removeWaitedAct(it);
@@ -342,6 +691,8 @@ void Activities::setFailedAct(Activities::iterator it)
 
 void Activities::setFFAct(Activities::iterator it)
 {
+    touch(it);
+
     switch (it->second.state()) {
     case Activity::WAIT:
         removeWaitedAct(it);
@@ -369,6 +720,8 @@ void Activities::setFFAct(Activities::iterator it)
 
 void Activities::setEndedAct(Activities::iterator it)
 {
+    touch(it);
+
     switch (it->second.state()) {
     case Activity::WAIT:
         removeWaitedAct(it);
@@ -417,6 +770,27 @@ void Activities::updateLatestActivitiesList(Activities::result_t& lst,
     removeAct(m_latestFailedAct, it);
 
     addAct(lst, it);
+    addChangedAct(it);
+}
+
+void Activities::addLatestAct(Activities::result_t& lst,
+                              Activities::iterator it)
+{
+    lst.push_back(it);
+    addChangedAct(it);
+}
+
+void Activities::addChangedAct(Activities::iterator it)
+{
+    m_observer.changed(it->second.index(), it->first);
+
+    Activities::result_t::iterator pos =
+        std::lower_bound(m_latestChangedAct.begin(), m_latestChangedAct.end(),
+                         it, CompareName());
+
+    if (pos == m_latestChangedAct.end() or (*pos) != it) {
+        m_latestChangedAct.insert(pos, it);
+    }
 }
 
 void Activities::clearLatestActivitiesLists()
@@ -426,6 +800,7 @@ void Activities::clearLatestActivitiesLists()
     m_latestFFAct.clear();
     m_latestFailedAct.clear();
     m_latestEndedAct.clear();
+    m_latestChangedAct.clear();
 }
 
 struct compareByPriority {
@@ -435,9 +810,82 @@ struct compareByPriority {
                 j->second.getPriority());}
 } byPriority;
 
-ResourceSolution Activities::firstResources(const std::string& resources) const
+void Activities::setResourceAvailable(const std::string& resourcename)
+{
+    mResourceAvailability[resourcename] = true;
+
+    if (mResourcesVersion == mKb.resourcesVersion()) {
+        std::size_t id = mKb.resourceId(resourcename);
+        if (id != ResourceMask::npos) {
+            mAvailableMask.set(id);
+        }
+    }
+}
+
+void Activities::getRessources(const std::string& activityname,
+                               const ResourceSolution& resourcelist)
+{
+    bool synchronized = mResourcesVersion == mKb.resourcesVersion();
+
+    for (ResourceSolution::const_iterator it = resourcelist.begin();
+         it != resourcelist.end(); it++) {
+        mResourceAvailability[*it] = false;
+        mActivitiesResources.insert(ActivityResource(activityname, *it));
+        if (synchronized) {
+            mAvailableMask.reset(mKb.resourceId(*it));
+        }
+    }
+}
+
+void Activities::freeRessources(std::string activityname)
+{
+    bool synchronized = mResourcesVersion == mKb.resourcesVersion();
+    ActivitiesResourcesIteratorPair pit;
+
+    pit = mActivitiesResources.equal_range(activityname);
+    for (ActivitiesResourcesConstIterator it = pit.first; it != pit.second; ++it)
+    {
+        mResourceAvailability[(*it).second] = true;
+        if (synchronized) {
+            std::size_t id = mKb.resourceId((*it).second);
+            if (id != ResourceMask::npos) {
+                mAvailableMask.set(id);
+            }
+        }
+    }
+
+    mActivitiesResources.erase(pit.first, pit.second);
+}
+
+void Activities::syncResources() const
 {
-    ResourceSolution solution;
+    if (mResourcesVersion == mKb.resourcesVersion()) {
+        return;
+    }
+
+    mCompiledResources.clear();
+    mAvailableMask = ResourceMask(mKb.resourceCount());
+    for (ResourceAvailability::const_iterator it =
+             mResourceAvailability.begin();
+         it != mResourceAvailability.end(); ++it) {
+        std::size_t id = mKb.resourceId(it->first);
+        if (it->second and id != ResourceMask::npos) {
+            mAvailableMask.set(id);
+        }
+    }
+    mResourcesVersion = mKb.resourcesVersion();
+}
+
+const Activities::CompiledResources&
+Activities::compileResources(const std::string& resources) const
+{
+    CompiledResourcesT::const_iterator found =
+        mCompiledResources.find(resources);
+    if (found != mCompiledResources.end()) {
+        return found->second;
+    }
+
+    CompiledResources compiled;
 
     std::vector<std::string> resourcesAlt;
 
@@ -501,79 +949,50 @@ ResourceSolution Activities::firstResources(const std::string& resources) const
             continue;
         }
 
-        std::vector< std::vector< std::string > > resourceSet;
-        std::vector< std::vector< std::string >::const_iterator > resourceSetIter;
-
+        std::vector < ResourceMask > alternative;
         for (size_t j=0; j < strs.size(); j++) {
             trim(strs[j]);
-            resourceSet.push_back(mKb.getResources(strs[j]));
-        }
-
-        for (size_t j=0; j < strs.size(); j++) {
-            resourceSetIter.push_back(resourceSet[j].begin());
+            alternative.push_back(mKb.resourceMask(strs[j]));
         }
+        compiled.push_back(alternative);
+    }
 
-        bool explorationEnd = false;
-
-        for (size_t j = 0; j < strs.size(); j++) {
-            if (resourceSetIter[j] == resourceSet[j].end()) {
-                explorationEnd = true;
-                break;
-            }
-        }
-
-        while (not explorationEnd) {
-
-            ResourceAvailability localA = mResourceAvailability;
-
-            for (size_t j=0; j < strs.size(); j++) {
-
-                while (not (resourceSetIter[j] == resourceSet[j].end()) and
-                       not localA.at(*resourceSetIter[j]))
-                {
-                    localA[*resourceSetIter[j]] = false;
-                    resourceSetIter[j]++;
-                }
+    return mCompiledResources[resources] = compiled;
+}
 
-                if (not (resourceSetIter[j] == resourceSet[j].end())) {
-                    localA[*resourceSetIter[j]] = false;
-                }
+ResourceSolution Activities::firstResources(const std::string& resources) const
+{
+    syncResources();
 
-                if (resourceSetIter[j] == resourceSet[j].end()){
-                    break;
-                }
-            }
+    const CompiledResources& compiled = compileResources(resources);
 
-            bool solutionFound = true;
-            for (size_t j = 0; j < strs.size(); j++) {
+    for (CompiledResources::const_iterator alt = compiled.begin();
+         alt != compiled.end(); ++alt) {
 
-                if (not (resourceSetIter[j] == resourceSet[j].end()) and
-                    solutionFound == true) {
-                    solutionFound = true;
-                } else {
-                    solutionFound = false;
-                    break;
-                }
-            }
+        // Takes, for each resource of the alternative, the first available
+        // resource by name order not already taken.
+        ResourceMask localA = mAvailableMask;
+        std::vector < std::size_t > ids;
 
-            if (solutionFound) {
-                for (size_t j = 0; j < strs.size(); j++) {
-                    solution.push_back(*resourceSetIter[j]);
-                }
-                return solution;
+        for (std::vector < ResourceMask >::const_iterator mask = alt->begin();
+             mask != alt->end(); ++mask) {
+            std::size_t id = mask->findFirst(localA);
+            if (id == ResourceMask::npos) {
+                break;
             }
+            localA.reset(id);
+            ids.push_back(id);
+        }
 
-            explorationEnd = false;
-
-            for (size_t j = 0; j < strs.size(); j++) {
-                if (resourceSetIter[j] == resourceSet[j].end()) {
-                    explorationEnd = true;
-                    break;
-                }
+        if (ids.size() == alt->size()) {
+            ResourceSolution solution;
+            for (std::size_t j = 0; j < ids.size(); ++j) {
+                solution.push_back(mKb.resourceName(ids[j]));
             }
+            return solution;
         }
     }
-    return solution;
+    return ResourceSolution();
 }
 
 void Activities::assignResources(result_t& activities)
@@ -595,6 +1014,8 @@ void Activities::assignResources(result_t& activities)
         if (not solution.empty()) {
             getRessources((*activity)->first, solution);
             (*activity)->second.takeRessources();
+            m_observer.changed((*activity)->second.index(),
+                               (*activity)->first);
         }
 
         if (not (*activity)->second.hasRessources()) {
@@ -607,6 +1028,31 @@ void Activities::assignResources(result_t& activities)
     }
 }
 
+/**
+ * @brief Counts the nested calls to Activities::process (update functions
+ * may call it) to update the index only at the end of the outer call. Each
+ * call gets its own stamp for the cached status of the precedences graph.
+ */
+struct ProcessDepth
+{
+    int& depth;
+    unsigned long& stamp;
+    unsigned long previous;
+
+    ProcessDepth(int& depth, unsigned long& stamp, unsigned long& counter)
+        : depth(depth), stamp(stamp), previous(stamp)
+    {
+        ++depth;
+        stamp = ++counter;
+    }
+
+    ~ProcessDepth()
+    {
+        --depth;
+        stamp = previous;
+    }
+};
+
 Activities::Result
 Activities::process(const devs::Time& time)
 {
@@ -614,9 +1060,14 @@ Activities::process(const devs::Time& time)
     Result update = std::make_pair(false, devs::infinity);
     bool isUpdated = false;
 
+    ProcessDepth depth(mProcessDepth, mProcessStamp, mProcessCounter);
+    wakeUpActivities(time);
+
     result_t activitiesToBeAssigned;
 
-    for (iterator activity = begin(); activity != end(); ++activity) {
+    for (index_t::iterator it = m_activeAct.begin();
+         it != m_activeAct.end(); ++it) {
+        iterator activity = *it;
         if (activity->second.state() == Activity::WAIT) {
             PrecedenceConstraint::Result newstate = updateState(activity, time);
             switch (newstate.first) {
@@ -635,59 +1086,91 @@ Activities::process(const devs::Time& time)
 
     assignResources(activitiesToBeAssigned);
 
-    do {
-        m_waitedAct.clear();
-        m_startedAct.clear();
-        m_ffAct.clear();
-        m_failedAct.clear();
-        m_endedAct.clear();
-
-        for (iterator activity = begin(); activity != end(); ++activity) {
-            switch (activity->second.state()) {
-            case Activity::WAIT:
-                update = processWaitState(activity, time);
-                break;
+    // The predecessors of an activity are evaluated before it, so a single
+    // pass propagates the changes of states along the precedences.
+    result_t order;
+    bool sorted = topologicalOrder(order);
 
-            case Activity::STARTED:
-                update = processStartedState(activity, time);
-                break;
+    m_waitedAct.clear();
+    for (sleeping_t::const_iterator it = m_sleepingAct.begin();
+         it != m_sleepingAct.end(); ++it) {
+        m_waitedAct.push_back(it->first);
+    }
+    m_startedAct.clear();
+    m_ffAct.clear();
+    m_failedAct.assign(m_retiredFailedAct.begin(), m_retiredFailedAct.end());
+    m_endedAct.assign(m_retiredEndedAct.begin(), m_retiredEndedAct.end());
+    result_t::size_type waited = m_waitedAct.size();
+    result_t::size_type failed = m_failedAct.size();
+    result_t::size_type ended = m_endedAct.size();
 
-            case Activity::FF:
-                update = processFFState(activity, time);
-                break;
+    for (result_t::iterator it = order.begin(); it != order.end(); ++it) {
+        iterator activity = *it;
 
-            case Activity::DONE:
-                update = processEndedState(activity, time);
-                break;
+        switch (activity->second.state()) {
+        case Activity::WAIT:
+            update = processWaitState(activity, time);
+            break;
 
-            case Activity::FAILED:
-                update = processFailedState(activity, time);
-                break;
+        case Activity::STARTED:
+            update = processStartedState(activity, time);
+            break;
 
-            default:
-                throw utils::InternalError("Decision: unknown state");
-            }
+        case Activity::FF:
+            update = processFFState(activity, time);
+            break;
 
-            if (not isUpdated and update.first) {
-                isUpdated = true;
-            }
+        case Activity::DONE:
+            update = processEndedState(activity, time);
+            break;
+
+        case Activity::FAILED:
+            update = processFailedState(activity, time);
+            break;
 
-            if (update.first) {
+        default:
+            throw utils::InternalError("Decision: unknown state");
+        }
+
+        if (not isUpdated and update.first) {
+            isUpdated = true;
+        }
+
+        if (update.first) {
+            m_graph.invalidate(activity);
+            if (activity->second.hasUpdateFunction()) {
                 activity->second.update(activity->first);
+                mKb.invalidatePredicates();
             }
+        }
 
-            if (update.second != time and
-                update.second != devs::negativeInfinity) {
-                nextDate = std::min(nextDate, update.second);
-            }
+        if (update.second != time and
+            update.second != devs::negativeInfinity) {
+            nextDate = std::min(nextDate, update.second);
+        }
 
-            devs::Time nextActivityDate = activity->second.nextTime(time);
-            if (nextActivityDate != time and
-                nextActivityDate != devs::negativeInfinity) {
-                nextDate = std::min(nextDate, nextActivityDate);
-            }
+        devs::Time nextActivityDate = activity->second.nextTime(time);
+        if (nextActivityDate != time and
+            nextActivityDate != devs::negativeInfinity) {
+            nextDate = std::min(nextDate, nextActivityDate);
         }
-    } while (update.first);
+    }
+
+    mergeByName(m_waitedAct, waited, sorted);
+    mergeByName(m_failedAct, failed, sorted);
+    mergeByName(m_endedAct, ended, sorted);
+    if (not sorted) {
+        std::sort(m_startedAct.begin(), m_startedAct.end(), CompareName());
+        std::sort(m_ffAct.begin(), m_ffAct.end(), CompareName());
+    }
+
+    if (not m_wakeUpAct.empty()) {
+        nextDate = std::min(nextDate, m_wakeUpAct.begin()->first);
+    }
+
+    if (mProcessDepth == 1) {
+        updateIndex(time);
+    }
 
     return std::make_pair(isUpdated, nextDate);
 }
@@ -706,7 +1189,7 @@ Activities::processWaitState(iterator activity,
             activity->second.hasRessources()) {
             activity->second.start(time);
             m_startedAct.push_back(activity);
-            m_latestStartedAct.push_back(activity);
+            addLatestAct(m_latestStartedAct, activity);
             update.first = true;
             break;
         }
@@ -725,23 +1208,23 @@ Activities::processWaitState(iterator activity,
                 not (newstatebis.first == PrecedenceConstraint::Wait)) {
                 activity->second.start(time);
                 m_startedAct.push_back(activity);
-                m_latestStartedAct.push_back(activity);
+                addLatestAct(m_latestStartedAct, activity);
                 update.first = true;
             } else {
                 activity->second.fail(time);
                 m_failedAct.push_back(activity);
-                m_latestFailedAct.push_back(activity);
+                addLatestAct(m_latestFailedAct, activity);
                 update.first = true;
             }
         } else if (activity->second.isNeverFail()) {
             activity->second.start(time);
             m_startedAct.push_back(activity);
-            m_latestStartedAct.push_back(activity);
+            addLatestAct(m_latestStartedAct, activity);
             update.first = true;
         } else {
             activity->second.fail(time);
             m_failedAct.push_back(activity);
-            m_latestFailedAct.push_back(activity);
+            addLatestAct(m_latestFailedAct, activity);
             update.first = true;
         }
         break;
@@ -767,7 +1250,7 @@ Activities::processStartedState(iterator activity,
     case PrecedenceConstraint::Failed:
         activity->second.fail(time);
         m_failedAct.push_back(activity);
-        m_latestFailedAct.push_back(activity);
+        addLatestAct(m_latestFailedAct, activity);
         update.first = true;
         break;
     }
@@ -788,12 +1271,12 @@ Activities::processFFState(iterator activity,
         if (activity->second.isBeforeFinishTimeConstraint(time)) {
             activity->second.fail(time);
             m_failedAct.push_back(activity);
-            m_latestFailedAct.push_back(activity);
+            addLatestAct(m_latestFailedAct, activity);
             update.first = true;
         } else {
             activity->second.end(time);
             m_endedAct.push_back(activity);
-            m_latestEndedAct.push_back(activity);
+            addLatestAct(m_latestEndedAct, activity);
             update.first = true;
         }
         break;
@@ -804,7 +1287,7 @@ Activities::processFFState(iterator activity,
     case PrecedenceConstraint::Failed:
         activity->second.fail(time);
         m_failedAct.push_back(activity);
-        m_latestFailedAct.push_back(activity);
+        addLatestAct(m_latestFailedAct, activity);
         update.first = true;
         break;
     }
@@ -858,7 +1341,22 @@ void
 Activities::stateFromGraph(iterator activity, PrecedenceConstraint::Result& newstate,
                            const devs::Time& time)
 {
-    PrecedencesGraph::findIn in = m_graph.findPrecedenceIn(activity);
+    PrecedencesGraph::Node* node = m_graph.node(activity);
+    if (not node or node->in.empty()) {
+        return;
+    }
+
+    bool cacheable = mProcessStamp != 0 and
+        newstate.first == PrecedenceConstraint::Valid and
+        newstate.second == devs::infinity;
+
+    if (cacheable and node->stamp == mProcessStamp and
+        node->state == activity->second.state()) {
+        newstate = node->status;
+        return;
+    }
+
+    PrecedencesGraph::findIn in(node->in.begin(), node->in.end());
     PrecedencesGraph::iteratorIn it;
 
     if (activity->second.waitAllFsBeforeStart()) {
@@ -915,6 +1413,12 @@ Activities::stateFromGraph(iterator activity, PrecedenceConstraint::Result& news
             ++it;
         }
     }
+
+    if (cacheable) {
+        node->stamp = mProcessStamp;
+        node->state = activity->second.state();
+        node->status = newstate;
+    }
 }
 
 
@@ -36,12 +36,92 @@
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Context.hpp>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 
 namespace vle { namespace extension { namespace decision {
 
 class KnowledgeBase;
 
+/**
+ * @brief Records the changes of the activities for the typed observations
+ * (see KnowledgeBase::activitiesTable). Each activity gets an identifier,
+ * in order of first change or observation, kept after its archiving. Each
+ * view of the changes keeps the identifiers of the activities changed
+ * since its last observation.
+ */
+class ActivitiesObserver
+{
+public:
+    /**
+     * @brief Returns the identifier of an activity. A new identifier is
+     * given to an activity observed for the first time.
+     */
+    unsigned int id(const std::string& activity);
+
+    /**
+     * @brief Returns the identifier of a live activity, found by its
+     * index (see Activity::index).
+     */
+    unsigned int id(std::size_t index, const std::string& activity);
+
+    /**
+     * @brief Forget the index of a removed activity, its identifier is
+     * kept.
+     */
+    void release(std::size_t index);
+
+    /**
+     * @brief Returns the names of the observed activities indexed by
+     * identifier.
+     */
+    const std::vector < std::string >& names() const
+    { return mNames; }
+
+    /**
+     * @brief Records that the state, the dates or the resources of a live
+     * activity changed. Does nothing while no view observes the changes.
+     */
+    void changed(std::size_t index, const std::string& activity)
+    {
+        if (not mViews.empty()) {
+            record(id(index, activity));
+        }
+    }
+
+    /**
+     * @brief Get the identifiers of the activities changed since the last
+     * observation of the view, in ascending order.
+     * @return false, with an empty list, at the first observation of the
+     * view: all the activities have to be observed.
+     */
+    bool observe(const std::string& view, std::vector < unsigned int >& ids);
+
+private:
+    static const unsigned int npos = static_cast < unsigned int >(-1);
+
+    /**
+     * @brief The identifiers changed since the last observation of a view
+     * and a flag by identifier to insert them once.
+     */
+    struct View
+    {
+        std::vector < unsigned int > changed;
+        std::vector < bool > pending;
+    };
+
+    void record(unsigned int id);
+
+    std::map < std::string, unsigned int > mIds;
+    std::vector < std::string > mNames;
+    std::vector < unsigned int > mIdsByIndex;
+    std::map < std::string, View > mViews;
+};
+
 class Activities
 {
 public:
@@ -53,6 +133,54 @@ public:
     typedef std::vector < iterator > result_t;
     typedef std::vector < const_iterator > const_result_t;
 
+    /**
+     * @brief Orders the iterators like the activities container (by
+     * name) to keep the evaluation order of the process function.
+     */
+    struct CompareName
+    {
+        bool operator()(const iterator& x, const iterator& y) const
+        { return x->first < y->first; }
+    };
+
+    /**
+     * @brief Index of the activities that need evaluation: the activities
+     * in WAIT state whose time window is open, STARTED or FF.
+     */
+    typedef std::set < iterator, CompareName > index_t;
+
+    /**
+     * @brief Wake-up queue of the activities in WAIT state whose time
+     * window is not open, indexed by their earliest start date.
+     */
+    typedef std::multimap < devs::Time, iterator > wakeup_t;
+
+    /**
+     * @brief The activities of the wake-up queue with their entry in the
+     * queue, removed by this entry whatever the dates became since.
+     */
+    typedef std::map < iterator, wakeup_t::iterator, CompareName >
+        sleeping_t;
+
+    /**
+     * @brief Compact record of an archived activity: its final state and
+     * dates without rules, functions nor parameters.
+     */
+    struct ArchivedActivity
+    {
+        Activity::State state;
+        devs::Time started;
+        devs::Time ff;
+        devs::Time done;
+    };
+
+    typedef std::map < std::string, ArchivedActivity > archived_t;
+
+    /**
+     * @brief Default maximum number of records of archived activities.
+     */
+    static const size_type DefaultArchiveCapacity = 1024;
+
     /**
      * @brief Define the type of the process function. The first element of
      * the std::pair, a bool if the knowledge base needs update, the second
@@ -61,7 +189,10 @@ public:
     typedef std::pair < bool, devs::Time > Result;
 
     Activities(utils::ContextPtr ctxp, KnowledgeBase& kb)
-        : ctx(ctxp), mKb(kb), mPriorityIncrement(0.)
+        : ctx(ctxp), mKb(kb), mPriorityIncrement(0.), mProcessDepth(0),
+          mProcessStamp(0), mProcessCounter(0),
+          m_archiveCapacity(DefaultArchiveCapacity), m_archivedDone(0),
+          m_archivedFailed(0), mResourcesVersion(0)
     {}
 
     /**
@@ -88,8 +219,59 @@ public:
                   const Activity::OutFct& out = Activity::OutFct(),
                   const Activity::AckFct& ack = Activity::AckFct());
 
+    /**
+     * @brief Remove an activity, its precedence constraints and its
+     * assigned resources.
+     * @param name the name of the activity
+     * @throw utils::ArgError if the activity does not exist.
+     */
     void remove(const std::string& name);
 
+    /**
+     * @brief Archive the DONE and FAILED activities that can no longer
+     * change: all their successors in the precedence graph are DONE or
+     * FAILED and they do not appear in the latest activities lists. The
+     * activities are removed with their precedence constraints and only
+     * a compact record is kept. An archived activity cannot be restarted
+     * nor added again while its record is kept.
+     *
+     * At most archiveCapacity() records are kept: the oldest records are
+     * dropped and only counted by archivedCount().
+     * @return the number of archived activities.
+     */
+    size_type archive();
+
+    /**
+     * @brief Set the maximum number of records of archived activities,
+     * 0 to keep only the counts. Drop the oldest records if needed.
+     */
+    void setArchiveCapacity(size_type capacity);
+
+    size_type archiveCapacity() const
+    { return m_archiveCapacity; }
+
+    /**
+     * @brief Returns the number of activities archived in a state since
+     * the beginning, dropped records included.
+     * @param state Activity::DONE or Activity::FAILED.
+     */
+    size_type archivedCount(Activity::State state) const
+    { return state == Activity::DONE ? m_archivedDone :
+            state == Activity::FAILED ? m_archivedFailed : 0; }
+
+    /**
+     * @brief Returns the kept records of the archived activities.
+     */
+    const archived_t& archived() const
+    { return m_archived; }
+
+    /**
+     * @brief Returns true if the record of an archived activity is kept.
+     * @param name the name of an activity
+     */
+    bool isArchived(const std::string& name) const
+    { return m_archived.find(name) != m_archived.end(); }
+
     void addPrecedenceConstraint(const PrecedenceConstraint& pc)
     { m_graph.add(pc); }
 
@@ -222,6 +404,14 @@ public:
     const PrecedencesGraph& precedencesGraph() const
     { return m_graph; }
 
+    /**
+     * @brief Get the observer of the changes of the activities. It is not
+     * part of the state of the activities and may be updated by the
+     * observations.
+     */
+    ActivitiesObserver& observer() const
+    { return m_observer; }
+
     const Activities::result_t& waitedAct() const
     { return m_waitedAct; }
     const Activities::result_t& startedAct() const
@@ -244,6 +434,13 @@ public:
     const Activities::result_t& latestEndedAct() const
     { return m_latestEndedAct; }
 
+    /**
+     * @brief The activities of the five latest lists, without duplicates
+     * and sorted by name. Maintained with the latest lists.
+     */
+    const Activities::result_t& latestChangedAct() const
+    { return m_latestChangedAct; }
+
     Activities::const_result_t beforeTimeHorizonAct(
         const devs::Time& lowerBound,
         const devs::Time& upperBound) const;
@@ -271,6 +468,8 @@ public:
                        Activities::iterator it);
     void updateLatestActivitiesList(Activities::result_t& lst,
                                     Activities::iterator it);
+    void addLatestAct(Activities::result_t& lst,
+                      Activities::iterator it);
 
     void clearLatestActivitiesLists();
 
@@ -278,12 +477,14 @@ public:
      * @brief free the resource
      * @param resourcename the name of te resource
      */
-    void setResourceAvailable(const std::string& resourcename)
-    {
-        mResourceAvailability[resourcename] = true;
-    }
+    void setResourceAvailable(const std::string& resourcename);
 
     /**
+     * @brief get the first available resources satisfying a resource
+     * expression, for example "Farmer + Worker.2 | Tractor". Each
+     * expression is compiled once into resource masks.
+     * @param resources the resource expression
+     * @return the resources names or an empty list.
      */
     ResourceSolution firstResources(const std::string& resources) const;
 
@@ -314,33 +515,13 @@ public:
      * @param resourcelist the list of resources
      */
     void getRessources(const std::string& activityname,
-                       const ResourceSolution& resourcelist)
-    {
-        for (ResourceSolution::const_iterator it = resourcelist.begin();
-             it != resourcelist.end(); it++) {
-            mResourceAvailability[*it] = false;
-            mActivitiesResources.insert(ActivityResource(activityname, *it));
-        }
-    }
+                       const ResourceSolution& resourcelist);
 
     /**
      * @brief free all the resource assigned to an activity
      * @param activityname the name of the activity
      */
-    void freeRessources(std::string activityname)
-    {
-        ActivitiesResourcesIteratorPair pit;
-
-        pit = mActivitiesResources.equal_range(activityname);
-        for (ActivitiesResourcesConstIterator it = pit.first; it != pit.second; ++it)
-        {
-            mResourceAvailability[(*it).second] = true;
-        }
-
-        while (mActivitiesResources.find(activityname) != mActivitiesResources.end()) {
-            mActivitiesResources.erase(mActivitiesResources.find(activityname));
-        }
-    }
+    void freeRessources(std::string activityname);
 
     /**
      * @brief returns a list of assigned resources
@@ -378,6 +559,8 @@ private:
 
     activities_t     m_lst;
     PrecedencesGraph m_graph;
+    std::vector < std::size_t > m_freeIndexes; /**< of removed activities. */
+    mutable ActivitiesObserver m_observer;
 
     Activities::result_t m_waitedAct;
     Activities::result_t m_startedAct;
@@ -390,10 +573,121 @@ private:
     Activities::result_t m_latestFailedAct;
     Activities::result_t m_latestFFAct;
     Activities::result_t m_latestEndedAct;
+    Activities::result_t m_latestChangedAct;
+
+    index_t m_activeAct; /**< Activities evaluated by process. */
+    wakeup_t m_wakeUpAct; /**< Sleeping WAIT activities by start date. */
+    sleeping_t m_sleepingAct; /**< Same as m_wakeUpAct, by name. */
+    index_t m_retiredFailedAct; /**< FAILED, not evaluated. */
+    index_t m_retiredEndedAct; /**< DONE, not evaluated. */
+    int mProcessDepth; /**< process can be called from update functions. */
+    unsigned long mProcessStamp; /**< of the current process call or 0. */
+    unsigned long mProcessCounter; /**< last stamp given. */
+
+    archived_t m_archived; /**< Records of the archived activities. */
+    std::deque < archived_t::iterator > m_archiveOrder; /**< oldest first. */
+    size_type m_archiveCapacity;
+    size_type m_archivedDone;
+    size_type m_archivedFailed;
 
     ResourceAvailability mResourceAvailability;
     ActivitiesResources mActivitiesResources;
 
+    /**
+     * @brief A compiled resource expression: a list of alternatives, each
+     * one a list of masks, one mask per resource to take.
+     */
+    typedef std::vector < std::vector < ResourceMask > > CompiledResources;
+    typedef std::map < std::string, CompiledResources > CompiledResourcesT;
+
+    mutable CompiledResourcesT mCompiledResources;
+    mutable ResourceMask mAvailableMask; /**< mResourceAvailability. */
+    mutable unsigned int mResourcesVersion; /**< of the masks. */
+
+    /**
+     * @brief Rebuild the masks if a resource was added to the knowledge
+     * base since the last call.
+     */
+    void syncResources() const;
+
+    const CompiledResources& compileResources(
+        const std::string& resources) const;
+
+    /**
+     * @brief Insert an activity into the sorted m_latestChangedAct list if
+     * it is not already there.
+     */
+    void addChangedAct(Activities::iterator it);
+
+    /**
+     * @brief Remove an activity from all the containers.
+     */
+    void erase(iterator it);
+
+    /**
+     * @brief Remove an activity from the index, the wake-up queue and the
+     * retired lists.
+     */
+    void unindex(iterator it);
+
+    /**
+     * @brief Returns true if the activity is in a latest activities list.
+     */
+    bool isLatest(iterator it) const;
+
+    /**
+     * @brief Returns true if all the successors of the activity are DONE
+     * or FAILED.
+     */
+    bool isResolved(iterator it) const;
+
+    /**
+     * @brief Earliest date where the time window of an activity opens,
+     * i.e. the date from which isBeforeTimeConstraint returns false.
+     */
+    static devs::Time wakeUpDate(const Activity& activity);
+
+    /**
+     * @brief Put an activity back into the index of activities evaluated
+     * by process. Called before any state change made outside process and
+     * by the activity when its dates or its rules change.
+     */
+    void touch(iterator it);
+
+    /**
+     * @brief Merge the activities of the process pass, at the end of the
+     * list, with the ones of the front not evaluated, to keep the list
+     * ordered by name.
+     * @param sorted false if the end of the list is not ordered by name.
+     */
+    static void mergeByName(result_t& lst, result_t::size_type front,
+                            bool sorted);
+
+    /**
+     * @brief Fill the list with the activities of the index, ordered by
+     * rank in the precedences graph then by name.
+     * @return true if the list is ordered by name.
+     */
+    bool topologicalOrder(result_t& order);
+
+    /**
+     * @brief Get an index for a new activity, see Activity::index.
+     */
+    std::size_t allocateIndex();
+
+    /**
+     * @brief Move the sleeping activities whose time window is open into
+     * the index of activities to evaluate.
+     */
+    void wakeUpActivities(const devs::Time& time);
+
+    /**
+     * @brief Remove from the index the activities that do not need
+     * evaluation anymore: DONE and FAILED activities are retired and WAIT
+     * activities before their time window are put into the wake-up queue.
+     */
+    void updateIndex(const devs::Time& time);
+
     Result processWaitState(iterator activity, const devs::Time& time);
     Result processStartedState(iterator activity, const devs::Time& time);
     Result processFFState(iterator activity, const devs::Time& time);
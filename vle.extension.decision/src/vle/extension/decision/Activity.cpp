@@ -108,6 +108,7 @@ void Activity::initStartTimeFinishTime(const devs::Time& start,
     m_date = (DateType)(Activity::START | Activity::FINISH);
     m_start = start;
     m_finish = finish;
+    changed();
 }
 
 void Activity::initStartTimeFinishRange(const devs::Time& start,
@@ -125,6 +126,7 @@ void Activity::initStartTimeFinishRange(const devs::Time& start,
     m_start = start;
     m_minfinish = minfinish;
     m_maxfinish = maxfinish;
+    changed();
 }
 
 void Activity::initStartRangeFinishTime(const devs::Time& minstart,
@@ -142,6 +144,7 @@ void Activity::initStartRangeFinishTime(const devs::Time& minstart,
     m_minstart = minstart;
     m_maxstart = maxstart;
     m_finish = finish;
+    changed();
 }
 
 void Activity::initStartRangeFinishRange(const devs::Time& minstart,
@@ -165,6 +168,7 @@ void Activity::initStartRangeFinishRange(const devs::Time& minstart,
     m_maxstart = maxstart;
     m_minfinish = minfinish;
     m_maxfinish = maxfinish;
+    changed();
 }
 
 devs::Time Activity::nextTime(const devs::Time& time)
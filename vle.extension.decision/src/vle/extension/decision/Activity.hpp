@@ -129,6 +129,12 @@ public:
         void (const std::string&,
               const Activity&) > UpdateFct;
 
+    /**
+     * @brief Function called when the dates or the rules of the activity
+     * change. Activities uses it to keep its indexes up to date.
+     */
+    typedef std::function < void () > ChangeFct;
+
     /** Defines the state of the temporal constraints. You can use multiple
      * value for a same DateType by combining the with operator|. For
      * instance:
@@ -174,7 +180,8 @@ public:
           m_hasRessources(true),
           m_priority(devs::negativeInfinity),
           m_neverfail(false),
-          m_neverfailifpcvalid(false)
+          m_neverfailifpcvalid(false),
+          m_index(0)
 
     {}
 
@@ -251,18 +258,42 @@ public:
     void update(const std::string& name)
     { if (mUpdateFct) { mUpdateFct(name, *this); } }
 
+    /**
+     * @brief Returns true if an update function is assigned.
+     */
+    bool hasUpdateFunction() const
+    { return (bool)mUpdateFct; }
+
     //
     // Settings the activity.
     //
 
     void addRule(const std::string& name, const Rule& rule)
-    { m_rules.add(name, rule); }
+    { m_rules.add(name, rule); changed(); }
 
     Rule& addRule(const std::string& name)
-    { return m_rules.add(name, Rule()); }
+    { changed(); return m_rules.add(name, Rule()); }
 
     void setRules(const Rules& rules)
-    { m_rules = rules; }
+    { m_rules = rules; changed(); }
+
+    /**
+     * @brief Assign the function called when the dates or the rules
+     * change. The function is not copied with the activity.
+     */
+    void setChangeFunction(const ChangeFct& fct)
+    { mChangeFct.fct = fct; }
+
+    /**
+     * @brief Get the index of the activity in its Activities container,
+     * used by the precedences graph. Indexes of removed activities are
+     * reused.
+     */
+    std::size_t index() const
+    { return m_index; }
+
+    void setIndex(std::size_t index)
+    { m_index = index; }
 
     const Rules& getRules() const
     { return m_rules; }
@@ -367,6 +398,21 @@ public:
     ActivityParameters& getParams() { return m_parameters; }
 
 private:
+    /**
+     * @brief Holds the change function, empty in the copies of the
+     * activity: a copy is not indexed by the Activities of the original.
+     */
+    struct ChangeListener
+    {
+        ChangeFct fct;
+
+        ChangeListener() {}
+        ChangeListener(const ChangeListener&) {}
+        ChangeListener& operator=(const ChangeListener&) { return *this; }
+    };
+
+    void changed() { if (mChangeFct.fct) { mChangeFct.fct(); } }
+
     void startedDate(const devs::Time& date) { m_started = date; }
     void ffDate(const devs::Time& date) { m_ff = date; }
     void doneDate(const devs::Time& date) { m_done = date; }
@@ -393,6 +439,7 @@ private:
     AckFct mAckFct;
     OutFct mOutFct;
     UpdateFct mUpdateFct;
+    ChangeListener mChangeFct;
 
     ActivityParameters m_parameters;
 
@@ -402,6 +449,8 @@ private:
 
     bool m_neverfail;
     bool m_neverfailifpcvalid;
+
+    std::size_t m_index;
 };
 
 inline std::ostream& operator<<(
@@ -27,6 +27,7 @@
 
 
 #include <vle/extension/decision/Agent.hpp>
+#include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
 #include <cassert>
 #include <sstream>
@@ -198,6 +199,22 @@ std::unique_ptr<vle::value::Value> Agent::observation(
         std::stringstream out;
         out << activities();
         return std::unique_ptr<vle::value::Value>(new value::String(out.str()));
+    } else if (port == "Activities(table)") {
+        return activitiesTable(event.getViewName(), false);
+    } else if (port == "Activities(changed)") {
+        return activitiesTable(event.getViewName(), true);
+    } else if (port == "Activities(names)") {
+        std::unique_ptr<value::Set> names(new value::Set());
+        for (const auto& name : activitiesObserver().names()) {
+            names->addString(name);
+        }
+        return std::move(names);
+    } else if ((port.compare(0, 16, "Activity(tuple)_") == 0) and port.size() > 16) {
+        std::string activity(port, 16, std::string::npos);
+        std::unique_ptr<value::Tuple> tuple(activityTuple(activity));
+        if (tuple) {
+            return std::move(tuple);
+        }
     } else if ((port.compare(0, 9, "Activity_") == 0) and port.size() > 9) {
         std::string activity(port, 9, std::string::npos);
         if (activities().exist(activity)) {
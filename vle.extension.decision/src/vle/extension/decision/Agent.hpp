@@ -123,7 +123,13 @@ public:
 
     /**
      * @brief Process an observation event: compute the current state of the
-     * model at a specified time and for a specified port.
+     * model at a specified time and for a specified port. The ports
+     * "KnowledgeBase", "Activities", "Activity_*" and "Activity(state)_*"
+     * return text. The ports "Activities(table)", "Activities(changed)" and
+     * "Activity(tuple)_*" return numeric snapshots (see
+     * KnowledgeBase::activitiesTable and KnowledgeBase::activityTuple)
+     * where activities are given by identifier; "Activities(names)"
+     * returns the names of the activities indexed by identifier.
      * @param event the state event with of the port
      * @return the value of state variable
      */
@@ -30,11 +30,197 @@
 #include <vle/utils/Tools.hpp>
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <iostream>
 
 
 namespace vle { namespace extension { namespace decision {
 
+void KnowledgeBase::indexResources() const
+{
+    if (mResourcesIndexed) {
+        return;
+    }
+
+    std::set < std::string > names;
+    for (Resources::const_iterator it = mResources.begin();
+         it != mResources.end(); ++it) {
+        names.insert(it->second.begin(), it->second.end());
+    }
+
+    mResourceNames.assign(names.begin(), names.end());
+    mResourceIds.clear();
+    for (std::size_t i = 0; i < mResourceNames.size(); ++i) {
+        mResourceIds[mResourceNames[i]] = i;
+    }
+
+    mClassMasks.clear();
+    for (Resources::const_iterator it = mResources.begin();
+         it != mResources.end(); ++it) {
+        ResourceMask mask(mResourceNames.size());
+        for (std::set < std::string >::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mask.set(mResourceIds[*jt]);
+        }
+        mClassMasks[it->first] = mask;
+    }
+
+    mResourcesIndexed = true;
+}
+
+ResourceMask KnowledgeBase::resourceMask(const std::string& type) const
+{
+    indexResources();
+
+    std::vector < std::string > strs;
+    vle::utils::tokenize(type, strs, "&", true);
+
+    if (strs.empty()) {
+        return ResourceMask(mResourceNames.size());
+    }
+
+    ResourceMask result;
+    for (std::size_t i = 0; i < strs.size(); ++i) {
+        std::map < std::string, ResourceMask >::const_iterator it =
+            mClassMasks.find(strs[i]);
+
+        if (it == mClassMasks.end()) {
+            return ResourceMask(mResourceNames.size());
+        }
+
+        if (i == 0) {
+            result = it->second;
+        } else {
+            result &= it->second;
+        }
+    }
+    return result;
+}
+
+std::size_t KnowledgeBase::resourceId(const std::string& name) const
+{
+    indexResources();
+
+    std::map < std::string, std::size_t >::const_iterator it =
+        mResourceIds.find(name);
+
+    return it == mResourceIds.end() ? ResourceMask::npos : it->second;
+}
+
+static void activityRow(value::Table& table, std::size_t row,
+                        unsigned int id, const Activity& act,
+                        std::ptrdiff_t resources)
+{
+    table.get(0, row) = id;
+    table.get(1, row) = act.state();
+    table.get(2, row) = act.startedDate();
+    table.get(3, row) = act.ffDate();
+    table.get(4, row) = act.doneDate();
+    table.get(5, row) = resources;
+}
+
+static void archivedRow(value::Table& table, std::size_t row,
+                        unsigned int id,
+                        const Activities::ArchivedActivity& act)
+{
+    table.get(0, row) = id;
+    table.get(1, row) = act.state;
+    table.get(2, row) = act.started;
+    table.get(3, row) = act.ff;
+    table.get(4, row) = act.done;
+    table.get(5, row) = 0;
+}
+
+std::unique_ptr < value::Table > KnowledgeBase::activitiesTable(
+    const std::string& view,
+    bool changed) const
+{
+    const Activities& acts = activities();
+    ActivitiesObserver& observer = acts.observer();
+    std::vector < unsigned int > ids;
+    std::unique_ptr < value::Table > result;
+    std::size_t row = 0;
+
+    if (changed and observer.observe(view, ids)) {
+        result.reset(new value::Table(6, ids.size()));
+
+        for (std::vector < unsigned int >::const_iterator it = ids.begin();
+             it != ids.end(); ++it) {
+            const std::string& name = observer.names()[*it];
+            if (acts.exist(name)) {
+                ActivitiesResourcesConstIteratorPair res =
+                    acts.resources(name);
+                activityRow(*result, row++, *it, acts.get(name)->second,
+                            std::distance(res.first, res.second));
+            } else {
+                Activities::archived_t::const_iterator arch =
+                    acts.archived().find(name);
+                if (arch != acts.archived().end()) {
+                    archivedRow(*result, row++, *it, arch->second);
+                }
+            }
+        }
+    } else {
+        result.reset(new value::Table(6, acts.size() +
+                                      acts.archived().size()));
+
+        for (Activities::const_iterator it = acts.begin(); it != acts.end();
+             ++it) {
+            ActivitiesResourcesConstIteratorPair res =
+                acts.resources(it->first);
+            activityRow(*result, row++,
+                        observer.id(it->second.index(), it->first),
+                        it->second, std::distance(res.first, res.second));
+        }
+
+        for (Activities::archived_t::const_iterator it =
+                 acts.archived().begin();
+             it != acts.archived().end(); ++it) {
+            archivedRow(*result, row++, observer.id(it->first), it->second);
+        }
+    }
+
+    result->resize(6, row);
+    return result;
+}
+
+std::unique_ptr < value::Tuple > KnowledgeBase::activityTuple(
+    const std::string& name) const
+{
+    ActivitiesObserver& observer = activities().observer();
+    std::unique_ptr < value::Tuple > result;
+
+    if (activities().exist(name)) {
+        const Activity& act = activities().get(name)->second;
+        ActivitiesResourcesConstIteratorPair res =
+            activities().resources(name);
+
+        result.reset(new value::Tuple());
+        result->add(observer.id(act.index(), name));
+        result->add(act.state());
+        result->add(act.startedDate());
+        result->add(act.ffDate());
+        result->add(act.doneDate());
+        for (; res.first != res.second; ++res.first) {
+            result->add(resourceId(res.first->second));
+        }
+    } else {
+        Activities::archived_t::const_iterator it =
+            activities().archived().find(name);
+
+        if (it != activities().archived().end()) {
+            result.reset(new value::Tuple());
+            result->add(observer.id(name));
+            result->add(it->second.state);
+            result->add(it->second.started);
+            result->add(it->second.ff);
+            result->add(it->second.done);
+        }
+    }
+
+    return result;
+}
+
 void KnowledgeBase::setActivityDone(const std::string& name,
                                     const devs::Time& date)
 {
@@ -49,6 +235,7 @@ void KnowledgeBase::setActivityDone(const std::string& name,
     mPlan.activities().setFFAct(it);
     it->second.ff(date);
     it->second.acknowledge(name);
+    invalidatePredicates();
 }
 
 void KnowledgeBase::setActivityFailed(const std::string& name,
@@ -65,6 +252,7 @@ void KnowledgeBase::setActivityFailed(const std::string& name,
         mPlan.activities().setFailedAct(it);
         it->second.fail(date);
         it->second.acknowledge(name);
+        invalidatePredicates();
     }
 }
 
@@ -82,6 +270,11 @@ devs::Time KnowledgeBase::duration(const devs::Time& time)
 
 KnowledgeBase::Result KnowledgeBase::processChanges(const devs::Time& time)
 {
+    if (time != mLastProcessTime) {
+        mPredicateDependencies->step();
+        mLastProcessTime = time;
+    }
+
     Activities::Result r = mPlan.activities().process(time);
     return std::make_pair(r.first, r.second);
 }
@@ -38,7 +38,10 @@
 #include <vle/extension/decision/Rules.hpp>
 #include <vle/extension/decision/Table.hpp>
 #include <vle/extension/decision/Plan.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
 #include <iostream>
+#include <memory>
 
 namespace vle { namespace extension { namespace decision {
 
@@ -245,7 +248,10 @@ public:
     typedef std::pair < bool, devs::Time > Result;
 
     KnowledgeBase(utils::ContextPtr ctxp)
-        : mPlan(ctxp, *this), mLibrary(ctxp, *this), mResourcesCheck(false)
+        : mPlan(ctxp, *this), mLibrary(ctxp, *this), mResourcesCheck(false),
+          mResourcesVersion(0), mResourcesIndexed(false),
+          mPredicateDependencies(std::make_shared < PredicateDependencies >()),
+          mLastProcessTime(devs::negativeInfinity)
     {}
 
     /**
@@ -273,6 +279,7 @@ public:
     {
         if (not resourceTypeExist(name)) {
             mResources[name].insert(name);
+            resourcesChanged();
             mPlan.activities().setResourceAvailable(name);
         } else {
             throw utils::ModellingError(
@@ -292,12 +299,14 @@ public:
     {
         if (not resourceTypeExist(name)) {
             mResources[name].insert(name);
+            resourcesChanged();
             mPlan.activities().setResourceAvailable(name);
         }
 
         std::string resource = type + "&" + name;
         if (not resourceTypeExist(resource)) {
             mResources[type].insert(name);
+            resourcesChanged();
             mPlan.activities().setResourceAvailable(name);
         } else {
             throw utils::ModellingError(
@@ -313,35 +322,7 @@ public:
      */
     bool resourceTypeExist(const std::string& type) const
     {
-        size_t n = std::count(type.begin(), type.end(), '&');
-        if ( n == 0 ) {
-            return mResources.find(type) != mResources.end();
-        } else {
-            std::vector<std::string> strs;
-            vle::utils::tokenize(type, strs, "&", true);
-
-            Resources::const_iterator its = mResources.find(strs[0]);
-
-            if ( its == mResources.end() ) {
-                return false;
-            }
-
-            std::vector< std::string > result (its->second.begin(),
-                                               its->second.end());
-            std::vector< std::string > buffer;
-            for (unsigned i = 1; i < strs.size(); i++) {
-                buffer.clear();
-                its = mResources.find(strs[i]);
-                std::set_intersection(result.begin(), result.end(),
-                                      its->second.begin(), its->second.end(),
-                                      std::back_inserter(buffer));
-                if (buffer.empty()) {
-                    return false;
-                }
-                swap(result, buffer);
-            }
-            return true;
-        }
+        return resourceMask(type).any();
     }
 
     /**
@@ -351,42 +332,57 @@ public:
      */
     ResourceSolution getResources (const std::string& type) const
     {
+        ResourceMask mask = resourceMask(type);
         ResourceSolution resources;
 
-        size_t n = std::count(type.begin(), type.end(), '&');
-        if ( n == 0 ) {
-            Resources::const_iterator pit;
+        for (std::size_t id = mask.findFirst(); id != ResourceMask::npos;
+             id = mask.findNext(id)) {
+            resources.push_back(mResourceNames[id]);
+        }
+        return resources;
+    }
 
-            pit = mResources.find(type);
+    /**
+     * @brief get the mask of the resources satisfying the combination of
+     * classes
+     * @param type a combination of classes separated by '&',
+     * for example "farmWorker & skilledWorker"
+     */
+    ResourceMask resourceMask(const std::string& type) const;
 
-            if (pit == mResources.end()) {
-                return {};
-            }
+    /**
+     * @brief get the identifier of a resource. Identifiers follow the
+     * order of the resource names and change when a resource is added
+     * (see resourcesVersion).
+     * @param name the name of the resource
+     * @return the identifier or ResourceMask::npos if unknown.
+     */
+    std::size_t resourceId(const std::string& name) const;
 
-            resources = std::vector< std::string > (pit->second.begin(),
-                                                    pit->second.end());
+    /**
+     * @brief get the name of a resource from its identifier.
+     */
+    const std::string& resourceName(std::size_t id) const
+    {
+        indexResources();
+        return mResourceNames[id];
+    }
 
-        } else {
-            std::vector<std::string> strs;
-            vle::utils::tokenize(type, strs, "&", true);
-            Resources::const_iterator its = mResources.find(strs[0]);
-            std::vector< std::string > result(its->second.begin(),
-                                              its->second.end());
-            std::vector< std::string > buffer;
-            for (unsigned i = 1; i < strs.size(); i++) {
-                buffer.clear();
-                its = mResources.find(strs[i]);
-                std::set_intersection(result.begin(), result.end(),
-                                      its->second.begin(), its->second.end(),
-                                      std::back_inserter(buffer));
-                if (buffer.empty()) {
-                    return resources;
-                }
-                swap(result, buffer);
-            }
-            resources = result;
-        }
-        return resources;
+    /**
+     * @brief get the number of resources.
+     */
+    std::size_t resourceCount() const
+    {
+        indexResources();
+        return mResourceNames.size();
+    }
+
+    /**
+     * @brief get a number incremented each time a resource is added.
+     */
+    unsigned int resourcesVersion() const
+    {
+        return mResourcesVersion;
     }
 
     /**
@@ -409,10 +405,10 @@ public:
      * @param fact
      */
     void addFact(const std::string& name, const Fact& fact)
-    { facts().add(name, fact); }
+    { mFactsTable.add(name, fact); }
 
     void addPortFact(const std::string& name, const PortFact& fact)
-    { portfacts().add(name, fact); }
+    { mPortFactsTable.add(name, fact); }
 
     std::string applyRes(const std::string& funcname,
                          const std::string& activityname,
@@ -427,13 +423,51 @@ public:
 
     void applyFact(const std::string& name, const value::Value& value)
     {
-        if  (facts().find(name) == facts().end()) {
-            portfacts()[name](name, value);
+        if  (mFactsTable.find(name) == mFactsTable.end()) {
+            mPortFactsTable[name](name, value);
         } else {
-            facts()[name](value);
+            mFactsTable[name](value);
         }
+        mPredicateDependencies->apply(name);
     }
 
+    /**
+     * @brief Invalidate the memoized predicates which depend on the fact.
+     * Call it when the value read by a fact is changed without applyFact.
+     * @param name the name of the fact.
+     */
+    void factChanged(const std::string& name)
+    { mPredicateDependencies->apply(name); }
+
+    /**
+     * @brief Invalidate all the memoized predicates. The knowledge base
+     * calls it after the acknowledge and update functions of the
+     * activities, which may change the values read by the facts.
+     */
+    void invalidatePredicates()
+    { mPredicateDependencies->step(); }
+
+    /**
+     * @brief Declare that a predicate function of the predicates table only
+     * depends on a fact (and on the current time). The results of the
+     * predicates built from this function in the plans are memoized by
+     * activity and rule until the fact is applied or the time changes.
+     * @param predicate the name of the predicate function.
+     * @param fact the name of the fact.
+     */
+    void addPredicateDependency(const std::string& predicate,
+                                const std::string& fact)
+    { mPredicateDependencies->add(predicate, fact); }
+
+    /**
+     * @brief Get the dependencies shared with the predicates of the plans.
+     * The predicates keep the returned handle, they remain valid if the
+     * knowledge base is moved or destroyed.
+     */
+    std::shared_ptr < const PredicateDependencies >
+    predicateDependencies() const
+    { return mPredicateDependencies; }
+
     Rule& addRule(const std::string& name)
     { return mPlan.rules().add(name); }
 
@@ -458,6 +492,53 @@ public:
     void removeActivity(const std::string& name)
     { mPlan.activities().remove(name); }
 
+    /**
+     * @brief Archive the activities that can no longer change to bound the
+     * cost of long-running agents. See Activities::archive.
+     * @return the number of archived activities.
+     */
+    Activities::size_type archiveActivities()
+    { return mPlan.activities().archive(); }
+
+    /**
+     * @brief Set the number of records of archived activities kept. See
+     * Activities::setArchiveCapacity.
+     */
+    void setArchiveCapacity(Activities::size_type capacity)
+    { mPlan.activities().setArchiveCapacity(capacity); }
+
+    /**
+     * @brief Build a snapshot of the activities, live and archived, with
+     * one row per activity and the columns: identifier, state, started,
+     * ff and done dates, number of assigned resources. Unset dates are
+     * negative infinity. The identifiers are the ones of
+     * activitiesObserver().
+     * @param view the name of the view.
+     * @param changed if true, only the activities whose state, dates or
+     * resources changed since the last observation of the view are kept,
+     * ordered by identifier. The first observation of a view keeps all
+     * the activities.
+     */
+    std::unique_ptr < value::Table > activitiesTable(
+        const std::string& view,
+        bool changed) const;
+
+    /**
+     * @brief Build a snapshot of an activity: identifier, state, started,
+     * ff and done dates followed by the identifiers of the assigned
+     * resources (see resourceId).
+     * @param name the name of the activity.
+     * @return the tuple or a null pointer if the activity is unknown.
+     */
+    std::unique_ptr < value::Tuple > activityTuple(
+        const std::string& name) const;
+
+    /**
+     * @brief Get the identifiers of the observed activities.
+     */
+    const ActivitiesObserver& activitiesObserver() const
+    { return activities().observer(); }
+
 
     /**
      * @brief The predecessor activity (i) must start before the successor
@@ -599,6 +680,13 @@ public:
     const Activities::result_t& latestEndedActivities() const
     { return mPlan.activities().latestEndedAct(); }
 
+    /**
+     * @brief Get the activities of the latest lists (waited, started,
+     * failed, done and ended) without duplicates and sorted by name.
+     */
+    const Activities::result_t& latestChangedActivities() const
+    { return mPlan.activities().latestChangedAct(); }
+
     /**
      * @brief Return true if at least on list of activities (waited, started,
      * failed, done or ended lists) is not empty.
@@ -665,14 +753,16 @@ public:
     { return mRessTable; }
 
     /**
-     * @brief Get the table of available facts.
+     * @brief Get the table of available facts. The facts may be applied
+     * through the returned table, so all the memoized predicates are
+     * invalidated: prefer the constant version or applyFact().
      * @return Table of available facts.
      */
     FactsTable& facts()
-    { return mFactsTable; }
+    { invalidatePredicates(); return mFactsTable; }
 
     PortFactsTable& portfacts()
-    { return mPortFactsTable; }
+    { invalidatePredicates(); return mPortFactsTable; }
 
     /**
      * @brief Get the table of available predicates.
@@ -830,14 +920,32 @@ private:
     bool mResourcesCheck;
 
     Resources mResources;
+    unsigned int mResourcesVersion;
+    mutable bool mResourcesIndexed;
+    mutable std::vector < std::string > mResourceNames;
+    mutable std::map < std::string, std::size_t > mResourceIds;
+    mutable std::map < std::string, ResourceMask > mClassMasks;
     RessTable mRessTable;
     FactsTable mFactsTable;
     PortFactsTable mPortFactsTable;
     PredicatesTable mPredicatesTable;
+    std::shared_ptr < PredicateDependencies > mPredicateDependencies;
+    devs::Time mLastProcessTime;
     AcknowledgeFunctions mAckFunctions;
     OutputFunctions mOutFunctions;
     UpdateFunctions mUpdateFunctions;
 
+    void resourcesChanged()
+    {
+        ++mResourcesVersion;
+        mResourcesIndexed = false;
+    }
+
+    /**
+     * @brief Builds the resource identifiers and the mask of each class.
+     */
+    void indexResources() const;
+
     static void unionLists(Activities::result_t& last,
                            Activities::result_t& recent);
 };
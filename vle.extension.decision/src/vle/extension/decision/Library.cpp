@@ -61,4 +61,28 @@ void Library::add(const std::string& name, std::istream& stream)
     }
 }
 
+const utils::Block& Library::addTemplate(const std::string& name,
+                                         std::istream& stream)
+{
+    std::shared_ptr < const utils::Parser > parser;
+
+    try {
+        parser = std::make_shared < const utils::Parser >(stream);
+    } catch (const std::exception& e) {
+        throw utils::ArgError(vle::utils::format("Decision plan error: %s",
+                                                 e.what()));
+    }
+
+    std::pair < TemplatesT::iterator, bool > r;
+    r = mTemplates.insert(std::make_pair(name, parser));
+
+    if (not r.second) {
+        throw utils::ArgError(
+            vle::utils::format("Decision: plan library, template `%s' already"
+                               " exists", name.c_str()));
+    }
+
+    return parser->root();
+}
+
 }}} // namespace vle model decision
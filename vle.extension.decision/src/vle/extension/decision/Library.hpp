@@ -33,8 +33,10 @@
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Context.hpp>
+#include <vle/utils/Parser.hpp>
 #include <string>
 #include <map>
+#include <memory>
 
 namespace vle { namespace extension { namespace decision {
 
@@ -48,6 +50,8 @@ public:
     typedef LibraryT::const_iterator const_iterator;
     typedef LibraryT::iterator iterator;
     typedef LibraryT::size_type size_type;
+    typedef std::map < std::string,
+            std::shared_ptr < const utils::Parser > > TemplatesT;
 
     Library(utils::ContextPtr ctxp, KnowledgeBase& kb)
         : ctx(ctxp), mKb(kb)
@@ -123,6 +127,40 @@ public:
         return mLst.find(name);
     }
 
+    /**
+     * @brief Parse a plan once and store its syntax tree. The template is
+     * instantiated with Plan::instantiate at any date with any suffix
+     * without reading and parsing the plan again.
+     * @param name, the name of the template (e.g. the plan file path)
+     * @param stream, stream containing the representation of the plan
+     * @return the syntax tree of the plan.
+     */
+    const utils::Block& addTemplate(const std::string& name,
+                                    std::istream& stream);
+
+    /**
+     * @brief Get the syntax tree of a parsed plan.
+     * @param name, the name of the template
+     * @throw utils::ArgError if the template is unknown.
+     */
+    const utils::Block& getTemplate(const std::string& name) const
+    {
+        TemplatesT::const_iterator it = mTemplates.find(name);
+
+        if (it == mTemplates.end()) {
+            throw utils::ArgError(
+                vle::utils::format("Decision: plan library, template `%s' is"
+                                   " unknown", name.c_str()));
+        }
+
+        return it->second->root();
+    }
+
+    bool existTemplate(const std::string& name) const
+    {
+        return mTemplates.find(name) != mTemplates.end();
+    }
+
     iterator begin() { return mLst.begin(); }
     const_iterator begin() const { return mLst.begin(); }
     iterator end() { return mLst.end(); }
@@ -132,6 +170,7 @@ public:
 private:
     utils::ContextPtr ctx;
     LibraryT mLst;
+    TemplatesT mTemplates;
     KnowledgeBase& mKb;
 };
 
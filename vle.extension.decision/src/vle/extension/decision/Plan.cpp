@@ -119,6 +119,17 @@ void Plan::fill(std::istream& stream, const devs::Time& loadTime,
     }
 }
 
+void Plan::instantiate(const utils::Block& root, const devs::Time& loadTime,
+                       const std::string suffixe, double addPriority)
+{
+    try {
+        fill(root, loadTime, suffixe, addPriority);
+    } catch (const std::exception& e) {
+        throw utils::ArgError(vle::utils::format("Decision plan error: %s",
+                                                 e.what()));
+    }
+}
+
 void Plan::fill(const std::string& buffer)
 {
     try {
@@ -207,6 +218,8 @@ void __fill_predicate(utils::ContextPtr ctx,
                       const utils::Block::BlocksResult& root,
                       Predicates& predicates,
                       const PredicatesTable& table,
+                      const std::shared_ptr < const PredicateDependencies >&
+                      dependencies,
                       const devs::Time& loadTime,
                       const std::string suffixe)
 {
@@ -233,7 +246,9 @@ void __fill_predicate(utils::ContextPtr ctx,
                 vd::Trace(ctx, 6, "predicate %s added",
                       (id.first->second + suffixe).c_str());
 
-                predicates.add(id.first->second + suffixe, fctit->second);
+                predicates.add(id.first->second + suffixe, fctit->second,
+                               PredicateParameters(), type.first->second,
+                               dependencies);
             } else {
                 PredicateParameters params;
 
@@ -258,7 +273,8 @@ void __fill_predicate(utils::ContextPtr ctx,
                     params.resetDouble("planTimeStamp", loadTime);
                 }
 
-                predicates.add(id.first->second + suffixe, fctit->second, params);
+                predicates.add(id.first->second + suffixe, fctit->second, params,
+                               type.first->second, dependencies);
             }
         } else {
             vd::Trace(ctx, 4, "Predicate %s already exists, we forget the new",
@@ -282,7 +298,8 @@ void Plan::fill(const utils::Block& root, const devs::Time& loadTime,
 
     for (it = mainpredicates.first; it != mainpredicates.second; ++it)
         __fill_predicate(ctx, it->second.blocks.equal_range("predicate"),
-                         mPredicates, mKb.predicates(), loadTime, suffixe);
+                         mPredicates, mKb.predicates(),
+                         mKb.predicateDependencies(), loadTime, suffixe);
 
     for (it = mainrules.first; it != mainrules.second; ++it) {
         utils::Block::BlocksResult rules;
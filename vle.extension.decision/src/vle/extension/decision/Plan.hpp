@@ -110,6 +110,15 @@ public:
     void fill(std::istream& stream, const devs::Time& loadTime,
               const std::string suffixe, double addPriority = 0.);
 
+    /**
+     * @brief Fill a plan from a parsed plan (see Library::addTemplate)
+     * @param root, the syntax tree of the plan
+     * @param loadTime, the time of plan loading.
+     * @param suffixe, the suffix added to rules and activities names.
+     */
+    void instantiate(const utils::Block& root, const devs::Time& loadTime,
+                     const std::string suffixe, double addPriority = 0.);
+
     const Rules& rules() const { return mRules; }
     const Activities& activities() const { return mActivities; }
     Rules& rules() { return mRules; }
@@ -29,13 +29,142 @@
 #include <vle/extension/decision/PrecedencesGraph.hpp>
 #include <vle/utils/Algo.hpp>
 #include <vle/utils/Tools.hpp>
+#include <algorithm>
 #include <iterator>
 
 namespace vle { namespace extension { namespace decision {
 
+const PrecedencesGraph::Precedences PrecedencesGraph::m_empty;
+
 void PrecedencesGraph::add(const PrecedenceConstraint& p)
 {
-    m_lstin.insert(p);
+    std::size_t first = p.first()->second.index();
+    std::size_t second = p.second()->second.index();
+    if (std::max(first, second) >= m_nodes.size()) {
+        m_nodes.resize(std::max(first, second) + 1);
+    }
+
+    Node& successor = m_nodes[second];
+    successor.in.push_back(p);
+    successor.stamp = 0;
+
+    m_nodes[first].out.push_back(p);
+    ++m_size;
+    m_ranked = false;
+}
+
+static bool sameConstraint(const PrecedenceConstraint& x,
+                           const PrecedenceConstraint& y)
+{
+    return x.first() == y.first() and x.second() == y.second() and
+        x.type() == y.type() and x.mintimelag() == y.mintimelag() and
+        x.maxtimelag() == y.maxtimelag();
+}
+
+static void eraseConstraint(PrecedencesGraph::Precedences& lst,
+                            const PrecedenceConstraint& p)
+{
+    for (PrecedencesGraph::Precedences::iterator it = lst.begin();
+         it != lst.end(); ++it) {
+        if (sameConstraint(*it, p)) {
+            lst.erase(it);
+            return;
+        }
+    }
+}
+
+void PrecedencesGraph::remove(PrecedenceConstraint::iterator activity)
+{
+    std::size_t i = activity->second.index();
+    if (i >= m_nodes.size() or m_nodes[i].empty()) {
+        return;
+    }
+
+    Node& node = m_nodes[i];
+    for (iteratorIn jt = node.in.begin(); jt != node.in.end(); ++jt) {
+        if (jt->first() != activity) {
+            eraseConstraint(m_nodes[jt->first()->second.index()].out, *jt);
+        }
+        --m_size;
+    }
+
+    for (iteratorOut jt = node.out.begin(); jt != node.out.end(); ++jt) {
+        if (jt->second() != activity) {
+            Node& successor = m_nodes[jt->second()->second.index()];
+            eraseConstraint(successor.in, *jt);
+            successor.stamp = 0;
+            --m_size;
+        }
+    }
+
+    node = Node();
+    while (not m_nodes.empty() and m_nodes.back().empty()) {
+        m_nodes.pop_back();
+    }
+    m_ranked = false;
+}
+
+void PrecedencesGraph::invalidate(PrecedenceConstraint::iterator activity)
+{
+    std::size_t i = activity->second.index();
+    if (i >= m_nodes.size()) {
+        return;
+    }
+
+    m_nodes[i].stamp = 0;
+    for (iteratorOut jt = m_nodes[i].out.begin(); jt != m_nodes[i].out.end();
+         ++jt) {
+        m_nodes[jt->second()->second.index()].stamp = 0;
+    }
+}
+
+void PrecedencesGraph::rankNodes() const
+{
+    std::vector < std::size_t > degree(m_nodes.size(), 0);
+    std::vector < std::size_t > ready;
+    m_ranks.assign(m_nodes.size(), 0);
+
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        for (iteratorIn jt = m_nodes[i].in.begin();
+             jt != m_nodes[i].in.end(); ++jt) {
+            if (jt->first()->second.index() != i) {
+                ++degree[i];
+            }
+        }
+        if (degree[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    std::size_t ranked = 0;
+    m_maxRank = 0;
+    while (not ready.empty()) {
+        std::size_t i = ready.back();
+        ready.pop_back();
+        ++ranked;
+        m_maxRank = std::max(m_maxRank, m_ranks[i]);
+
+        for (iteratorOut jt = m_nodes[i].out.begin();
+             jt != m_nodes[i].out.end(); ++jt) {
+            std::size_t j = jt->second()->second.index();
+            if (j != i) {
+                m_ranks[j] = std::max(m_ranks[j], m_ranks[i] + 1);
+                if (--degree[j] == 0) {
+                    ready.push_back(j);
+                }
+            }
+        }
+    }
+
+    if (ranked != m_nodes.size()) {
+        ++m_maxRank;
+        for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+            if (degree[i] != 0) {
+                m_ranks[i] = m_maxRank;
+            }
+        }
+    }
+    m_ranked = true;
 }
 
 }}} // namespace vle model decision
@@ -30,66 +30,164 @@
 #define VLE_EXT_DECISION_PRECEDENCESGRAPH_HPP
 
 #include <vle/extension/decision/PrecedenceConstraint.hpp>
-#include <set>
+#include <vector>
 
 namespace vle { namespace extension { namespace decision {
 
+/**
+ * @brief The precedence constraints stored as adjacency lists: each
+ * activity keeps the constraints with its predecessors (in) and with its
+ * successors (out), in insertion order. The nodes are stored in a vector,
+ * by index of activity (see Activity::index).
+ */
 class PrecedencesGraph
 {
 public:
-    typedef std::multiset < PrecedenceConstraint,
-            PrecedenceConstraintCompareFirst > PrecedencesOut;
-
-    typedef std::multiset < PrecedenceConstraint,
-            PrecedenceConstraintCompareSecond > PrecedencesIn;
+    typedef std::vector < PrecedenceConstraint > Precedences;
 
-    typedef PrecedencesIn::iterator iteratorIn;
-    typedef PrecedencesOut::iterator iteratorOut;
+    typedef Precedences::const_iterator iteratorIn;
+    typedef Precedences::const_iterator iteratorOut;
 
     typedef std::pair < iteratorIn, iteratorIn > findIn;
     typedef std::pair < iteratorOut, iteratorOut > findOut;
 
+    /**
+     * @brief The constraints of an activity and the cached result of the
+     * evaluation of its predecessors constraints (see
+     * Activities::stateFromGraph). The cache is valid while the stamp is
+     * the one of the current Activities::process call.
+     */
+    struct Node
+    {
+        Node()
+            : stamp(0), state(Activity::WAIT)
+        {}
+
+        bool empty() const { return in.empty() and out.empty(); }
+
+        Precedences in;
+        Precedences out;
+
+        unsigned long stamp;
+        Activity::State state;
+        PrecedenceConstraint::Result status;
+    };
+
+    typedef std::vector < Node > Nodes;
+
+    PrecedencesGraph()
+        : m_size(0), m_ranked(true), m_maxRank(0)
+    {}
+
     void add(const PrecedenceConstraint& p);
 
+    /**
+     * @brief Remove all the precedence constraints where the activity is
+     * the predecessor or the successor.
+     * @param activity The activity to remove from the graph.
+     */
+    void remove(PrecedenceConstraint::iterator activity);
+
     findIn
         findPrecedenceIn(PrecedenceConstraint::iterator activity) const
         {
-            return m_lstin.equal_range(
-                PrecedenceConstraint(activity, activity,
-                                     PrecedenceConstraint::FS,
-                                     0.0, 0.0));
+            std::size_t i = activity->second.index();
+            if (i >= m_nodes.size()) {
+                return findIn(m_empty.end(), m_empty.end());
+            }
+            return findIn(m_nodes[i].in.begin(), m_nodes[i].in.end());
         }
 
     findOut
         findPrecedenceOut(PrecedenceConstraint::iterator activity) const
         {
-            return m_lstout.equal_range(
-                PrecedenceConstraint(activity, activity,
-                                     PrecedenceConstraint::FS,
-                                     0.0, 0.0));
+            std::size_t i = activity->second.index();
+            if (i >= m_nodes.size()) {
+                return findOut(m_empty.end(), m_empty.end());
+            }
+            return findOut(m_nodes[i].out.begin(), m_nodes[i].out.end());
+        }
+
+    /**
+     * @brief Get the node of an activity or null if the activity has no
+     * constraint.
+     */
+    Node* node(PrecedenceConstraint::iterator activity)
+    {
+        std::size_t i = activity->second.index();
+        return i < m_nodes.size() and not m_nodes[i].empty() ?
+            &m_nodes[i] : 0;
+    }
+
+    /**
+     * @brief Invalidate the cached status of the successors of an
+     * activity and of the activity itself.
+     */
+    void invalidate(PrecedenceConstraint::iterator activity);
+
+    /**
+     * @brief Get the rank of the activity in a topological order of the
+     * graph: 0 without predecessor, otherwise one more than the highest
+     * rank of its predecessors. The activities of a cycle, and their
+     * successors, have no order and get the highest rank. The ranks are
+     * computed again after a change of the constraints.
+     */
+    std::size_t rank(PrecedenceConstraint::iterator activity) const
+    {
+        std::size_t i = activity->second.index();
+        if (i >= m_nodes.size()) {
+            return 0;
+        }
+        if (not m_ranked) {
+            rankNodes();
+        }
+        return m_ranks[i];
+    }
+
+    /**
+     * @brief Get the highest rank of the activities.
+     */
+    std::size_t maxRank() const
+    {
+        if (not m_ranked) {
+            rankNodes();
         }
+        return m_maxRank;
+    }
 
-    const PrecedencesIn& in() const { return m_lstin; }
-    const PrecedencesOut& out() const { return m_lstout; }
+    const Nodes& nodes() const { return m_nodes; }
+    Precedences::size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
 
 private:
-    /** Defines the constraints. */
-    PrecedencesIn m_lstin;
-    PrecedencesOut m_lstout;
+    void rankNodes() const;
+
+    Nodes m_nodes;
+    Precedences::size_type m_size;
+    mutable std::vector < std::size_t > m_ranks; /**< by node. */
+    mutable bool m_ranked;
+    mutable std::size_t m_maxRank;
+    static const Precedences m_empty;
 };
 
 inline std::ostream&
 operator<<(std::ostream& o, const PrecedencesGraph& p)
 {
     o << "PrecedencesGraph:\n1) Out list:\n";
-    for (PrecedencesGraph::iteratorOut i = p.in().begin();
-         i != p.in().end(); ++i) {
-        o << "- (" << (*i) << ")\n";
+    for (PrecedencesGraph::Nodes::const_iterator n = p.nodes().begin();
+         n != p.nodes().end(); ++n) {
+        for (PrecedencesGraph::iteratorOut i = n->out.begin();
+             i != n->out.end(); ++i) {
+            o << "- (" << (*i) << ")\n";
+        }
     }
     o << "PrecedencesGraph:\n1) In list:\n";
-    for (PrecedencesGraph::iteratorIn i = p.out().begin();
-         i != p.out().end(); ++i) {
-        o << "- (" << (*i) << ")\n";
+    for (PrecedencesGraph::Nodes::const_iterator n = p.nodes().begin();
+         n != p.nodes().end(); ++n) {
+        for (PrecedencesGraph::iteratorIn i = n->in.begin();
+             i != n->in.end(); ++i) {
+            o << "- (" << (*i) << ")\n";
+        }
     }
     return o << "\n";
 }
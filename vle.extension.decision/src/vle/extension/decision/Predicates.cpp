@@ -28,6 +28,7 @@
 
 #include <vle/extension/decision/Predicates.hpp>
 #include <vle/utils/Exception.hpp>
+#include <algorithm>
 
 namespace vle { namespace extension { namespace decision {
 
@@ -88,4 +89,58 @@ std::string PredicateParameters::getString(const std::string& name) const
 
 }
 
+void PredicateDependencies::add(const std::string& function,
+                                const std::string& fact)
+{
+    m_facts[fact].insert(function);
+    m_versions.insert(std::make_pair(function, m_clock));
+}
+
+void PredicateDependencies::apply(const std::string& fact)
+{
+    auto it = m_facts.find(fact);
+    if (it == m_facts.end())
+        return;
+
+    ++m_clock;
+    for (const auto& function : it->second)
+        m_versions[function] = m_clock;
+}
+
+void PredicateDependencies::step()
+{
+    m_step = ++m_clock;
+}
+
+PredicateDependencies::version_type
+PredicateDependencies::version(const std::string& function) const
+{
+    auto it = m_versions.find(function);
+    if (it == m_versions.end())
+        return m_step;
+
+    return std::max(m_step, it->second);
+}
+
+bool Predicate::isAvailableMemoized(const std::string& activity,
+                                    const std::string& rule) const
+{
+    PredicateDependencies::version_type version =
+        m_dependencies->version(m_type);
+
+    if (version != m_version) {
+        m_cache.clear();
+        m_version = version;
+    }
+
+    auto& results = m_cache[activity];
+    auto it = results.find(rule);
+    if (it != results.end())
+        return it->second;
+
+    bool result = m_function(activity, rule, m_parameters);
+    results.insert(std::make_pair(rule, result));
+    return result;
+}
+
 }}} // namespace vle model decision
@@ -34,9 +34,12 @@
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Exception.hpp>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <unordered_set>
 #include <unordered_map>
+#include <set>
+#include <string>
 #include "Parameter.hpp"
 
 namespace bx = baryonyx;
@@ -116,6 +119,61 @@ typedef std::function <bool (const std::string& activity,
                              const std::string& rule,
                              const PredicateParameters& params)> PredicateFunction;
 
+/**
+ * @brief Links the predicate functions of the knowledge base to the facts
+ * they read. The result of a predicate whose function has dependencies is
+ * memoized by activity and rule until one of these facts is applied or
+ * until the time step changes. The knowledge base shares it with its
+ * predicates through a std::shared_ptr.
+ */
+class PredicateDependencies
+{
+public:
+    typedef unsigned long version_type;
+
+    PredicateDependencies()
+        : m_clock(0), m_step(0)
+    {}
+
+    /**
+     * @brief Declare that the predicate function only reads the fact
+     * (and the current time).
+     * @param function the name of the function in the predicates table.
+     * @param fact the name of the fact.
+     */
+    void add(const std::string& function, const std::string& fact);
+
+    /**
+     * @brief Returns true if the function has dependencies.
+     */
+    bool exist(const std::string& function) const
+    { return m_versions.find(function) != m_versions.end(); }
+
+    /**
+     * @brief Invalidate the results of the functions which depend on the
+     * fact.
+     */
+    void apply(const std::string& fact);
+
+    /**
+     * @brief Invalidate all the results, at a new time step or when
+     * unknown facts may have changed.
+     */
+    void step();
+
+    /**
+     * @brief Returns a number which changes each time the results of the
+     * function are invalidated.
+     */
+    version_type version(const std::string& function) const;
+
+private:
+    std::unordered_map < std::string, std::set < std::string > > m_facts;
+    std::unordered_map < std::string, version_type > m_versions;
+    version_type m_clock;
+    version_type m_step;
+};
+
 class Predicate
 {
 public:
@@ -127,6 +185,23 @@ public:
         , m_parameters(params)
     {}
 
+    /**
+     * @brief Build a predicate from the function `type' of the predicates
+     * table. If the function has dependencies, the results are memoized.
+     */
+    Predicate(const std::string& name,
+              const PredicateFunction& function,
+              const PredicateParameters& params,
+              const std::string& type,
+              const std::shared_ptr < const PredicateDependencies >&
+              dependencies)
+        : m_name(name)
+        , m_function(function)
+        , m_parameters(params)
+        , m_type(type)
+        , m_dependencies(dependencies)
+    {}
+
     Predicate(const std::string& name,
               const PredicateFunction& function)
         : m_name(name)
@@ -140,17 +215,31 @@ public:
     bool isAvailable(const std::string& activity,
                      const std::string& rule) const
     {
-        return m_function(activity, rule, m_parameters);
+        if (not m_dependencies or not m_dependencies->exist(m_type))
+            return m_function(activity, rule, m_parameters);
+
+        return isAvailableMemoized(activity, rule);
     }
 
     const std::string& name() const { return m_name; }
     const PredicateFunction& function() const { return m_function; }
     const PredicateParameters& params() const { return m_parameters; }
+    const std::string& type() const { return m_type; }
 
 private:
+    typedef std::unordered_map < std::string,
+            std::unordered_map < std::string, bool > > cache_type;
+
+    bool isAvailableMemoized(const std::string& activity,
+                             const std::string& rule) const;
+
     std::string         m_name;
     PredicateFunction   m_function;
     PredicateParameters m_parameters;
+    std::string         m_type;
+    std::shared_ptr < const PredicateDependencies > m_dependencies;
+    mutable PredicateDependencies::version_type m_version = 0;
+    mutable cache_type  m_cache;
 };
 
 struct PredicateEqual
@@ -211,6 +300,15 @@ public:
         return m_lst.insert(Predicate(name, function, params)).second;
     }
 
+    bool add(const std::string& name, const PredicateFunction& function,
+             const PredicateParameters& params, const std::string& type,
+             const std::shared_ptr < const PredicateDependencies >&
+             dependencies)
+    {
+        return m_lst.insert(Predicate(name, function, params, type,
+                                      dependencies)).second;
+    }
+
     bool exist(const std::string& name) const
     {
         return find(name) != end();
@@ -32,6 +32,10 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
 
 namespace vle { namespace extension { namespace decision {
 
@@ -59,6 +63,121 @@ typedef std::pair < ActivitiesResourcesIterator,
 typedef std::pair < ActivitiesResourcesConstIterator,
                     ActivitiesResourcesConstIterator> ActivitiesResourcesConstIteratorPair;
 
+/**
+ * @brief A set of resources identifiers stored as a bitset. The
+ * identifiers are given by the KnowledgeBase (see
+ * KnowledgeBase::resourceId).
+ */
+class ResourceMask
+{
+public:
+    typedef std::uint64_t word_type;
+
+    static const std::size_t npos = static_cast < std::size_t >(-1);
+
+    ResourceMask()
+    {}
+
+    explicit ResourceMask(std::size_t size)
+        : m_words((size + word_size - 1) / word_size, 0)
+    {}
+
+    void set(std::size_t id)
+    {
+        if (id / word_size >= m_words.size()) {
+            m_words.resize(id / word_size + 1, 0);
+        }
+        m_words[id / word_size] |= word_type(1) << (id % word_size);
+    }
+
+    void reset(std::size_t id)
+    {
+        if (id / word_size < m_words.size()) {
+            m_words[id / word_size] &= ~(word_type(1) << (id % word_size));
+        }
+    }
+
+    bool test(std::size_t id) const
+    {
+        return id / word_size < m_words.size() and
+            (m_words[id / word_size] >> (id % word_size)) & 1;
+    }
+
+    bool any() const
+    {
+        for (std::size_t i = 0; i < m_words.size(); ++i) {
+            if (m_words[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t count() const
+    {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < m_words.size(); ++i) {
+            for (word_type w = m_words[i]; w; w &= w - 1) {
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    ResourceMask& operator&=(const ResourceMask& other)
+    {
+        for (std::size_t i = 0; i < m_words.size(); ++i) {
+            m_words[i] &= i < other.m_words.size() ? other.m_words[i] : 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the lowest identifier set in both masks or npos.
+     */
+    std::size_t findFirst(const ResourceMask& other) const
+    {
+        std::size_t size = std::min(m_words.size(), other.m_words.size());
+        for (std::size_t i = 0; i < size; ++i) {
+            word_type w = m_words[i] & other.m_words[i];
+            if (w) {
+                std::size_t bit = 0;
+                while (not ((w >> bit) & 1)) {
+                    ++bit;
+                }
+                return i * word_size + bit;
+            }
+        }
+        return npos;
+    }
+
+    /**
+     * @brief Returns the lowest identifier set or npos.
+     */
+    std::size_t findFirst() const
+    {
+        return findFirst(*this);
+    }
+
+    /**
+     * @brief Returns the lowest identifier set greater than id or npos.
+     */
+    std::size_t findNext(std::size_t id) const
+    {
+        for (std::size_t i = id + 1; i < m_words.size() * word_size; ++i) {
+            if (test(i)) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+private:
+    static const std::size_t word_size = 64;
+
+    std::vector < word_type > m_words;
+};
+
 }}} // namespace vle model decision
 
 #endif
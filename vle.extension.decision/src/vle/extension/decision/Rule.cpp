@@ -58,7 +58,7 @@ bool Rule::isAvailable(const std::string& activity,
             return false;
 
     if (not m_predicates_function.empty()) {
-        PredicateParameters empty;
+        static const PredicateParameters empty;
 
         for (size_t i = 0, e = m_predicates_function.size(); i != e; ++i)
             if (not m_predicates_function[i](activity, rule, empty))
@@ -226,6 +226,35 @@ public:
     virtual ~KB4() {}
 };
 
+class KB6 : public vmd::KnowledgeBase
+{
+public:
+    KB6(vle::utils::ContextPtr ctxp)
+        : vmd::KnowledgeBase(ctxp)
+    {
+        addActivity("A", 0.0, 10.0);
+        addActivity("B", 5.0, 10.0);
+        addActivity("C", 20.0, 30.0);
+    }
+
+    virtual ~KB6() {}
+};
+
+class KB7 : public vmd::KnowledgeBase
+{
+public:
+    KB7(vle::utils::ContextPtr ctxp)
+        : vmd::KnowledgeBase(ctxp)
+    {
+        addActivity("A", 0.0, 10.0);
+        addActivity("B", 0.0, 10.0);
+        addActivity("C", 0.0, 10.0);
+        addFinishToStartConstraint("A", "B", 0.0, 10.0);
+    }
+
+    virtual ~KB7() {}
+};
+
 class KB5 : public vmd::KnowledgeBase
 {
     int mNbUpdate, mNbAck, mNbOut;
@@ -558,6 +587,280 @@ void ActivitiesnextDate2()
     base.setActivityDone("F", 4.5);
 }
 
+void ActivitiesWakeUp()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    vmd::ex::KB6 base(ctxp);
+
+    vmd::KnowledgeBase::Result r = base.processChanges(0.);
+    EnsuresApproximatelyEqual((double)r.second, 5., 1e-10);
+    EnsuresEqual(base.startedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.waitedActivities().size(),
+                 vmd::Activities::result_t::size_type(2));
+
+    EnsuresEqual(base.latestChangedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+
+    base.setActivityDone("A", 1.);
+    r = base.processChanges(1.);
+    EnsuresApproximatelyEqual((double)r.second, 5., 1e-10);
+    EnsuresEqual(base.latestChangedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.latestChangedActivities().front()->first, "A");
+    base.clearLatestActivitiesLists();
+    Ensures(base.latestChangedActivities().empty());
+    EnsuresEqual(base.endedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.waitedActivities().size(),
+                 vmd::Activities::result_t::size_type(2));
+
+    base.processChanges(5.);
+    EnsuresEqual(base.startedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.waitedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.endedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+
+    base.processChanges(21.);
+    EnsuresEqual(base.startedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.waitedActivities().size(),
+                 vmd::Activities::result_t::size_type(0));
+    EnsuresEqual(base.failedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    EnsuresEqual(base.endedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+}
+
+void ActivitiesWakeUpDates()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    vmd::KnowledgeBase base(ctxp);
+    base.addActivity("A", 5.0, 10.0);
+    base.addActivity("B", 0.0, 10.0);
+    base.addActivity("C", 3.0, 10.0);
+    base.addActivity("D", 20.0, 30.0);
+    base.addFinishToStartConstraint("C", "B", 0.0, 10.0);
+
+    // A, C and D sleep, B waits for C: the list stays ordered by name.
+    vmd::KnowledgeBase::Result r = base.processChanges(0.);
+    EnsuresApproximatelyEqual((double)r.second, 3., 1e-10);
+    EnsuresEqual(base.waitedActivities().size(),
+                 vmd::Activities::result_t::size_type(4));
+    EnsuresEqual(base.waitedActivities()[0]->first, "A");
+    EnsuresEqual(base.waitedActivities()[1]->first, "B");
+    EnsuresEqual(base.waitedActivities()[2]->first, "C");
+    EnsuresEqual(base.waitedActivities()[3]->first, "D");
+
+    // The dates of sleeping activities change: D wakes up earlier and A
+    // later than the dates they were queued with.
+    base.plan().activities().get("D")->second.initStartTimeFinishTime(1.0, 30.0);
+    base.plan().activities().get("A")->second.initStartTimeFinishTime(4.0, 10.0);
+    EnsuresApproximatelyEqual((double)base.nextDate(0.5), 1., 1e-10);
+
+    r = base.processChanges(1.);
+    Ensures(base.activities().get("D")->second.isInStartedState());
+    EnsuresApproximatelyEqual((double)r.second, 3., 1e-10);
+
+    r = base.processChanges(3.);
+    Ensures(base.activities().get("C")->second.isInStartedState());
+    Ensures(base.activities().get("A")->second.isInWaitState());
+    EnsuresApproximatelyEqual((double)r.second, 4., 1e-10);
+
+    base.processChanges(4.);
+    Ensures(base.activities().get("A")->second.isInStartedState());
+
+    // A removed activity leaves no entry in the wake-up queue.
+    base.addActivity("E", 50.0, 60.0);
+    base.processChanges(4.);
+    base.plan().activities().get("E")->second.initStartTimeFinishTime(40.0, 60.0);
+    base.plan().activities().remove("E");
+    EnsuresEqual(base.waitedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+    r = base.processChanges(4.);
+    Ensures(r.second != 40.);
+}
+
+void ActivitiesTopologicalOrder()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    vmd::KnowledgeBase base(ctxp);
+    base.addActivity("A", 0.0, 10.0);
+    base.addActivity("B", 0.0, 10.0);
+    base.addActivity("C", 0.0, 10.0);
+    base.addActivity("D", 0.0, 10.0);
+    base.addStartToStartConstraint("D", "C", 10.0);
+    base.addStartToStartConstraint("C", "B", 10.0);
+    base.addStartToStartConstraint("B", "A", 10.0);
+
+    vmd::Activities& acts = base.plan().activities();
+    const vmd::PrecedencesGraph& graph = acts.precedencesGraph();
+    EnsuresEqual(graph.rank(acts.get("D")), std::size_t(0));
+    EnsuresEqual(graph.rank(acts.get("A")), std::size_t(3));
+    EnsuresEqual(graph.maxRank(), std::size_t(3));
+
+    // A single call starts the whole chain, the successors being named
+    // before their predecessors.
+    base.processChanges(0.);
+    const vmd::Activities::result_t& started = base.startedActivities();
+    EnsuresEqual(started.size(), vmd::Activities::result_t::size_type(4));
+    EnsuresEqual(started[0]->first, "A");
+    EnsuresEqual(started[3]->first, "D");
+
+    // The index of a removed activity is reused, without its constraints.
+    std::size_t index = acts.get("D")->second.index();
+    base.removeActivity("D");
+    EnsuresEqual(graph.rank(acts.get("C")), std::size_t(0));
+    EnsuresEqual(graph.maxRank(), std::size_t(2));
+    base.addActivity("E", 0.0, 10.0);
+    EnsuresEqual(acts.get("E")->second.index(), index);
+    Ensures(graph.findPrecedenceOut(acts.get("E")).first ==
+            graph.findPrecedenceOut(acts.get("E")).second);
+
+    // In a cycle, the activities get the highest rank.
+    base.addStartToStartConstraint("A", "C", 10.0);
+    EnsuresEqual(graph.rank(acts.get("C")), graph.maxRank());
+    EnsuresEqual(graph.rank(acts.get("A")), graph.maxRank());
+}
+
+void ActivitiesArchive()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    vmd::ex::KB7 base(ctxp);
+    EnsuresEqual(base.activities().precedencesGraph().size(),
+                 vmd::PrecedencesGraph::Precedences::size_type(1));
+
+    base.processChanges(0.);
+    base.setActivityDone("A", 1.);
+    base.processChanges(1.);
+    EnsuresEqual(base.archiveActivities(),
+                 vmd::Activities::size_type(0));
+
+    base.clearLatestActivitiesLists();
+    base.processChanges(2.);
+    base.clearLatestActivitiesLists();
+    EnsuresEqual(base.archiveActivities(),
+                 vmd::Activities::size_type(0));
+
+    base.setActivityDone("B", 3.);
+    base.processChanges(3.);
+    base.clearLatestActivitiesLists();
+    EnsuresEqual(base.archiveActivities(),
+                 vmd::Activities::size_type(2));
+    EnsuresEqual(base.activities().size(),
+                 vmd::Activities::size_type(1));
+    Ensures(base.activities().isArchived("A"));
+    Ensures(base.activities().isArchived("B"));
+    EnsuresEqual(base.activities().archived().find("B")->second.state,
+                 vmd::Activity::DONE);
+    Ensures(base.activities().precedencesGraph().empty());
+    Ensures(base.activities().precedencesGraph().nodes().empty());
+    EnsuresEqual(base.endedActivities().size(),
+                 vmd::Activities::result_t::size_type(0));
+    EnsuresEqual(base.startedActivities().size(),
+                 vmd::Activities::result_t::size_type(1));
+
+    base.removeActivity("C");
+    EnsuresEqual(base.activities().size(),
+                 vmd::Activities::size_type(0));
+    EnsuresThrow(base.removeActivity("C"), vle::utils::ArgError);
+
+    EnsuresThrow(base.addActivity("B", 5.0, 10.0), vle::utils::ArgError);
+    EnsuresEqual(base.activities().archivedCount(vmd::Activity::DONE),
+                 vmd::Activities::size_type(2));
+
+    // The oldest record is dropped, its name can be used again.
+    base.setArchiveCapacity(1);
+    EnsuresEqual(base.activities().archived().size(),
+                 vmd::Activities::archived_t::size_type(1));
+    Ensures(not base.activities().isArchived("A"));
+    Ensures(base.activities().isArchived("B"));
+    EnsuresEqual(base.activities().archivedCount(vmd::Activity::DONE),
+                 vmd::Activities::size_type(2));
+    base.addActivity("A", 5.0, 10.0);
+    EnsuresEqual(base.activities().size(),
+                 vmd::Activities::size_type(1));
+
+    base.setArchiveCapacity(0);
+    Ensures(base.activities().archived().empty());
+    EnsuresEqual(base.activities().archivedCount(vmd::Activity::DONE),
+                 vmd::Activities::size_type(2));
+}
+
+void ActivitiesObservation()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    vmd::ex::KB7 base(ctxp);
+    const vmd::ActivitiesObserver& observer = base.activitiesObserver();
+
+    base.processChanges(0.);
+
+    std::unique_ptr<vle::value::Table> tab =
+        base.activitiesTable("view", false);
+    EnsuresEqual(tab->width(), (std::size_t)6);
+    EnsuresEqual(tab->height(), (std::size_t)3);
+    EnsuresEqual(tab->get(0, 1), 1.);
+    EnsuresEqual(tab->get(1, 1), (double)vmd::Activity::WAIT);
+    EnsuresEqual(observer.names().size(), (std::size_t)3);
+    EnsuresEqual(observer.names()[2], "C");
+
+    tab = base.activitiesTable("view", true);
+    EnsuresEqual(tab->height(), (std::size_t)3);
+    tab = base.activitiesTable("view", true);
+    EnsuresEqual(tab->height(), (std::size_t)0);
+
+    // The changes are kept until the view observes them, even if the
+    // latest lists are cleared in between.
+    base.setActivityDone("A", 1.);
+    base.processChanges(1.);
+    base.clearLatestActivitiesLists();
+    tab = base.activitiesTable("view", true);
+    EnsuresEqual(tab->height(), (std::size_t)2);
+    EnsuresEqual(tab->get(0, 0), 0.);
+    EnsuresEqual(tab->get(1, 0), (double)vmd::Activity::DONE);
+    EnsuresEqual(tab->get(4, 0), 1.);
+    EnsuresEqual(tab->get(0, 1), 1.);
+    EnsuresEqual(tab->get(1, 1), (double)vmd::Activity::STARTED);
+    tab = base.activitiesTable("other", true);
+    EnsuresEqual(tab->height(), (std::size_t)3);
+    tab = base.activitiesTable("view", true);
+    EnsuresEqual(tab->height(), (std::size_t)0);
+
+    // A resource assignment is a change.
+    base.addResources("Farmer", "Bob");
+    base.addActivity("D", 2.0, 10.0).getParams().addString("resources",
+                                                           "Farmer");
+    base.processChanges(2.);
+    tab = base.activitiesTable("view", true);
+    EnsuresEqual(tab->height(), (std::size_t)1);
+    EnsuresEqual(tab->get(0, 0), 3.);
+    EnsuresEqual(tab->get(5, 0), 1.);
+
+    // An archived activity keeps its identifier.
+    base.setActivityDone("B", 3.);
+    base.processChanges(3.);
+    base.clearLatestActivitiesLists();
+    base.archiveActivities();
+    Ensures(base.activities().isArchived("A"));
+    tab = base.activitiesTable("view", true);
+    EnsuresEqual(tab->height(), (std::size_t)1);
+    EnsuresEqual(tab->get(0, 0), 1.);
+    EnsuresEqual(tab->get(1, 0), (double)vmd::Activity::DONE);
+    tab = base.activitiesTable("view", false);
+    EnsuresEqual(tab->height(), (std::size_t)4);
+    EnsuresEqual(tab->get(0, 2), 0.);
+
+    std::unique_ptr<vle::value::Tuple> tuple = base.activityTuple("A");
+    Ensures(tuple.get() != nullptr);
+    EnsuresEqual(tuple->size(), (std::size_t)5);
+    EnsuresEqual((*tuple)[0], 0.);
+    EnsuresEqual((*tuple)[1], (double)vmd::Activity::DONE);
+    Ensures(not base.activityTuple("E"));
+    EnsuresEqual(observer.names().size(), (std::size_t)4);
+}
+
 void activitiesExist()
 {
     vle::utils::ContextPtr ctxp =  vle::utils::make_context();
@@ -614,6 +917,11 @@ int main()
     Activity4();
     ActivitiesnextDate1();
     ActivitiesnextDate2();
+    ActivitiesWakeUp();
+    ActivitiesWakeUpDates();
+    ActivitiesTopologicalOrder();
+    ActivitiesArchive();
+    ActivitiesObservation();
     activitiesExist();
     Activities_test_slot_function();
 
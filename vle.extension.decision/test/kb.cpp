@@ -119,12 +119,53 @@ void kb()
     EnsuresEqual(lst.size(), vmd::Activities::result_t::size_type(2));
 }
 
+void predicateDependencies()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    int calls = 0;
+    vmd::PredicateFunction fct =
+        [&calls](const std::string&, const std::string&,
+                 const vmd::PredicateParameters&) { ++calls; return true; };
+
+    std::unique_ptr < vmd::Predicate > pred;
+    {
+        vmd::ex::KnowledgeBase base(ctxp);
+        base.addPredicateDependency("fct", "today");
+        pred.reset(new vmd::Predicate("p", fct, vmd::PredicateParameters(),
+                                      "fct", base.predicateDependencies()));
+
+        pred->isAvailable("act1", "Rule 1");
+        pred->isAvailable("act1", "Rule 1");
+        EnsuresEqual(calls, 1);
+
+        base.applyFact("today", vle::value::Double(16));
+        pred->isAvailable("act1", "Rule 1");
+        EnsuresEqual(calls, 2);
+
+        base.factChanged("today");
+        pred->isAvailable("act1", "Rule 1");
+        EnsuresEqual(calls, 3);
+
+        base.facts();
+        pred->isAvailable("act1", "Rule 1");
+        EnsuresEqual(calls, 4);
+
+        const vmd::KnowledgeBase& cbase = base;
+        cbase.facts();
+        pred->isAvailable("act1", "Rule 1");
+        EnsuresEqual(calls, 4);
+    }
+
+    pred->isAvailable("act1", "Rule 1");
+    EnsuresEqual(calls, 4);
+}
 
 int main()
 {
     fixture f;
 
     kb();
+    predicateDependencies();
 
     return unit_test::report_errors();
 }
@@ -47,7 +47,7 @@ class KnowledgeBase : public vmd::KnowledgeBase
 {
 public:
     KnowledgeBase(vle::utils::ContextPtr ctxp)
-        : vmd::KnowledgeBase(ctxp), today(0), yesterday(0)
+        : vmd::KnowledgeBase(ctxp), today(0), yesterday(0), calls(0)
     {
         addRess(this) +=
             R("computeResource", &KnowledgeBase::resFunc);
@@ -73,6 +73,7 @@ public:
     bool predUsingPlanTimeStamp(const std::string&, const std::string&,
                                 const PredicateParameters& params) const
     {
+            calls++;
             double loadTime = params.getDouble("planTimeStamp");
             double dayThreshold = params.getDouble("dayThreshold");
             if (loadTime + dayThreshold <= today) {
@@ -89,6 +90,7 @@ public:
     }
 
     double today, yesterday;
+    mutable int calls;
 
 };
 
@@ -392,6 +394,29 @@ void test_planTimeStamp()
     }
 }
 
+void test_predicateDependency()
+{
+    {
+        vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+        vmd::ex::KnowledgeBase b(ctxp);
+        b.addPredicateDependency("predUsingPlanTimeStamp", "today");
+        b.plan().fill(std::string(vmd::ex::Plan1), 7);
+
+        const vmd::Activity& act1 = b.activities().get("activity1")->second;
+        b.applyFact("today", vle::value::Double(7));
+        b.processChanges(0.0);
+        EnsuresEqual(not act1.isInStartedState(), true);
+        int calls = b.calls;
+        EnsuresEqual(calls > 0, true);
+        b.processChanges(0.0);
+        EnsuresEqual(b.calls, calls);
+        b.processChanges(1.0);
+        EnsuresEqual(b.calls > calls, true);
+        b.applyFact("today", vle::value::Double(10));
+        b.processChanges(1.0);
+        EnsuresEqual(act1.isInStartedState(), true);
+    }
+}
 
 void test_neverFail()
 {
@@ -526,6 +551,7 @@ int main()
     fixture f;
 
     test_planTimeStamp();
+    test_predicateDependency();
     test_neverFail();
     test_neverFail2();
     test_neverFail3();
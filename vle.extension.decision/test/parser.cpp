@@ -28,6 +28,7 @@
 
 #include <vle/utils/unit-test.hpp>
 #include <iostream>
+#include <sstream>
 #include <iterator>
 #include <vle/vle.hpp>
 #include <vle/value/Double.hpp>
@@ -378,6 +379,31 @@ void test_relativehumandates()
     }
 }
 
+void test_template()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+
+    vmd::ex::KnowledgeBase b(ctxp);
+    std::istringstream in(vmd::ex::Plan1);
+    b.library().addTemplate("plan1", in);
+    Ensures(b.library().existTemplate("plan1"));
+
+    b.plan().instantiate(b.library().getTemplate("plan1"), 0, ":00");
+    b.plan().instantiate(b.library().getTemplate("plan1"), 5, ":01");
+
+    EnsuresEqual(b.activities().size(), (vmd::Activities::size_type)18);
+    const vmd::Activity& act0 = b.activities().get("activity8:00")->second;
+    const vmd::Activity& act1 = b.activities().get("activity8:01")->second;
+    EnsuresEqual(act0.start(), 10.0);
+    EnsuresEqual(act1.start(), 15.0);
+    EnsuresEqual(act1.finish(), 28.5);
+
+    std::istringstream again(vmd::ex::Plan1);
+    EnsuresThrow(b.library().addTemplate("plan1", again),
+                 vle::utils::ArgError);
+    EnsuresThrow(b.library().getTemplate("plan2"), vle::utils::ArgError);
+}
+
 int main()
 {
     fixture f;
@@ -387,6 +413,7 @@ int main()
     test_stringdates();
     test_relativedates();
     test_relativehumandates();
+    test_template();
 
     return unit_test::report_errors();
 }
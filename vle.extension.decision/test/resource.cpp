@@ -27,6 +27,7 @@
 
 #include <vle/utils/unit-test.hpp>
 #include <iostream>
+#include <algorithm>
 #include <iterator>
 #include <vle/vle.hpp>
 #include <vle/value/Double.hpp>
@@ -322,6 +323,30 @@ namespace vle { namespace extension { namespace decision { namespace ex {
     };
 
 
+    class Resourcetest_6: public vmd::KnowledgeBase
+    {
+    public:
+        Resourcetest_6(vle::utils::ContextPtr ctxp)
+            : vmd::KnowledgeBase(ctxp)
+        {
+            vmd::Activity& A = addActivity("A", 1.0, 10.0);
+
+            for (int i = 0; i < 100; i++) {
+                std::string worker = vle::utils::format("w%03d", i);
+                addResources("worker", worker);
+                if (i >= 70 and i < 80) {
+                    addResources("skilled", worker);
+                }
+            }
+
+            A.getParams().addString("resources", "skilled.3 + worker");
+
+            A.freeRessources();
+        }
+
+        virtual ~Resourcetest_6() {}
+    };
+
 }}}} // namespace vle extension decision ex
 
 /**
@@ -567,6 +592,37 @@ void resource_5()
     }
 }
 
+void resource_6()
+{
+    vle::utils::ContextPtr ctxp =  vle::utils::make_context();
+    vmd::ex::Resourcetest_6 base(ctxp);
+
+    EnsuresEqual(base.resourceTypeExist("worker&skilled"), true);
+    EnsuresEqual(base.resourceTypeExist("skilled&boss"), false);
+    EnsuresEqual(base.getResourceQuantity("worker"), 100);
+    EnsuresEqual(base.getResourceQuantity("skilled&worker"), 10);
+    EnsuresEqual(base.getResources("skilled").front(), "w070");
+
+    base.processChanges(1.0);
+    {
+        const vmd::Activity& A =  base.activities().get("A")->second;
+        EnsuresEqual(A.isInStartedState(), true);
+
+        vmd::ActivitiesResourcesConstIteratorPair pit =
+            base.activities().resources("A");
+        EnsuresEqual(std::distance(pit.first, pit.second), 4);
+        std::vector < std::string > taken;
+        for (; pit.first != pit.second; ++pit.first) {
+            taken.push_back(pit.first->second);
+        }
+        std::sort(taken.begin(), taken.end());
+        EnsuresEqual(taken[0], "w000");
+        EnsuresEqual(taken[1], "w070");
+        EnsuresEqual(taken[2], "w071");
+        EnsuresEqual(taken[3], "w072");
+    }
+}
+
 int main()
 {
     resource_0();
@@ -575,6 +631,7 @@ int main()
     resource_3();
     resource_4();
     resource_5();
+    resource_6();
 
     return unit_test::report_errors();
 }
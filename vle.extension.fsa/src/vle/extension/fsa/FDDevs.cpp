@@ -30,37 +30,76 @@
 
 namespace vle { namespace extension { namespace fsa {
 
-void FDDevs::process(const std::string& portname,
-                        const devs::Time& time)
+void FDDevsDefinition::addState(int state)
 {
-    if (mExternals.find(currentState()) != mExternals.end() and
-        (mExternals[currentState()].find(portname) !=
-         mExternals[currentState()].end())) {
-        currentState(mExternals[currentState()]
-                              [portname]);
-
-        if (mDurations.find(currentState()) == mDurations.end()) {
-            throw utils::InternalError(vle::utils::format(
-                    "FSA::FDDevs model, unknow duration of state %i",
-                    currentState()));
-        }
+    if (existState(state)) {
+        throw utils::ModellingError(vle::utils::format(
+                "FSA::FDDevsDefinition: state %i is already defined",
+                state));
+    }
 
-        mSigma = mDurations[currentState()];
+    mStates.push_back(state);
+}
+
+void FDDevsDefinition::initialState(int state)
+{
+    if (not existState(state)) {
+        throw utils::InternalError(vle::utils::format(
+                "FSA::FDDevsDefinition, unknow state %i", state));
     }
-    else mSigma -= time - mLastTime;
+
+    mInitialState = state;
+    mInit = true;
 }
 
-/*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
+const devs::Time& FDDevsDefinition::duration(int state) const
+{
+    Durations::const_iterator it = mDurations.find(state);
 
-void FDDevs::output(devs::Time time,
-                       devs::ExternalEventList& output) const
+    if (it == mDurations.end()) {
+        throw utils::InternalError(vle::utils::format(
+                "FSA::FDDevs model, unknow duration of state %i", state));
+    }
+
+    return it->second;
+}
+
+int FDDevsDefinition::internal(int state) const
 {
-    OutputFuncsIterator it = mOutputFuncs.find(currentState());
+    Internals::const_iterator it = mInternals.find(state);
+
+    if (it == mInternals.end()) {
+        throw utils::InternalError(vle::utils::format(
+                "FSA::FDDevs model, unknow internal transition on state %i",
+                state));
+    }
+
+    return it->second;
+}
+
+int FDDevsDefinition::external(int state, const std::string& portname) const
+{
+    Externals::const_iterator it = mExternals.find(state);
+
+    if (it != mExternals.end()) {
+        External::const_iterator jt = it->second.find(portname);
+
+        if (jt != it->second.end()) {
+            return jt->second;
+        }
+    }
+    return -1;
+}
+
+void FDDevsDefinition::output(int state, const devs::Time& time,
+                              devs::ExternalEventList& output) const
+{
+    OutputFuncs::const_iterator it = mOutputFuncs.find(state);
 
     if (it != mOutputFuncs.end()) {
         (it->second)(time, output);
     } else {
-        OutputsIterator ito = mOutputs.find(currentState());
+        Outputs::const_iterator ito = mOutputs.find(state);
 
         if (ito != mOutputs.end()) {
             output.emplace_back(ito->second);
@@ -68,59 +107,88 @@ void FDDevs::output(devs::Time time,
     }
 }
 
-devs::Time FDDevs::init(devs::Time /* time */)
+/*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
+
+FDDevsDefinition& FDDevs::ownDefinition()
 {
-    if (not isInit()) {
+    if (not mOwnDefinition) {
         throw utils::InternalError(
-            "FSA::FDDevs model, initial state not defined");
+            "FSA::FDDevs model, a shared definition can not be modified");
     }
 
-    currentState(initialState());
+    return *mOwnDefinition;
+}
 
-    if (mDurations.find(currentState()) == mDurations.end()) {
-        throw utils::InternalError(vle::utils::format(
-                "FSA::FDDevs model, unknow duration of state %i",
-                currentState()));
+bool FDDevs::process(const std::string& portname)
+{
+    int next = mDefinition->external(currentState(), portname);
+
+    if (next != -1) {
+        currentState(next);
+        return true;
+    }
+    return false;
+}
+
+/*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
+
+void FDDevs::output(devs::Time time,
+                       devs::ExternalEventList& output) const
+{
+    mDefinition->output(currentState(), time, output);
+}
+
+devs::Time FDDevs::init(devs::Time time)
+{
+    if (mOwnDefinition) {
+        if (not isInit()) {
+            throw utils::InternalError(
+                "FSA::FDDevs model, initial state not defined");
+        }
+        currentState(initialState());
+    } else {
+        if (not mDefinition->isInit()) {
+            throw utils::InternalError(
+                "FSA::FDDevs model, initial state not defined");
+        }
+        currentState(mDefinition->initialState());
     }
 
-    mSigma = mDurations[currentState()];
+    mSigma = mDefinition->duration(currentState());
+    mLastTime = time;
     return mSigma;
 }
 
 void FDDevs::externalTransition(const devs::ExternalEventList& events,
                                 devs::Time time)
 {
+    bool changed = false;
+
     if (events.size() > 1) {
         devs::ExternalEventList sortedEvents = select(events);
         devs::ExternalEventList::const_iterator it = sortedEvents.begin();
 
         while (it != sortedEvents.end()) {
-            process(it->getPortName(), time);
+            changed = process(it->getPortName()) or changed;
             ++it;
         }
     } else {
         devs::ExternalEventList::const_iterator it = events.begin();
-        process(it->getPortName(), time);
+        changed = process(it->getPortName());
     }
+
+    if (changed) {
+        mSigma = mDefinition->duration(currentState());
+    } else {
+        mSigma -= time - mLastTime;
+    }
+    mLastTime = time;
 }
 
 void FDDevs::internalTransition(devs::Time time)
 {
-    if (mInternals.find(currentState()) == mInternals.end()) {
-        throw utils::InternalError(vle::utils::format(
-                "FSA::FDDevs model, unknow internal transition on state %i",
-                currentState()));
-    }
-
-    currentState(mInternals[currentState()]);
-
-    if (mDurations.find(currentState()) == mDurations.end()) {
-        throw utils::InternalError(vle::utils::format(
-                "FSA::FDDevs model, unknow duration of state %i",
-                currentState()));
-    }
-
-    mSigma = mDurations[currentState()];
+    currentState(mDefinition->internal(currentState()));
+    mSigma = mDefinition->duration(currentState());
     mLastTime = time;
 }
 
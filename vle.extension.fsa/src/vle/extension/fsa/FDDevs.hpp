@@ -30,7 +30,10 @@
 #define VLE_EXTENSION_FSA_FDDEVS_HPP 1
 
 #include <functional>
+#include <memory>
+#include <vector>
 #include <vle/extension/fsa/FSA.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/utils/Tools.hpp>
 
 namespace vle { namespace extension { namespace fsa {
@@ -86,30 +89,37 @@ struct FDDevsOutputFunc_t
 };
 
 /**
- * @brief Devs The class Devs is a DEVS mapping of structure and
- * dynamics of the DEVS formalism with a finite number of
- * discrete states. Two kind of transitions are possible :
- * internal on fixed duration and external on event.
- * At each internal transition, external event without data
- * can be generated.
- * The structure and dynamics of Finite State Automaton are
- * specified with C++ code.
+ * @brief The structure of a FDDevs model: the states, the durations of
+ * the states, the outputs and the internal and external transitions. A
+ * definition built once can be shared, immutable, by all the instances of
+ * a model, which then only keep their current state and elapsed time.
+ *
+ * @code
+ * static std::shared_ptr < const FDDevsDefinition > definition()
+ * {
+ *     static std::shared_ptr < const FDDevsDefinition > def = []() {
+ *         auto d = std::make_shared < FDDevsDefinition >();
+ *         d->addState(A);
+ *         d->addState(B);
+ *         d->initialState(A);
+ *         d->durations()[A] = 1.0;
+ *         d->durations()[B] = 2.0;
+ *         d->internals()[A] = B;
+ *         d->internals()[B] = A;
+ *         d->outputs()[A] = "out";
+ *         return d;
+ *     }();
+ *     return def;
+ * }
+ *
+ * Cow(const devs::DynamicsInit& init, const devs::InitEventList& events)
+ *     : FDDevs(init, events, definition())
+ * {}
+ * @endcode
  */
-class FDDevs : public Base
+class FDDevsDefinition
 {
 public:
-    FDDevs(const devs::DynamicsInit& init,
-           const devs::InitEventList& events)
-        : Base(init, events)
-    {}
-
-    virtual ~FDDevs() {}
-
-    virtual devs::ExternalEventList select(
-        const devs::ExternalEventList& events)
-    { return events; }
-
-private:
     // duration
     typedef std::map < int , devs::Time > Durations;
 
@@ -126,7 +136,34 @@ private:
     typedef std::map < std::string , int > External;
     typedef std::map < int , std::map < std::string , int > > Externals;
 
-public:
+    FDDevsDefinition()
+        : mInit(false), mInitialState(0)
+    {}
+
+    /**
+     * @brief Add a state to the definition.
+     * @throw utils::ModellingError if the state is already defined.
+     */
+    void addState(int state);
+
+    bool existState(int state) const
+    {
+        return std::find(mStates.begin(), mStates.end(), state) !=
+            mStates.end();
+    }
+
+    /**
+     * @brief Specify the initial state.
+     * @throw utils::InternalError if the state is unknown.
+     */
+    void initialState(int state);
+
+    int initialState() const
+    { return mInitialState; }
+
+    bool isInit() const
+    { return mInit; }
+
     Durations& durations() { return mDurations; }
     Outputs& outputs() { return mOutputs; }
     OutputFuncs& outputFuncs() { return mOutputFuncs; }
@@ -141,6 +178,110 @@ public:
         return r.first->second;
     }
 
+    /**
+     * @brief Get the duration of a state.
+     * @throw utils::InternalError if the duration is unknown.
+     */
+    const devs::Time& duration(int state) const;
+
+    /**
+     * @brief Get the next state of an internal transition.
+     * @throw utils::InternalError if the transition is unknown.
+     */
+    int internal(int state) const;
+
+    /**
+     * @brief Get the next state of an external transition.
+     * @return the next state or -1 if there is no such transition.
+     */
+    int external(int state, const std::string& portname) const;
+
+    /**
+     * @brief Build the output of a state.
+     */
+    void output(int state, const devs::Time& time,
+                devs::ExternalEventList& output) const;
+
+private:
+    bool mInit;
+    int mInitialState;
+    std::vector < int > mStates;
+    // Next states in case of external transition
+    Externals mExternals;
+    // List of durations of states
+    Durations mDurations;
+    // List of ports for output function
+    Outputs mOutputs;
+    // List of output functions
+    OutputFuncs mOutputFuncs;
+    // Next states in case of internal transition
+    Internals mInternals;
+};
+
+/**
+ * @brief Devs The class Devs is a DEVS mapping of structure and
+ * dynamics of the DEVS formalism with a finite number of
+ * discrete states. Two kind of transitions are possible :
+ * internal on fixed duration and external on event.
+ * At each internal transition, external event without data
+ * can be generated.
+ * The structure and dynamics of Finite State Automaton are
+ * specified with C++ code, either for each instance or once in a
+ * FDDevsDefinition shared by all the instances.
+ */
+class FDDevs : public Base
+{
+public:
+    FDDevs(const devs::DynamicsInit& init,
+           const devs::InitEventList& events)
+        : Base(init, events),
+        mOwnDefinition(std::make_shared < FDDevsDefinition >()),
+        mDefinition(mOwnDefinition), mLastTime(0), mSigma(0)
+    {}
+
+    /**
+     * @brief Build an instance of a shared definition. The structure of
+     * the model can not be modified by the instance.
+     */
+    FDDevs(const devs::DynamicsInit& init,
+           const devs::InitEventList& events,
+           std::shared_ptr < const FDDevsDefinition > definition)
+        : Base(init, events), mOwnDefinition(),
+        mDefinition(definition), mLastTime(0), mSigma(0)
+    {
+        if (not mDefinition) {
+            throw utils::InternalError(
+                "FSA::FDDevs model, null definition");
+        }
+    }
+
+    virtual ~FDDevs() {}
+
+    virtual devs::ExternalEventList select(
+        const devs::ExternalEventList& events)
+    { return events; }
+
+private:
+    typedef FDDevsDefinition::Durations Durations;
+    typedef FDDevsDefinition::Outputs Outputs;
+    typedef FDDevsDefinition::OutputFunc OutputFunc;
+    typedef FDDevsDefinition::OutputFuncs OutputFuncs;
+    typedef FDDevsDefinition::Internals Internals;
+    typedef FDDevsDefinition::External External;
+    typedef FDDevsDefinition::Externals Externals;
+
+public:
+    Durations& durations() { return ownDefinition().durations(); }
+    Outputs& outputs() { return ownDefinition().outputs(); }
+    OutputFuncs& outputFuncs() { return ownDefinition().outputFuncs(); }
+    Internals& internals() { return ownDefinition().internals(); }
+
+    External& externals(int s)
+    { return ownDefinition().externals(s); }
+
+    const FDDevsDefinition& definition() const
+    { return *mDefinition; }
+
     virtual void confluentTransitions(
         devs::Time time,
         const devs::ExternalEventList& extEventlist) override
@@ -170,24 +311,14 @@ public:
     { return FDDevsOutputFunc_t<X, I>(obj, func); }
 
 private:
-    typedef Outputs::const_iterator OutputsIterator;
-    typedef OutputFuncs::const_iterator OutputFuncsIterator;
-    typedef Internals::const_iterator InternalsIterator;
-    typedef Externals::const_iterator ExternalsIterator;
+    // The definition built by this instance, null if shared
+    std::shared_ptr < FDDevsDefinition > mOwnDefinition;
+    // The definition used by this instance
+    std::shared_ptr < const FDDevsDefinition > mDefinition;
 
-    // Next states in case of external transition
-    Externals mExternals;
-    // List of durations of states
-    Durations mDurations;
-    // List of ports for output function
-    Outputs mOutputs;
-    // List of output functions
-    OutputFuncs mOutputFuncs;
-    // Next states in case of internal transition
-    Internals mInternals;
+    FDDevsDefinition& ownDefinition();
 
-    void process(const std::string& portname,
-                 const devs::Time& time);
+    bool process(const std::string& portname);
 
     virtual devs::Time init(devs::Time time) override;
     virtual void output(devs::Time time,
@@ -30,6 +30,7 @@
 #define VLE_EXTENSION_FSA_FSA_HPP 1
 
 #include <algorithm>
+#include <unordered_map>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/utils/Tools.hpp>
 
@@ -82,7 +83,7 @@ class Base : public vle::devs::Dynamics
 public:
     Base(const vle::devs::DynamicsInit& init,
 	 const vle::devs::InitEventList& events) :
-        vle::devs::Dynamics(init, events), mInit(false)
+        vle::devs::Dynamics(init, events), mInit(false), mCurrentIndex(-1)
     {}
 
     virtual ~Base() {}
@@ -129,7 +130,61 @@ protected:
     { return mCurrentState; }
 
     void currentState(int newState)
-    { mCurrentState = newState; }
+    {
+        mCurrentState = newState;
+        if (not mStateIndex.empty()) {
+            mCurrentIndex = stateIndex(newState);
+        }
+    }
+
+    /**
+     * @brief Change the current state when its dense index is already
+     * known (see stateIndex).
+     */
+    void currentState(int newState, int index)
+    {
+        mCurrentState = newState;
+        mCurrentIndex = index;
+    }
+
+    /**
+     * @brief Dense index of the current state, -1 if the state was not
+     * indexed.
+     */
+    int currentIndex() const
+    { return mCurrentIndex; }
+
+    /**
+     * @brief Give a dense index in [0, stateCount()) to a state, used by
+     * the engines to compile their transition tables. The engines that
+     * index no state (Statechart, FDDevs) keep a plain currentState(int).
+     * @return the index of the state.
+     */
+    int indexState(int state)
+    {
+        return mStateIndex.insert(std::make_pair(
+                state, (int)mStateIndex.size())).first->second;
+    }
+
+    /**
+     * @brief Dense index of a state, -1 if the state was not indexed.
+     */
+    int stateIndex(int state) const
+    {
+        std::unordered_map < int, int >::const_iterator it =
+            mStateIndex.find(state);
+
+        return it == mStateIndex.end() ? -1 : it->second;
+    }
+
+    std::size_t stateCount() const
+    { return mStateIndex.size(); }
+
+    void clearStateIndex()
+    {
+        mStateIndex.clear();
+        mCurrentIndex = -1;
+    }
 
     bool existState(int state) const
     {
@@ -156,8 +211,33 @@ private:
     int mInitialState;
     // Current state
     int mCurrentState;
+    // Dense index of the current state
+    int mCurrentIndex;
+    // Dense index of the states
+    std::unordered_map < int, int > mStateIndex;
 
 protected:
+    /**
+     * @brief Intern the input ports of the model, so that the events are
+     * resolved to a port index once, when they are queued. The ports of
+     * the tables that the model does not declare are interned after.
+     */
+    void indexInputPorts(std::unordered_map < std::string, int >& ports) const
+    {
+        for (const auto& port : getModel().getInputPortList()) {
+            ports.insert(std::make_pair(port.first, (int)ports.size()));
+        }
+    }
+
+    static int portIndex(const std::unordered_map < std::string, int >& ports,
+                         const std::string& port)
+    {
+        std::unordered_map < std::string, int >::const_iterator it =
+            ports.find(port);
+
+        return it == ports.end() ? -1 : it->second;
+    }
+
     // List of states
     States mStates;
 
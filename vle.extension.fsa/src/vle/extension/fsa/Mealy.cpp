@@ -30,24 +30,112 @@
 
 namespace vle { namespace extension { namespace fsa {
 
-void Mealy::process(const devs::Time& time,
-		    const devs::ExternalEvent* event)
+void Mealy::compile()
 {
-    if (mTransitions.find(currentState()) !=
-        mTransitions.end() and
-        (mTransitions[currentState()].find(event->
-                                                    getPortName())
-         != mTransitions[currentState()].end())) {
-        ActionsIterator ita = mActions.find(currentState());
+    clearStateIndex();
+    mPorts.clear();
+    mCells.clear();
+    indexInputPorts(mPorts);
+
+    for (States::const_iterator it = mStates.begin(); it != mStates.end();
+         ++it) {
+        indexState(*it);
+    }
+    for (TransitionsIterator it = mTransitions.begin();
+         it != mTransitions.end(); ++it) {
+        indexState(it->first);
+        for (Transition::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            indexState(jt->second);
+            mPorts.insert(std::make_pair(jt->first, (int)mPorts.size()));
+        }
+    }
+    for (OutputsIterator it = mOutputs.begin(); it != mOutputs.end(); ++it) {
+        indexState(it->first);
+        for (Output::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mPorts.insert(std::make_pair(jt->first, (int)mPorts.size()));
+        }
+    }
+    for (OutputFuncsIterator it = mOutputFuncs.begin();
+         it != mOutputFuncs.end(); ++it) {
+        indexState(it->first);
+        for (OutputFunc::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mPorts.insert(std::make_pair(jt->first, (int)mPorts.size()));
+        }
+    }
+    for (ActionsIterator it = mActions.begin(); it != mActions.end(); ++it) {
+        indexState(it->first);
+        for (Actions::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mPorts.insert(std::make_pair(jt->first, (int)mPorts.size()));
+        }
+    }
+
+    const std::size_t nbPorts = mPorts.size();
 
-        if (ita != mActions.end() and
-            ita->second.find(event->getPortName()) != ita->second.end()) {
+    mCells.resize(stateCount() * nbPorts);
 
-            (ita->second.find(event->getPortName())->second)(time, event);
+    for (TransitionsIterator it = mTransitions.begin();
+         it != mTransitions.end(); ++it) {
+        std::size_t row = stateIndex(it->first) * nbPorts;
+
+        for (Transition::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            Cell& c = mCells[row + mPorts[jt->first]];
+
+            c.next = jt->second;
+            c.nextIndex = stateIndex(jt->second);
         }
+    }
+    for (OutputsIterator it = mOutputs.begin(); it != mOutputs.end(); ++it) {
+        std::size_t row = stateIndex(it->first) * nbPorts;
 
-        currentState(mTransitions[currentState()]
-                              [event->getPortName()]);
+        for (Output::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mCells[row + mPorts[jt->first]].output = &jt->second;
+        }
+    }
+    for (OutputFuncsIterator it = mOutputFuncs.begin();
+         it != mOutputFuncs.end(); ++it) {
+        std::size_t row = stateIndex(it->first) * nbPorts;
+
+        for (OutputFunc::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mCells[row + mPorts[jt->first]].outputFunc = &jt->second;
+        }
+    }
+    for (ActionsIterator it = mActions.begin(); it != mActions.end(); ++it) {
+        std::size_t row = stateIndex(it->first) * nbPorts;
+
+        for (Actions::const_iterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            mCells[row + mPorts[jt->first]].action = &jt->second;
+        }
+    }
+}
+
+const Mealy::Cell* Mealy::cell(int port) const
+{
+    if (currentIndex() < 0 or port < 0) {
+        return nullptr;
+    }
+    return &mCells[currentIndex() * mPorts.size() + port];
+}
+
+/*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
+
+void Mealy::process(const devs::Time& time,
+		    const devs::ExternalEvent* event, int port)
+{
+    const Cell* c = cell(port);
+
+    if (c and c->next != -1) {
+        if (c->action) {
+            (*c->action)(time, event);
+        }
+        currentState(c->next, c->nextIndex);
     }
 }
 
@@ -57,20 +145,13 @@ void Mealy::output(devs::Time time,
 		   devs::ExternalEventList& output) const
 {
     if (mPhase == PROCESSING) {
-        const devs::ExternalEventList& events = *mToProcessEvents.front();
-        const devs::ExternalEvent& event = events.front();
-        OutputFuncsIterator itof = mOutputFuncs.find(currentState());
-
-        if (itof != mOutputFuncs.end()  and
-            itof->second.find(event.getPortName()) != itof->second.end()) {
-            (itof->second.find(event.getPortName())->second)(time, output);
-        } else {
-            OutputsIterator ito = mOutputs.find(currentState());
-
-            if (ito != mOutputs.end() and
-                ito->second.find(event.getPortName()) != ito->second.end()) {
-                output.emplace_back(
-                    ito->second.find(event.getPortName())->second);
+        const Cell* c = cell(mToProcessPorts[mFirstEvent]);
+
+        if (c) {
+            if (c->outputFunc) {
+                (*c->outputFunc)(time, output);
+            } else if (c->output) {
+                output.emplace_back(*c->output);
             }
         }
     }
@@ -83,38 +164,39 @@ devs::Time Mealy::init(devs::Time /* time */)
             "FSA::Mealy model, initial state not defined");
     }
 
+    compile();
     currentState(initialState());
+    mToProcessEvents.clear();
+    mToProcessPorts.clear();
+    mFirstEvent = 0;
     mPhase = IDLE;
     return 0;
 }
 
+void Mealy::queue(const devs::ExternalEvent& event)
+{
+    mToProcessEvents.emplace_back(event.getPortName());
+    copyExternalEventAttrs(event, mToProcessEvents.back());
+    mToProcessPorts.push_back(portIndex(mPorts, event.getPortName()));
+}
+
 void Mealy::externalTransition(const devs::ExternalEventList& events,
 			       devs::Time /* time */)
 {
     if (events.size() > 1) {
         devs::ExternalEventList sortedEvents = select(events);
-        devs::ExternalEventList* clonedEvents =
-            new devs::ExternalEventList;
         devs::ExternalEventList::const_iterator it = sortedEvents.begin();
 
         while (it != sortedEvents.end()) {
-            clonedEvents->emplace_back(it->getPortName());
-            devs::ExternalEvent& e = clonedEvents->back();
-            copyExternalEventAttrs(*it, e);
+            queue(*it);
             ++it;
         }
-        mToProcessEvents.push_back(clonedEvents);
     } else {
-        devs::ExternalEventList::const_iterator it = events.begin();
-        devs::ExternalEventList* clonedEvents =
-            new devs::ExternalEventList;
-        clonedEvents->emplace_back(it->getPortName());
-        devs::ExternalEvent& e = clonedEvents->back();
-        copyExternalEventAttrs(*it, e);
-
-        mToProcessEvents.push_back(clonedEvents);
+        queue(events.front());
+    }
+    if (mFirstEvent < mToProcessEvents.size()) {
+        mPhase = PROCESSING;
     }
-    mPhase = PROCESSING;
 }
 
 devs::Time Mealy::timeAdvance() const
@@ -129,18 +211,13 @@ devs::Time Mealy::timeAdvance() const
 void Mealy::internalTransition(devs::Time time)
 {
     if (mPhase == PROCESSING) {
-        devs::ExternalEventList* events = mToProcessEvents.front();
-        devs::ExternalEvent event = events->front();
-
-        process(time, &event);
+        process(time, &mToProcessEvents[mFirstEvent],
+                mToProcessPorts[mFirstEvent]);
 
-        events->erase(events->begin());
-
-        if (events->empty()) {
-            mToProcessEvents.pop_front();
-            delete events;
-        }
-        if (mToProcessEvents.empty()) {
+        if (++mFirstEvent == mToProcessEvents.size()) {
+            mToProcessEvents.clear();
+            mToProcessPorts.clear();
+            mFirstEvent = 0;
             mPhase = IDLE;
         }
     }
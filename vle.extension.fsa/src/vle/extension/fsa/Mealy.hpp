@@ -30,6 +30,7 @@
 #define VLE_EXTENSION_FSA_MEALY_HPP 1
 
 #include <functional>
+#include <vector>
 #include <vle/extension/fsa/FSA.hpp>
 
 namespace vle { namespace extension { namespace fsa {
@@ -51,7 +52,7 @@ class Mealy : public Base
 public:
     Mealy(const devs::DynamicsInit& init,
           const devs::InitEventList& events) :
-        Base(init, events)
+        Base(init, events), mPhase(IDLE), mFirstEvent(0)
     {}
 
     virtual ~Mealy()
@@ -66,10 +67,10 @@ private:
     typedef std::map < std::string, std::string > Output;
     typedef std::map < int, Output > Outputs;
 
-    typedef std::map < std::string,
-            std::function <
-                void (const devs::Time&,
-                      devs::ExternalEventList&) >  > OutputFunc;
+    typedef std::function <
+        void (const devs::Time&,
+              devs::ExternalEventList&) > OutputFunction;
+    typedef std::map < std::string, OutputFunction > OutputFunc;
     typedef std::map < int, OutputFunc > OutputFuncs;
 
     // transition
@@ -132,7 +133,23 @@ private:
     typedef Outputs::const_iterator OutputsIterator;
     typedef OutputFuncs::const_iterator OutputFuncsIterator;
     typedef Transitions::const_iterator TransitionsIterator;
-    typedef std::list < devs::ExternalEventList* > EventListLILO;
+
+    /**
+     * @brief A cell of the dense table compiled from the maps: what to do
+     * when an event arrives on a port in a state.
+     */
+    struct Cell
+    {
+        Cell() : next(-1), nextIndex(-1), action(nullptr), output(nullptr),
+            outputFunc(nullptr)
+        {}
+
+        int next;
+        int nextIndex;
+        const Action* action;
+        const std::string* output;
+        const OutputFunction* outputFunc;
+    };
 
     // List of actions
     ActionsMap mActions;
@@ -143,8 +160,17 @@ private:
     // Next states in case of external transition
     Transitions mTransitions;
 
+    // Interned input ports
+    std::unordered_map < std::string, int > mPorts;
+    // Cells indexed by state index * number of ports + port index
+    std::vector < Cell > mCells;
+
+    void compile();
+    const Cell* cell(int port) const;
+    void queue(const devs::ExternalEvent& event);
+
     void process(const devs::Time& time,
-                 const devs::ExternalEvent* event);
+                 const devs::ExternalEvent* event, int port);
 
     virtual devs::Time init(devs::Time time) override;
     virtual void output(devs::Time time,
@@ -165,7 +191,12 @@ private:
     enum Phase { IDLE, PROCESSING };
 
     Phase mPhase;
-    EventListLILO mToProcessEvents;
+    // Events waiting to be processed, from mFirstEvent to the end. The
+    // buffer is cleared, not freed, once every event is processed.
+    std::vector < devs::ExternalEvent > mToProcessEvents;
+    // Port index of each waiting event, -1 for an unknown port
+    std::vector < int > mToProcessPorts;
+    std::size_t mFirstEvent;
 };
 
 /*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
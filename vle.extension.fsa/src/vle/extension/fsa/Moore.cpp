@@ -30,21 +30,85 @@
 
 namespace vle { namespace extension { namespace fsa {
 
+void Moore::compile()
+{
+    clearStateIndex();
+    mPorts.clear();
+    mCells.clear();
+    mStateCells.clear();
+    indexInputPorts(mPorts);
+
+    for (States::const_iterator it = mStates.begin(); it != mStates.end();
+         ++it) {
+        indexState(*it);
+    }
+    for (TransitionsIterator it = mTransitions.begin();
+         it != mTransitions.end(); ++it) {
+        indexState(it->first);
+        for (TransitionIterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            indexState(jt->second);
+            mPorts.insert(std::make_pair(jt->first, (int)mPorts.size()));
+        }
+    }
+    for (ActionsIterator it = mActions.begin(); it != mActions.end(); ++it) {
+        indexState(it->first);
+    }
+    for (OutputsIterator it = mOutputs.begin(); it != mOutputs.end(); ++it) {
+        indexState(it->first);
+    }
+    for (OutputFuncsIterator it = mOutputFuncs.begin();
+         it != mOutputFuncs.end(); ++it) {
+        indexState(it->first);
+    }
+
+    const std::size_t nbPorts = mPorts.size();
+
+    mCells.resize(stateCount() * nbPorts);
+    mStateCells.resize(stateCount());
+
+    for (TransitionsIterator it = mTransitions.begin();
+         it != mTransitions.end(); ++it) {
+        std::size_t row = stateIndex(it->first) * nbPorts;
+
+        for (TransitionIterator jt = it->second.begin();
+             jt != it->second.end(); ++jt) {
+            Cell& c = mCells[row + mPorts[jt->first]];
+
+            c.next = jt->second;
+            c.nextIndex = stateIndex(jt->second);
+        }
+    }
+    for (ActionsIterator it = mActions.begin(); it != mActions.end(); ++it) {
+        mStateCells[stateIndex(it->first)].action = &it->second;
+    }
+    for (OutputsIterator it = mOutputs.begin(); it != mOutputs.end(); ++it) {
+        mStateCells[stateIndex(it->first)].output = &it->second;
+    }
+    for (OutputFuncsIterator it = mOutputFuncs.begin();
+         it != mOutputFuncs.end(); ++it) {
+        mStateCells[stateIndex(it->first)].outputFunc = &it->second;
+    }
+}
+
+/*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
+
 void Moore::process(const devs::Time& time,
-                       const devs::ExternalEvent* event)
+                       const devs::ExternalEvent* event, int port)
 {
-    if (mTransitions.find(currentState()) !=
-        mTransitions.end() and
-        (mTransitions[currentState()].find(event->
-                                                    getPortName())
-         != mTransitions[currentState()].end())) {
-        currentState(mTransitions[currentState()]
-                              [event->getPortName()]);
-
-        ActionsIterator it = mActions.find(currentState());
-
-        if (it != mActions.end()) {
-            (it->second)(time, event);
+    if (currentIndex() < 0 or port < 0) {
+        return;
+    }
+
+    const Cell& c = mCells[currentIndex() * mPorts.size() + port];
+
+    if (c.next != -1) {
+        currentState(c.next, c.nextIndex);
+
+        const Action* action = mStateCells[c.nextIndex].action;
+
+        if (action) {
+            (*action)(time, event);
         }
     }
 }
@@ -54,17 +118,13 @@ void Moore::process(const devs::Time& time,
 void Moore::output(devs::Time time,
 		   devs::ExternalEventList& output) const
 {
-    if (mPhase == PROCESSING) {
-        OutputFuncsIterator it = mOutputFuncs.find(currentState());
-
-        if (it != mOutputFuncs.end()) {
-            (it->second)(time, output);
-        } else {
-            OutputsIterator ito = mOutputs.find(currentState());
+    if (mPhase == PROCESSING and currentIndex() >= 0) {
+        const StateCell& c = mStateCells[currentIndex()];
 
-            if (ito != mOutputs.end()) {
-                output.emplace_back(ito->second);
-            }
+        if (c.outputFunc) {
+            (*c.outputFunc)(time, output);
+        } else if (c.output) {
+            output.emplace_back(*c.output);
         }
     }
 }
@@ -76,48 +136,48 @@ devs::Time Moore::init(devs::Time time)
             "FSA::Moore model, initial state not defined");
     }
 
+    compile();
     currentState(initialState());
 
-    ActionsIterator it = mActions.find(initialState());
+    const Action* action = mStateCells[currentIndex()].action;
 
-    if (it != mActions.end()) {
-        devs::ExternalEvent* event = new devs::ExternalEvent("");
+    if (action) {
+        devs::ExternalEvent event("");
 
-        (it->second)(time, event);
-        delete event;
+        (*action)(time, &event);
     }
 
+    mToProcessEvents.clear();
+    mToProcessPorts.clear();
+    mFirstEvent = 0;
     mPhase = IDLE;
     return 0;
 }
 
+void Moore::queue(const devs::ExternalEvent& event)
+{
+    mToProcessEvents.emplace_back(event.getPortName());
+    copyExternalEventAttrs(event, mToProcessEvents.back());
+    mToProcessPorts.push_back(portIndex(mPorts, event.getPortName()));
+}
+
 void Moore::externalTransition(const devs::ExternalEventList& events,
 			       devs::Time /* time */)
 {
-    // mNewStates.clear();
     if (events.size() > 1) {
         devs::ExternalEventList sortedEvents = select(events);
-        devs::ExternalEventList* clonedEvents =
-            new devs::ExternalEventList;
         devs::ExternalEventList::const_iterator it = sortedEvents.begin();
 
         while (it != sortedEvents.end()) {
-            clonedEvents->emplace_back(it->getPortName());
-            devs::ExternalEvent& e = clonedEvents->back();
-            copyExternalEventAttrs(*it, e);
+            queue(*it);
             ++it;
         }
-        mToProcessEvents.push_back(clonedEvents);
     } else {
-        devs::ExternalEventList::const_iterator it = events.begin();
-        devs::ExternalEventList* clonedEvents =
-            new devs::ExternalEventList;
-        clonedEvents->emplace_back(it->getPortName());
-        devs::ExternalEvent& e = clonedEvents->back();
-        copyExternalEventAttrs(*it, e);
-        mToProcessEvents.push_back(clonedEvents);
-    }
-    mPhase = PROCESSING;
+        queue(events.front());
+    }
+    if (mFirstEvent < mToProcessEvents.size()) {
+        mPhase = PROCESSING;
+    }
 }
 
 devs::Time Moore::timeAdvance() const
@@ -133,18 +193,13 @@ void Moore::internalTransition(devs::Time time)
 {
     if (mPhase == PROCESSING)
     {
-        devs::ExternalEventList* events = mToProcessEvents.front();
-        devs::ExternalEvent& event = events->front();
-
-        process(time, &event);
+        process(time, &mToProcessEvents[mFirstEvent],
+                mToProcessPorts[mFirstEvent]);
 
-        events->erase(events->begin());
-
-        if (events->empty()) {
-            mToProcessEvents.pop_front();
-            delete events;
-        }
-        if (mToProcessEvents.empty()) {
+        if (++mFirstEvent == mToProcessEvents.size()) {
+            mToProcessEvents.clear();
+            mToProcessPorts.clear();
+            mFirstEvent = 0;
             mPhase = IDLE;
         }
     }
@@ -30,6 +30,7 @@
 #define VLE_EXTENSION_FSA_MOORE_HPP 1
 
 #include <functional>
+#include <vector>
 #include <vle/extension/fsa/FSA.hpp>
 
 
@@ -79,7 +80,7 @@ class Moore : public Base
 public:
     Moore(const devs::DynamicsInit& init,
           const devs::InitEventList& events)
-        : Base(init, events)
+        : Base(init, events), mPhase(IDLE), mFirstEvent(0)
     {}
 
     virtual ~Moore() {}
@@ -141,7 +142,32 @@ private:
     typedef Actions::const_iterator ActionsIterator;
     typedef Transitions::const_iterator TransitionsIterator;
     typedef Transition::const_iterator TransitionIterator;
-    typedef std::list < devs::ExternalEventList* > EventListLILO;
+
+    /**
+     * @brief What to do when entering a state or being in a state,
+     * compiled from the maps.
+     */
+    struct StateCell
+    {
+        StateCell() : action(nullptr), output(nullptr), outputFunc(nullptr)
+        {}
+
+        const Action* action;
+        const std::string* output;
+        const OutputFunc* outputFunc;
+    };
+
+    /**
+     * @brief The next state when an event arrives on a port in a state.
+     */
+    struct Cell
+    {
+        Cell() : next(-1), nextIndex(-1)
+        {}
+
+        int next;
+        int nextIndex;
+    };
 
     // List of actions
     Actions mActions;
@@ -152,8 +178,18 @@ private:
     // Next states in case of external transition
     Transitions mTransitions;
 
+    // Interned input ports
+    std::unordered_map < std::string, int > mPorts;
+    // Cells indexed by state index * number of ports + port index
+    std::vector < Cell > mCells;
+    // Cells indexed by state index
+    std::vector < StateCell > mStateCells;
+
+    void compile();
+    void queue(const devs::ExternalEvent& event);
+
     void process(const devs::Time& time,
-                 const devs::ExternalEvent* event);
+                 const devs::ExternalEvent* event, int port);
 
     virtual devs::Time init(devs::Time time) override;
     virtual void output(devs::Time time,
@@ -174,7 +210,12 @@ private:
     enum Phase { IDLE, PROCESSING };
 
     Phase mPhase;
-    EventListLILO mToProcessEvents;
+    // Events waiting to be processed, from mFirstEvent to the end. The
+    // buffer is cleared, not freed, once every event is processed.
+    std::vector < devs::ExternalEvent > mToProcessEvents;
+    // Port index of each waiting event, -1 for an unknown port
+    std::vector < int > mToProcessPorts;
+    std::size_t mFirstEvent;
 };
 
 /*  - - - - - - - - - - - - - --ooOoo-- - - - - - - - - - - -  */
@@ -0,0 +1,276 @@
+/*
+ * @file vle/lua/LuaDynamics.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: ext.lua @@endtagdepends
+ */
+
+#include <fstream>
+#include <iterator>
+#include <vle/devs/Dynamics.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/String.hpp>
+#include "LuaPool.hpp"
+
+namespace vle { namespace lua {
+
+namespace vd = vle::devs;
+namespace vv = vle::value;
+
+/**
+ * @brief A DEVS model whose transitions are Lua functions of a script
+ * given in the conditions (`script`, the code, or `script_file`, a path).
+ * The models running the same script share one interpreter of the
+ * LuaPool; the state of each model is the table `self` given as first
+ * argument to the functions:
+ *
+ * - init(self, t)
+ * - ta(self) returns the duration of the current state (nil: infinity),
+ * - internal(self, t)
+ * - external(self, t, port, value), called for each event of a bag,
+ * - output(self, t) returns port, value, port, value, ...
+ * - observe(self, port) returns the observed value.
+ *
+ * The scalars of the map `parameters` of the conditions are copied into
+ * `self` before init. Values are exchanged on the Lua stack: numbers,
+ * booleans, strings and nil only.
+ */
+class LuaDynamics : public vd::Dynamics
+{
+public:
+    LuaDynamics(const vd::DynamicsInit& init,
+                const vd::InitEventList& events)
+        : vd::Dynamics(init, events),
+        mScript(LuaPool::instance().acquire(script(events))),
+        mInstance(LUA_NOREF)
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        lua_State* L = mScript->state();
+        LuaStackGuard guard(L);
+
+        mInstance = mScript->newInstance();
+
+        try {
+            if (events.exist("parameters")) {
+                lua_rawgeti(L, LUA_REGISTRYINDEX, mInstance);
+                for (const auto& p : events.getMap("parameters")) {
+                    push(p.second.get());
+                    lua_setfield(L, -2, p.first.c_str());
+                }
+            }
+        } catch (...) {
+            // the destructor is not called: release the state table
+            mScript->deleteInstance(mInstance);
+            throw;
+        }
+    }
+
+    virtual ~LuaDynamics()
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        mScript->deleteInstance(mInstance);
+    }
+
+    vd::Time init(vd::Time time) override
+    {
+        {
+            std::lock_guard < std::mutex > lock(mScript->mutex());
+            LuaStackGuard guard(mScript->state());
+
+            if (mScript->prepare(LuaScript::INIT, mInstance)) {
+                lua_pushnumber(mScript->state(), time);
+                mScript->call(getModelName(), 1, 0);
+            }
+        }
+        return timeAdvance();
+    }
+
+    vd::Time timeAdvance() const override
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        lua_State* L = mScript->state();
+        LuaStackGuard guard(L);
+
+        if (not mScript->prepare(LuaScript::TA, mInstance)) {
+            return vd::infinity;
+        }
+
+        mScript->call(getModelName(), 0, 1);
+        return lua_isnumber(L, -1) ? lua_tonumber(L, -1) : vd::infinity;
+    }
+
+    void internalTransition(vd::Time time) override
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        LuaStackGuard guard(mScript->state());
+
+        if (mScript->prepare(LuaScript::INTERNAL, mInstance)) {
+            lua_pushnumber(mScript->state(), time);
+            mScript->call(getModelName(), 1, 0);
+        }
+    }
+
+    void externalTransition(const vd::ExternalEventList& events,
+                            vd::Time time) override
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        lua_State* L = mScript->state();
+        LuaStackGuard guard(L);
+
+        for (const auto& event : events) {
+            if (mScript->prepare(LuaScript::EXTERNAL, mInstance)) {
+                lua_pushnumber(L, time);
+                lua_pushstring(L, event.getPortName().c_str());
+                push(event.attributes().get());
+                mScript->call(getModelName(), 3, 0);
+            }
+        }
+    }
+
+    void output(vd::Time time, vd::ExternalEventList& output) const override
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        lua_State* L = mScript->state();
+        LuaStackGuard guard(L);
+
+        if (not mScript->prepare(LuaScript::OUTPUT, mInstance)) {
+            return;
+        }
+
+        lua_pushnumber(L, time);
+        mScript->call(getModelName(), 1, LUA_MULTRET);
+
+        for (int i = guard.top() + 1; i <= lua_gettop(L); i += 2) {
+            if (not lua_isstring(L, i)) {
+                throw vle::utils::ModellingError(vle::utils::format(
+                        "[%s] Lua: output must return port, value pairs",
+                        getModelName().c_str()));
+            }
+
+            output.emplace_back(lua_tostring(L, i));
+            if (i + 1 <= lua_gettop(L)) {
+                std::unique_ptr < vv::Value > value = toValue(i + 1);
+                if (value) {
+                    output.back().attributes() =
+                        std::shared_ptr < vv::Value >(std::move(value));
+                }
+            }
+        }
+    }
+
+    std::unique_ptr < vv::Value > observation(
+        const vd::ObservationEvent& event) const override
+    {
+        std::lock_guard < std::mutex > lock(mScript->mutex());
+        lua_State* L = mScript->state();
+        LuaStackGuard guard(L);
+
+        if (not mScript->prepare(LuaScript::OBSERVE, mInstance)) {
+            return nullptr;
+        }
+
+        lua_pushstring(L, event.getPortName().c_str());
+        mScript->call(getModelName(), 1, 1);
+        return toValue(-1);
+    }
+
+private:
+    static std::string script(const vd::InitEventList& events)
+    {
+        if (events.exist("script")) {
+            return events.getString("script");
+        }
+        if (events.exist("script_file")) {
+            const std::string& path = events.getString("script_file");
+            std::ifstream file(path);
+
+            if (not file) {
+                throw vle::utils::ModellingError(vle::utils::format(
+                        "Lua: cannot open the script '%s'", path.c_str()));
+            }
+            return std::string(std::istreambuf_iterator < char >(file),
+                               std::istreambuf_iterator < char >());
+        }
+        throw vle::utils::ModellingError(
+            "Lua: missing the condition 'script' or 'script_file'");
+    }
+
+    /**
+     * @brief Push a scalar value on the Lua stack, nil for a null value.
+     */
+    void push(const vv::Value* value) const
+    {
+        lua_State* L = mScript->state();
+
+        if (not value) {
+            lua_pushnil(L);
+        } else if (value->isDouble()) {
+            lua_pushnumber(L, value->toDouble().value());
+        } else if (value->isInteger()) {
+            lua_pushnumber(L, value->toInteger().value());
+        } else if (value->isBoolean()) {
+            lua_pushboolean(L, value->toBoolean().value());
+        } else if (value->isString()) {
+            lua_pushstring(L, value->toString().value().c_str());
+        } else {
+            throw vle::utils::ModellingError(vle::utils::format(
+                    "[%s] Lua: only numbers, booleans and strings can be"
+                    " exchanged", getModelName().c_str()));
+        }
+    }
+
+    /**
+     * @brief Convert the value at an index of the Lua stack, a null
+     * pointer for nil.
+     */
+    std::unique_ptr < vv::Value > toValue(int index) const
+    {
+        lua_State* L = mScript->state();
+
+        switch (lua_type(L, index)) {
+        case LUA_TNUMBER:
+            return std::unique_ptr < vv::Value >(
+                new vv::Double(lua_tonumber(L, index)));
+        case LUA_TBOOLEAN:
+            return std::unique_ptr < vv::Value >(
+                new vv::Boolean(lua_toboolean(L, index)));
+        case LUA_TSTRING:
+            return std::unique_ptr < vv::Value >(
+                new vv::String(lua_tostring(L, index)));
+        default:
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr < LuaScript > mScript;
+    int mInstance;
+};
+
+}} // namespace vle lua
+
+DECLARE_DYNAMICS(vle::lua::LuaDynamics)
@@ -0,0 +1,232 @@
+/*
+ * @file vle/lua/LuaPool.hpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_LUA_LUAPOOL_HPP
+#define VLE_LUA_LUAPOOL_HPP 1
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <lua.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+
+namespace vle { namespace lua {
+
+/**
+ * @brief A Lua interpreter which has run a script once, shared by all the
+ * models using this script. The functions of the script are kept in the
+ * registry, the state of each model is a table of the registry (see
+ * newInstance). The calls must be done with the mutex locked.
+ */
+class LuaScript
+{
+public:
+    enum Function { INIT, TA, INTERNAL, EXTERNAL, OUTPUT, OBSERVE,
+        FUNCTION_COUNT };
+
+    /**
+     * @brief Stack slots reserved at creation for the arguments and the
+     * results of the calls.
+     */
+    static const int STACK_SIZE = 64;
+
+    explicit LuaScript(const std::string& script)
+        : L(luaL_newstate())
+    {
+        if (not L) {
+            throw vle::utils::InternalError("Lua: cannot create a state");
+        }
+
+        luaL_openlibs(L);
+        lua_checkstack(L, STACK_SIZE);
+
+        if (luaL_loadbuffer(L, script.c_str(), script.size(), "script") or
+            lua_pcall(L, 0, 0, 0)) {
+            std::string msg = error();
+            lua_close(L);
+            throw vle::utils::ModellingError(vle::utils::format(
+                    "Lua: error in the script: %s", msg.c_str()));
+        }
+
+        static const char* names[FUNCTION_COUNT] = {
+            "init", "ta", "internal", "external", "output", "observe" };
+
+        for (int i = 0; i < FUNCTION_COUNT; ++i) {
+            lua_getglobal(L, names[i]);
+            if (lua_isfunction(L, -1)) {
+                mFunctions[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+            } else {
+                lua_pop(L, 1);
+                mFunctions[i] = LUA_NOREF;
+            }
+        }
+    }
+
+    ~LuaScript()
+    {
+        lua_close(L);
+    }
+
+    LuaScript(const LuaScript&) = delete;
+    LuaScript& operator=(const LuaScript&) = delete;
+
+    lua_State* state() const
+    { return L; }
+
+    std::mutex& mutex()
+    { return mMutex; }
+
+    bool has(Function f) const
+    { return mFunctions[f] != LUA_NOREF; }
+
+    /**
+     * @brief Create the state table of a model.
+     * @return the reference of the table into the registry.
+     */
+    int newInstance()
+    {
+        lua_newtable(L);
+        return luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+
+    void deleteInstance(int instance)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, instance);
+    }
+
+    /**
+     * @brief Push a function of the script and the state table of a
+     * model, its first argument. Nothing is pushed if the script does not
+     * define the function.
+     * @return true if the function is defined.
+     */
+    bool prepare(Function f, int instance)
+    {
+        if (mFunctions[f] == LUA_NOREF) {
+            return false;
+        }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mFunctions[f]);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, instance);
+        return true;
+    }
+
+    /**
+     * @brief Call the function pushed by prepare with nargs arguments
+     * pushed after the state table.
+     */
+    void call(const std::string& modelName, int nargs, int nresults)
+    {
+        if (lua_pcall(L, nargs + 1, nresults, 0)) {
+            std::string msg = error();
+            throw vle::utils::ModellingError(vle::utils::format(
+                    "[%s] Lua: %s", modelName.c_str(), msg.c_str()));
+        }
+    }
+
+private:
+    std::string error()
+    {
+        std::string msg = lua_isstring(L, -1) ? lua_tostring(L, -1) :
+            "unknown error";
+        lua_pop(L, 1);
+        return msg;
+    }
+
+    lua_State* L;
+    std::mutex mMutex;
+    int mFunctions[FUNCTION_COUNT];
+};
+
+/**
+ * @brief Restore the top of the Lua stack when leaving a scope, so that a
+ * call sequence interrupted by an exception (a value that cannot be
+ * pushed, an error in the script) leaves no slot on the stack.
+ */
+class LuaStackGuard
+{
+public:
+    explicit LuaStackGuard(lua_State* L)
+        : L(L), mTop(lua_gettop(L))
+    {}
+
+    ~LuaStackGuard()
+    {
+        lua_settop(L, mTop);
+    }
+
+    LuaStackGuard(const LuaStackGuard&) = delete;
+    LuaStackGuard& operator=(const LuaStackGuard&) = delete;
+
+    /**
+     * @brief The top of the stack at the creation of the guard.
+     */
+    int top() const
+    { return mTop; }
+
+private:
+    lua_State* L;
+    int mTop;
+};
+
+/**
+ * @brief The pool of the Lua interpreters: one LuaScript per script,
+ * shared by the models while one of them uses it.
+ */
+class LuaPool
+{
+public:
+    static LuaPool& instance()
+    {
+        static LuaPool pool;
+        return pool;
+    }
+
+    std::shared_ptr < LuaScript > acquire(const std::string& script)
+    {
+        std::lock_guard < std::mutex > lock(mMutex);
+
+        std::weak_ptr < LuaScript >& slot = mScripts[script];
+        std::shared_ptr < LuaScript > result = slot.lock();
+
+        if (not result) {
+            result = std::make_shared < LuaScript >(script);
+            slot = result;
+        }
+        return result;
+    }
+
+private:
+    LuaPool() = default;
+
+    std::mutex mMutex;
+    std::map < std::string, std::weak_ptr < LuaScript > > mScripts;
+};
+
+}} // namespace vle lua
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * @file test/test_lua.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// @@tagtest@@
+
+#include <vle/utils/unit-test.hpp>
+#include <vle/manager/Manager.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/vle.hpp>
+#include <iostream>
+
+using namespace vle;
+
+static int column(const value::Matrix& view, const std::string& name)
+{
+    for (unsigned int j = 1; j < view.columns(); j++) {
+        if (view.getString(j, 0) == name) {
+            return j;
+        }
+    }
+    return -1;
+}
+
+void test_counter()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Package pack(ctx, "vle.lua");
+    std::unique_ptr<vpz::Vpz> file(new vpz::Vpz(
+            pack.getExpFile("LuaCounter.vpz")));
+
+    std::unique_ptr<value::Map> config(new value::Map());
+    config->addString("header", "top");
+    vpz::Output& o(file->project().experiment().views().outputs().get("view"));
+    o.setStream("", "storage", "vle.output");
+    o.setData(std::move(config));
+
+    manager::Error error;
+    manager::Simulation sim(ctx, manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0));
+    std::unique_ptr<value::Map> out = sim.run(std::move(file), &error);
+
+    EnsuresEqual(error.code, 0);
+    Ensures(out != NULL);
+    EnsuresEqual(out->size(), 1);
+
+    const value::Matrix& view = out->getMatrix("view");
+    EnsuresEqual(view.columns(), 4);
+
+    int count = column(view, "Top model:gen.count");
+    int last = column(view, "Top model:recv.last");
+    int received = column(view, "Top model:recv.received");
+    Ensures(count != -1);
+    Ensures(last != -1);
+    Ensures(received != -1);
+
+    // both models share one interpreter but keep their own state: the
+    // receiver gets every event sent by the generator, once per time unit.
+    unsigned int end = view.rows() - 1;
+    Ensures(view.getDouble(received, end) >= 9);
+    EnsuresApproximatelyEqual(view.getDouble(received, end),
+                              view.getDouble(count, end), 1e-9);
+    EnsuresApproximatelyEqual(view.getDouble(last, end),
+                              view.getDouble(received, end), 1e-9);
+}
+
+int main()
+{
+    test_counter();
+
+    return unit_test::report_errors();
+}
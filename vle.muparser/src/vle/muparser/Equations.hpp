@@ -0,0 +1,170 @@
+/*
+ * @file vle/muparser/Equations.hpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MUPARSER_EQUATIONS_HPP
+#define VLE_MUPARSER_EQUATIONS_HPP 1
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <muParser.h>
+#include <vle/devs/InitEventList.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/value/Map.hpp>
+
+namespace vle { namespace muparser {
+
+/**
+ * @brief A system of equations `variable = expression` read from the
+ * conditions of a model and compiled once to muParser bytecode.
+ *
+ * The conditions are:
+ * - `equations`, a map variable name -> expression (string),
+ * - `parameters`, an optional map name -> double, compiled as constants.
+ *
+ * The expressions read the variables from slots: one array of `bulkSize`
+ * doubles per variable plus one for the time `t`, filled by the model
+ * before an evaluation. With a bulk size greater than one, an equation is
+ * evaluated for all the instances at once with the muParser bulk mode.
+ */
+class Equations
+{
+public:
+    Equations(const std::string& modelName,
+              const vle::devs::InitEventList& events,
+              std::size_t bulkSize = 1)
+        : mBulkSize(bulkSize)
+    {
+        if (not events.exist("equations")) {
+            throw vle::utils::ModellingError(vle::utils::format(
+                    "[%s] missing the map 'equations'", modelName.c_str()));
+        }
+
+        const vle::value::Map& equations = events.getMap("equations");
+
+        for (const auto& eq : equations) {
+            mNames.push_back(eq.first);
+        }
+        mSlots.assign((mNames.size() + 1) * mBulkSize, 0.0);
+
+        std::vector < std::pair < std::string, double > > parameters;
+
+        if (events.exist("parameters")) {
+            for (const auto& p : events.getMap("parameters")) {
+                if (not p.second or not (p.second->isDouble() or
+                                         p.second->isInteger())) {
+                    throw vle::utils::ModellingError(vle::utils::format(
+                            "[%s] the parameter '%s' is not a number",
+                            modelName.c_str(), p.first.c_str()));
+                }
+                parameters.emplace_back(p.first, p.second->isInteger() ?
+                        (double)p.second->toInteger().value() :
+                        p.second->toDouble().value());
+            }
+        }
+
+        for (const auto& eq : equations) {
+            if (not eq.second or not eq.second->isString()) {
+                throw vle::utils::ModellingError(vle::utils::format(
+                        "[%s] the equation of '%s' is not a string",
+                        modelName.c_str(), eq.first.c_str()));
+            }
+
+            std::unique_ptr<mu::Parser> parser(new mu::Parser());
+
+            try {
+                for (const auto& p : parameters) {
+                    parser->DefineConst(p.first, p.second);
+                }
+                for (std::size_t i = 0; i < mNames.size(); ++i) {
+                    parser->DefineVar(mNames[i], slot(i));
+                }
+                parser->DefineVar("t", time());
+                parser->SetExpr(eq.second->toString().value());
+                // the first evaluation checks the syntax and builds the
+                // bytecode used by the next ones.
+                parser->Eval();
+            } catch (const mu::Parser::exception_type& e) {
+                throw vle::utils::ModellingError(vle::utils::format(
+                        "[%s] error in the equation of '%s': %s",
+                        modelName.c_str(), eq.first.c_str(),
+                        e.GetMsg().c_str()));
+            }
+            mParsers.push_back(std::move(parser));
+        }
+    }
+
+    /**
+     * @brief Number of variables, which is the number of equations.
+     */
+    std::size_t size() const
+    { return mNames.size(); }
+
+    std::size_t bulkSize() const
+    { return mBulkSize; }
+
+    const std::string& name(std::size_t i) const
+    { return mNames[i]; }
+
+    /**
+     * @brief The slots of a variable, an array of bulkSize() values.
+     */
+    double* slot(std::size_t i)
+    { return &mSlots[i * mBulkSize]; }
+
+    const double* slot(std::size_t i) const
+    { return &mSlots[i * mBulkSize]; }
+
+    /**
+     * @brief The slots of the time, an array of bulkSize() values.
+     */
+    double* time()
+    { return &mSlots[mNames.size() * mBulkSize]; }
+
+    /**
+     * @brief Evaluate the equation of a variable with the current slots.
+     */
+    double eval(std::size_t i)
+    { return mParsers[i]->Eval(); }
+
+    /**
+     * @brief Evaluate the equation of a variable for all the instances,
+     * from the bytecode built by the constructor.
+     * @param results an array of bulkSize() values.
+     */
+    void eval(std::size_t i, double* results)
+    { mParsers[i]->Eval(results, (int)mBulkSize); }
+
+private:
+    std::size_t mBulkSize;
+    std::vector < std::string > mNames;
+    std::vector < double > mSlots;
+    std::vector < std::unique_ptr < mu::Parser > > mParsers;
+};
+
+}} // namespace vle muparser
+
+#endif
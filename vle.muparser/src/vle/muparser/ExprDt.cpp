@@ -0,0 +1,79 @@
+/*
+ * @file vle/muparser/ExprDt.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: ext.muparser, vle.discrete-time @@endtagdepends
+ */
+
+#include <vle/DiscreteTime.hpp>
+#include "Equations.hpp"
+
+namespace vle { namespace muparser {
+
+using namespace vle::discrete_time;
+
+/**
+ * @brief A discrete-time model whose variables are updated by the
+ * expressions of the map `equations` of the conditions. All the equations
+ * read the values of the previous step, so the order of the equations does
+ * not matter.
+ */
+class ExprDt : public DiscreteTimeDyn
+{
+public:
+    ExprDt(const vle::devs::DynamicsInit& model,
+           const vle::devs::InitEventList& events)
+        : DiscreteTimeDyn(model, events),
+        mEquations(getModelName(), events), mVars(mEquations.size())
+    {
+        for (std::size_t i = 0; i < mVars.size(); ++i) {
+            mVars[i].init(this, mEquations.name(i), events);
+        }
+    }
+
+    virtual ~ExprDt()
+    {}
+
+    void compute(const vle::devs::Time& time) override
+    {
+        for (std::size_t i = 0; i < mVars.size(); ++i) {
+            *mEquations.slot(i) = mVars[i]();
+        }
+        *mEquations.time() = time;
+
+        for (std::size_t i = 0; i < mVars.size(); ++i) {
+            mVars[i] = mEquations.eval(i);
+        }
+    }
+
+private:
+    Equations mEquations;
+    std::vector < Var > mVars;
+};
+
+}} // namespace vle muparser
+
+DECLARE_DYNAMICS(vle::muparser::ExprDt)
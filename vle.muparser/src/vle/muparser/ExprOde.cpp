@@ -0,0 +1,79 @@
+/*
+ * @file vle/muparser/ExprOde.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: ext.muparser, vle.ode @@endtagdepends
+ */
+
+#include <vle/DifferentialEquation.hpp>
+#include "Equations.hpp"
+
+namespace vle { namespace muparser {
+
+using namespace vle::ode;
+
+/**
+ * @brief An ordinary differential equation whose gradients are given as
+ * expressions in the map `equations` of the conditions. The variables are
+ * declared from the keys of this map and initialised as in vle.ode
+ * (`init_value_X`, ...).
+ */
+class ExprOde : public DifferentialEquation
+{
+public:
+    ExprOde(const vle::devs::DynamicsInit& model,
+            const vle::devs::InitEventList& events)
+        : DifferentialEquation(model, events),
+        mEquations(getModelName(), events), mVars(mEquations.size())
+    {
+        for (std::size_t i = 0; i < mVars.size(); ++i) {
+            mVars[i].init(this, mEquations.name(i), events);
+        }
+    }
+
+    virtual ~ExprOde()
+    {}
+
+    void compute(const vle::devs::Time& time) override
+    {
+        for (std::size_t i = 0; i < mVars.size(); ++i) {
+            *mEquations.slot(i) = mVars[i]();
+        }
+        *mEquations.time() = time;
+
+        for (std::size_t i = 0; i < mVars.size(); ++i) {
+            grad(mVars[i]) = mEquations.eval(i);
+        }
+    }
+
+private:
+    Equations mEquations;
+    std::vector < Var > mVars;
+};
+
+}} // namespace vle muparser
+
+DECLARE_DYNAMICS(vle::muparser::ExprOde)
@@ -0,0 +1,162 @@
+/*
+ * @file vle/muparser/ExprPopulation.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @@tagdynamic@@
+ * @@tagdepends: ext.muparser @@endtagdepends
+ */
+
+#include <algorithm>
+#include <vle/devs/Dynamics.hpp>
+#include <vle/value/Tuple.hpp>
+#include "Equations.hpp"
+
+namespace vle { namespace muparser {
+
+namespace vd = vle::devs;
+namespace vv = vle::value;
+
+/**
+ * @brief `size` identical instances of a discrete-time system of
+ * equations, stored as one array per variable and updated at each
+ * `time_step` with the muParser bulk mode: each equation is evaluated once
+ * for all the instances instead of once per instance and per model.
+ *
+ * The initial value of a variable X is given by `init_value_X`, a double
+ * shared by all the instances or a tuple of `size` values (0 by default).
+ * The observation port X gives the tuple of the values of the instances.
+ */
+class ExprPopulation : public vd::Dynamics
+{
+public:
+    ExprPopulation(const vd::DynamicsInit& init,
+                   const vd::InitEventList& events)
+        : vd::Dynamics(init, events),
+        mEquations(getModelName(), events, size(getModelName(), events)),
+        mNext(mEquations.size() * mEquations.bulkSize()),
+        mTimeStep(1.0)
+    {
+        if (events.exist("time_step")) {
+            mTimeStep = events.getDouble("time_step");
+        }
+
+        const std::size_t n = mEquations.bulkSize();
+
+        for (std::size_t i = 0; i < mEquations.size(); ++i) {
+            std::string port = "init_value_" + mEquations.name(i);
+
+            if (not events.exist(port)) {
+                continue;
+            }
+
+            const vv::Value& init = *events.get(port);
+            double* slot = mEquations.slot(i);
+
+            if (init.isTuple()) {
+                const vv::Tuple& values = init.toTuple();
+
+                if (values.size() != n) {
+                    throw vle::utils::ModellingError(vle::utils::format(
+                            "[%s] '%s' has %u values instead of %u",
+                            getModelName().c_str(), port.c_str(),
+                            (unsigned int)values.size(), (unsigned int)n));
+                }
+                std::copy(values.value().begin(), values.value().end(),
+                          slot);
+            } else {
+                std::fill(slot, slot + n, init.toDouble().value());
+            }
+        }
+    }
+
+    virtual ~ExprPopulation()
+    {}
+
+    vd::Time init(vd::Time /*time*/) override
+    {
+        return mTimeStep;
+    }
+
+    vd::Time timeAdvance() const override
+    {
+        return mTimeStep;
+    }
+
+    void internalTransition(vd::Time time) override
+    {
+        const std::size_t n = mEquations.bulkSize();
+
+        std::fill(mEquations.time(), mEquations.time() + n, time);
+
+        for (std::size_t i = 0; i < mEquations.size(); ++i) {
+            mEquations.eval(i, &mNext[i * n]);
+        }
+        for (std::size_t i = 0; i < mEquations.size(); ++i) {
+            std::copy(&mNext[i * n], &mNext[i * n] + n, mEquations.slot(i));
+        }
+    }
+
+    std::unique_ptr<vv::Value> observation(
+        const vd::ObservationEvent& event) const override
+    {
+        for (std::size_t i = 0; i < mEquations.size(); ++i) {
+            if (event.onPort(mEquations.name(i))) {
+                const std::size_t n = mEquations.bulkSize();
+                std::unique_ptr<vv::Tuple> values(new vv::Tuple(n));
+
+                std::copy(mEquations.slot(i), mEquations.slot(i) + n,
+                          values->value().begin());
+                return std::move(values);
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    static std::size_t size(const std::string& modelName,
+                            const vd::InitEventList& events)
+    {
+        if (not events.exist("size")) {
+            return 1;
+        }
+
+        int size = events.getInt("size");
+
+        if (size <= 0) {
+            throw vle::utils::ModellingError(vle::utils::format(
+                    "[%s] 'size' must be positive, not %d",
+                    modelName.c_str(), size));
+        }
+        return size;
+    }
+
+    Equations mEquations;
+    std::vector < double > mNext;
+    double mTimeStep;
+};
+
+}} // namespace vle muparser
+
+DECLARE_DYNAMICS(vle::muparser::ExprPopulation)
@@ -0,0 +1,165 @@
+/*
+ * @file test/test_muparser.cpp
+ *
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2011 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// @@tagtest@@
+
+#include <vle/utils/unit-test.hpp>
+#include <vle/manager/Manager.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <vle/utils/Package.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/vle.hpp>
+#include <cmath>
+#include <iostream>
+
+using namespace vle;
+
+static std::unique_ptr<vpz::Vpz> load(const std::string& exp)
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Package pack(ctx, "vle.muparser");
+    return std::unique_ptr<vpz::Vpz>(new vpz::Vpz(pack.getExpFile(exp)));
+}
+
+/**
+ * @return the error code of the simulation of a modified experiment.
+ */
+static int fail(std::unique_ptr<vpz::Vpz> file)
+{
+    auto ctx = vle::utils::make_context();
+    manager::Error error;
+    manager::Simulation sim(ctx, manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0));
+    sim.run(std::move(file), &error);
+
+    return error.code;
+}
+
+static std::unique_ptr<value::Map> run(const std::string& exp)
+{
+    auto ctx = vle::utils::make_context();
+    std::unique_ptr<vpz::Vpz> file(load(exp));
+
+    vpz::Output& o(file->project().experiment().views().outputs().get("view"));
+    o.setStream("", "storage", "vle.output");
+
+    manager::Error error;
+    manager::Simulation sim(ctx, manager::SIMULATION_NONE,
+            std::chrono::milliseconds(0));
+    std::unique_ptr<value::Map> out = sim.run(std::move(file), &error);
+
+    EnsuresEqual(error.code, 0);
+    Ensures(out != NULL);
+    EnsuresEqual(out->size(), 1);
+    return out;
+}
+
+void test_ode()
+{
+    std::unique_ptr<value::Map> out = run("ExprOde.vpz");
+    value::Matrix& result = out->getMatrix("view");
+
+    EnsuresEqual(result.columns(), 3);
+    //note: the number of rows depend on the averaging of sum of 0.1
+    Ensures(result.rows() >= 11);
+
+    // dX/dt = -k X with k = 1 and dY/dt = 1, at t = 1
+    unsigned int last = result.rows() - 1;
+    EnsuresApproximatelyEqual(result.getDouble(1, last), std::exp(-1.0), 1e-2);
+    EnsuresApproximatelyEqual(result.getDouble(2, last), 1.0, 1e-2);
+}
+
+void test_dt()
+{
+    std::unique_ptr<value::Map> out = run("ExprDt.vpz");
+    value::Matrix& result = out->getMatrix("view");
+
+    EnsuresEqual(result.columns(), 3);
+    EnsuresEqual(result.rows(), 11);
+
+    // X = a with a = 3 and Y = Y + 1
+    EnsuresApproximatelyEqual(result.getDouble(1, 10), 3.0, 1e-9);
+    EnsuresApproximatelyEqual(
+        result.getDouble(2, 10) - result.getDouble(2, 9), 1.0, 1e-9);
+}
+
+void test_population()
+{
+    std::unique_ptr<value::Map> out = run("ExprPopulation.vpz");
+    value::Matrix& result = out->getMatrix("view");
+
+    EnsuresEqual(result.columns(), 2);
+    EnsuresEqual(result.rows(), 4);
+
+    // X = X * 2 for the 4 instances initialised to 1, 2, 3, 4
+    for (unsigned int r = 0; r < result.rows(); ++r) {
+        const value::Tuple& x = result.get(1, r)->toTuple();
+
+        EnsuresEqual(x.size(), 4);
+        for (unsigned int i = 0; i < 4; ++i) {
+            EnsuresApproximatelyEqual(x.at(i), (i + 1) * x.at(0), 1e-9);
+        }
+        if (r > 0) {
+            const value::Tuple& previous = result.get(1, r - 1)->toTuple();
+
+            EnsuresApproximatelyEqual(x.at(0), 2 * previous.at(0), 1e-9);
+        }
+    }
+}
+
+void test_population_errors()
+{
+    {
+        std::unique_ptr<vpz::Vpz> file(load("ExprPopulation.vpz"));
+        vpz::Condition& cond = file->project().experiment().conditions()
+            .get("condExprPopulation");
+
+        cond.clearValueOfPort("size");
+        cond.setValueToPort("size", value::Integer::create(0));
+        Ensures(fail(std::move(file)) != 0);
+    }
+    {
+        std::unique_ptr<vpz::Vpz> file(load("ExprPopulation.vpz"));
+        vpz::Condition& cond = file->project().experiment().conditions()
+            .get("condExprPopulation");
+        std::unique_ptr<value::Map> parameters(new value::Map());
+
+        parameters->addString("k", "2");
+        cond.addValueToPort("parameters", std::move(parameters));
+        Ensures(fail(std::move(file)) != 0);
+    }
+}
+
+int main()
+{
+    test_ode();
+    test_dt();
+    test_population();
+    test_population_errors();
+
+    return unit_test::report_errors();
+}
@@ -28,6 +28,14 @@
 
 #include <chrono>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
 #include <vle/version.hpp>
 #include <vle/vle.hpp>
 #include <vle/value/Map.hpp>
@@ -67,10 +75,11 @@ public:
      */
     TesterSimulation(const std::string& packagename,
             const std::string& vpzname, const utils::ContextPtr& ctx):
-        mCtx(ctx)
+        mCtx(ctx), mWallTime(0.), mPeakRss(0.)
     {
         vu::Package pkg(mCtx, packagename);
-        mvpz = std::unique_ptr<vz::Vpz>(new vz::Vpz(pkg.getExpFile(vpzname)));
+        mVpzFile = pkg.getExpFile(vpzname);
+        mvpz = std::unique_ptr<vz::Vpz>(new vz::Vpz(mVpzFile));
     }
 
 
@@ -101,20 +110,7 @@ public:
     void setStorageViews()
     {
         if(mvpz){
-            //set all output plugin to storage
-            vz::Outputs::iterator itb =
-                    mvpz->project().experiment().views().outputs().begin();
-            vz::Outputs::iterator ite =
-                    mvpz->project().experiment().views().outputs().end();
-            for(;itb!=ite;itb++) {
-                va::Map* configOutput = new va::Map();
-                //configOutput->addInt("rows",10000);
-                //configOutput->addInt("inc_rows",10000);
-                configOutput->addString("header","top");//A voir
-                vz::Output& output = itb->second;
-                output.setStream("", "storage", "vle.output");
-                output.setData(std::unique_ptr<value::Value>(configOutput));
-            }
+            setStorageViews(*mvpz);
         }
     }
     /**
@@ -132,18 +128,120 @@ public:
             vm::Simulation sim(mCtx, vm::LOG_NONE, vm::SIMULATION_SPAWN_PROCESS,
                     std::chrono::milliseconds(0), &std::cout);
 #endif
-            std::unique_ptr<va::Map> res = sim.run(std::move(mvpz), &merror);
-            return res;
+            return sim.run(std::move(mvpz), &merror);
         } else {
             return std::unique_ptr<va::Map>();
         }
     }
 
+    /**
+     * @brief Measures one run of the vpz, independently of simulates().
+     * The simulation is run in-process by a child forked for this purpose
+     * and the peak resident set size is the one of this child only, taken
+     * from wait4(). The child inherits the pages of the tester, whose
+     * footprint is the same for every vpz of a test file.
+     * On Windows, the run is made in the tester and the peak RSS is 0.
+     */
+    void measures()
+    {
+#ifndef _WIN32
+        int fds[2];
+        if (pipe(fds) != 0) {
+            throw vu::InternalError(vle::utils::format(
+                    " pipe failed for %s", mVpzFile.c_str()));
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            throw vu::InternalError(vle::utils::format(
+                    " fork failed for %s", mVpzFile.c_str()));
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            double wall = -1.;
+            try {
+                wall = runInProcess();
+            } catch (...) {
+                wall = -1.;
+            }
+            ssize_t written = write(fds[1], &wall, sizeof(wall));
+            _exit(written == (ssize_t) sizeof(wall) and wall >= 0. ? 0 : 1);
+        }
+        close(fds[1]);
+        double wall = -1.;
+        ssize_t nb;
+        do {
+            nb = read(fds[0], &wall, sizeof(wall));
+        } while (nb < 0 and errno == EINTR);
+        close(fds[0]);
+
+        int status = 0;
+        struct rusage usage;
+        pid_t waited;
+        do {
+            waited = wait4(pid, &status, 0, &usage);
+        } while (waited < 0 and errno == EINTR);
+
+        if (waited != pid or nb != (ssize_t) sizeof(wall)
+                or not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+            throw vu::InternalError(vle::utils::format(
+                    " measured run of %s failed", mVpzFile.c_str()));
+        }
+        mWallTime = wall;
+#ifdef __APPLE__
+        mPeakRss = usage.ru_maxrss / 1024.;//bytes on macOS
+#else
+        mPeakRss = usage.ru_maxrss;
+#endif
+#else
+        mWallTime = runInProcess();
+        mPeakRss = 0.;
+#endif
+    }
+
     vm::Error& getError()
     {
         return merror;
     }
 
+    /**
+     * @brief Wall time of the last call to measures()
+     * @return the elapsed time in seconds
+     */
+    double getWallTime() const
+    {
+        return mWallTime;
+    }
+
+    /**
+     * @brief Peak resident set size of the last call to measures()
+     * @return the high-water mark in kilobytes, 0 if unavailable
+     */
+    double getPeakRss() const
+    {
+        return mPeakRss;
+    }
+
+    /**
+     * @brief Number of rows stored into the views, i.e. the sum of the
+     * rows of every view (header excluded). The kernel does not expose
+     * its number of events, this counts observations only.
+     */
+    double getStoredRows(const va::Map& sim_outputs) const
+    {
+        double nb = 0;
+        for (const auto& v : sim_outputs) {
+            if (v.second and v.second->isMatrix()) {
+                const va::Matrix& view = v.second->toMatrix();
+                if (view.rows() > 0) {
+                    nb += view.rows() - 1;
+                }
+            }
+        }
+        return nb;
+    }
+
     va::Matrix& getView(va::Map& sim_outputs, const std::string& viewname)
     {
         if (! sim_outputs.exist(viewname)) {
@@ -174,12 +272,60 @@ public:
     }
 
 private:
+
+    static void setStorageViews(vz::Vpz& vpz)
+    {
+        //set all output plugin to storage
+        vz::Outputs::iterator itb =
+                vpz.project().experiment().views().outputs().begin();
+        vz::Outputs::iterator ite =
+                vpz.project().experiment().views().outputs().end();
+        for(;itb!=ite;itb++) {
+            va::Map* configOutput = new va::Map();
+            //configOutput->addInt("rows",10000);
+            //configOutput->addInt("inc_rows",10000);
+            configOutput->addString("header","top");//A voir
+            vz::Output& output = itb->second;
+            output.setStream("", "storage", "vle.output");
+            output.setData(std::unique_ptr<value::Value>(configOutput));
+        }
+    }
+
+    /**
+     * @brief Runs the vpz file in the current process
+     * @return the wall time of the run in seconds
+     */
+    double runInProcess()
+    {
+        std::unique_ptr<vz::Vpz> vpz(new vz::Vpz(mVpzFile));
+        setStorageViews(*vpz);
+#if VLE_VERSION >= 200100
+        vm::Simulation sim(mCtx, vm::SIMULATION_NONE,
+                std::chrono::milliseconds(0));
+#else
+        vm::Simulation sim(mCtx, vm::LOG_NONE, vm::SIMULATION_NONE,
+                std::chrono::milliseconds(0), &std::cout);
+#endif
+        vm::Error error;
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<va::Map> res = sim.run(std::move(vpz), &error);
+        double wall = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        if (error.code) {
+            throw vu::InternalError(error.message);
+        }
+        return wall;
+    }
+
 #if VLE_VERSION < 200100
     vle::Init mapp;
 #endif
+    std::string mVpzFile;
     std::unique_ptr<vz::Vpz> mvpz;
     vm::Error merror;
     utils::ContextPtr mCtx;
+    double mWallTime;
+    double mPeakRss;
 };
 
 }}//namespaces
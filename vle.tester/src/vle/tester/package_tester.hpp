@@ -26,10 +26,12 @@
 #define _VLE_UTILS_PACKAGE_TESTER_HPP 1
 
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <exception>
 #include <cmath>
+#include <vector>
 
 #include <vle/utils/Package.hpp>
 #include <vle/utils/Context.hpp>
@@ -61,34 +63,41 @@ public:
 
     static bool check(const std::string& pkgname,
             const std::string& test_file_name)
+    {
+        return check(pkgname, test_file_name, "");
+    }
+
+    /**
+     * @brief Performs the tests of a test file. Lines whose view is
+     * 'benchmark' are performance tests: the column name is the metric
+     * ('wall_time' in seconds, 'peak_rss' in kilobytes, 'stored_rows'),
+     * the precision is the relative tolerance and the expected value is
+     * the baseline. wall_time and peak_rss are measured on a dedicated run
+     * (see TesterSimulation::measures()) and fail if they exceed
+     * baseline * (1 + tolerance); stored_rows, the number of rows of the
+     * views, fails if it differs from the baseline by more than
+     * baseline * tolerance. With a 'NA' baseline or tolerance, the metric
+     * is only recorded.
+     *
+     * @param pkgname, the name of the package that owns the test file
+     * @param test_file_name, the test file in the data directory of pkgname
+     * @param report_file_name, if not empty, the file in which a csv report
+     * of the benchmark lines is written
+     * @return true if one test fails
+     */
+    static bool check(const std::string& pkgname,
+            const std::string& test_file_name,
+            const std::string& report_file_name)
     {
         auto ctx = utils::make_context();
 
         std::cout << " check=" << test_file_name << std::endl;
 
         std::vector <std::string> test_report;
+        std::vector <std::string> bench_report;
         bool fail = false;
-        vu::Package pkg(ctx, pkgname);
-        std::string test_file_path = pkg.getDataFile(test_file_name);
-        vv::Map params;
-        std::string separator = " ";
-        params.addString("sep",separator);
-        vv::Set& cols = params.addSet("columns");
-        cols.addString("string");//pkg name
-        cols.addString("string");//vpz name
-        cols.addString("string");//view name
-        cols.addString("string");//col name
-        cols.addString("int");//line index
-        cols.addString("string");//expected double or string
-        cols.addString("string");//precision for double or NA for string
-
-        vle::reader::TableFileReader tfr(test_file_path);
-        tfr.setParams(params);
         vv::Matrix resParsing;
-        tfr.readFile(resParsing);
-
-        if (tfr.hasError()) {
-            tfr.printError(std::cout);
+        if (not read_test_file(ctx, pkgname, test_file_name, resParsing)) {
             fail = true;
             return fail;
         }
@@ -103,6 +112,7 @@ public:
 
         TesterSimulation* tester_sim(0);
         std::unique_ptr<vv::Map> sim_outputs;
+        bool measured_sim = false;
 
         for (unsigned int i = 0; i < resParsing.rows(); i++) {
             bool fail_i = false;
@@ -123,6 +133,7 @@ public:
 
                 delete tester_sim;
                 tester_sim = 0;
+                measured_sim = false;
 
                 try {
                     tester_sim = new TesterSimulation(newpkg, newvpz, ctx);
@@ -155,6 +166,51 @@ public:
                         << newpkg << "/" << newvpz;
                 fail_i = true;
             }
+            if (!fail_i && view == "benchmark" && !measured_sim
+                    && colname != "stored_rows") {
+                try {
+                    tester_sim->measures();
+                    measured_sim = true;
+                } catch (const std::exception& e) {
+                    report_line << "benchmark fail of " << newpkg << "/"
+                            << newvpz << ": " << e.what();
+                    fail_i = true;
+                }
+            }
+            if (!fail_i && view == "benchmark") {
+                double measured = 0;
+                if (!get_metric(*tester_sim, *sim_outputs, colname,
+                        measured)) {
+                    report_line << "benchmark fail of " << newpkg << "/"
+                            << newvpz << ": unknown metric '" << colname
+                            << "'";
+                    fail_i = true;
+                } else {
+                    bool ok = performs_one_benchmark(colname, precision,
+                            valExpected, measured);
+                    std::ostringstream bench_line;
+                    bench_line << newpkg << ";" << newvpz << ";" << colname
+                            << ";" << measured << ";" << valExpected << ";"
+                            << precision << ";" << (ok ? "ok" : "fail");
+                    bench_report.push_back(bench_line.str());
+                    if (ok) {
+                        report_line << "benchmark ok of " << newpkg << "/"
+                                << newvpz << ": metric=" << colname
+                                << "; baseline=" << valExpected
+                                << "; got=" << measured;
+                    } else {
+                        report_line << "benchmark fail of " << newpkg << "/"
+                                << newvpz << ": metric=" << colname
+                                << "; baseline=" << valExpected
+                                << "; tolerance=" << precision
+                                << "; got=" << measured;
+                        fail_i = true;
+                    }
+                }
+                test_report.push_back(report_line.str());
+                fail = fail or fail_i;
+                continue;
+            }
             if (!fail_i) {
                 try {
                     simulated_val =  tester_sim->getColElt(*sim_outputs,
@@ -197,11 +253,84 @@ public:
         for (unsigned int i=0; i< test_report.size(); i++) {
             std::cout << test_report[i] << std::endl;
         }
+        if (not report_file_name.empty()) {
+            std::ofstream report(report_file_name);
+            if (not report.is_open()) {
+                std::cout << "fail to open report " << report_file_name
+                        << std::endl;
+                return true;
+            }
+            report << "package;vpz;metric;measured;baseline;tolerance;status"
+                    << std::endl;
+            for (unsigned int i=0; i< bench_report.size(); i++) {
+                report << bench_report[i] << std::endl;
+            }
+        }
         return fail;
     }
 
 private:
 
+    static bool read_test_file(const utils::ContextPtr& ctx,
+            const std::string& pkgname, const std::string& test_file_name,
+            vv::Matrix& resParsing)
+    {
+        vu::Package pkg(ctx, pkgname);
+        std::string test_file_path = pkg.getDataFile(test_file_name);
+        vv::Map params;
+        std::string separator = " ";
+        params.addString("sep",separator);
+        vv::Set& cols = params.addSet("columns");
+        cols.addString("string");//pkg name
+        cols.addString("string");//vpz name
+        cols.addString("string");//view name
+        cols.addString("string");//col name
+        cols.addString("int");//line index
+        cols.addString("string");//expected double or string
+        cols.addString("string");//precision for double or NA for string
+
+        vle::reader::TableFileReader tfr(test_file_path);
+        tfr.setParams(params);
+        tfr.readFile(resParsing);
+
+        if (tfr.hasError()) {
+            tfr.printError(std::cout);
+            return false;
+        }
+        return true;
+    }
+
+    static bool get_metric(const TesterSimulation& tester_sim,
+            const vv::Map& sim_outputs, const std::string& metric,
+            double& measured)
+    {
+        if (metric == "wall_time") {
+            measured = tester_sim.getWallTime();
+        } else if (metric == "peak_rss") {
+            measured = tester_sim.getPeakRss();
+        } else if (metric == "stored_rows") {
+            measured = tester_sim.getStoredRows(sim_outputs);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    static bool performs_one_benchmark(const std::string& metric,
+            const std::string& tolerance, const std::string& baseline,
+            double measured)
+    {
+        if (tolerance == "NA" or baseline == "NA") {
+            return true;
+        }
+        double tol = str_to_double(tolerance);
+        double base = str_to_double(baseline);
+        if (metric == "stored_rows") {
+            return std::abs(measured - base) <= base * tol;
+        }
+        return measured <= base * (1. + tol);
+    }
+
     static double str_to_double(const std::string& v)
     {
         //note: std::stod expects c++ locale (french one)
@@ -240,6 +369,11 @@ private:
   int main(int /*argc*/, char ** /*argv*/) {                   \
         return vle::tester::PackageTester::check(pkg,vpz);  \
   }
+
+#define VLE_UTILS_BENCHMARK(pkg,vpz,report)                         \
+  int main(int /*argc*/, char ** /*argv*/) {                        \
+        return vle::tester::PackageTester::check(pkg,vpz,report);  \
+  }
 }} // namespaces
 
 #endif
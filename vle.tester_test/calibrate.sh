@@ -0,0 +1,54 @@
+#!/bin/sh
+#
+# Measures the wall_time and peak_rss baselines of data/benchmarks.txt on
+# the machine that runs the benchmarks. This is not part of the test suite:
+# run it by hand from the build directory of vle.tester_test, then review
+# and commit the printed test file.
+#
+#   ./calibrate.sh [runs] [test_benchmark] > new_benchmarks.txt
+#
+# test_benchmark is run 'runs' times (3 by default) and writes its measures
+# to benchmarks.csv. For each (package, vpz), the baseline is the largest
+# measure and the tolerance the relative spread of the measures, at least
+# 0.1. The other lines of the test file are printed unchanged.
+
+set -e
+
+runs=${1:-3}
+bench=${2:-test/test_benchmark}
+bench="$(cd "$(dirname "$bench")" && pwd)/$(basename "$bench")"
+data="$(cd "$(dirname "$0")" && pwd)/data/benchmarks.txt"
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+i=0
+while [ "$i" -lt "$runs" ]; do
+    # the run fails when a baseline is exceeded, the report is written anyway
+    (cd "$work" && "$bench" > /dev/null) || true
+    if [ ! -f "$work/benchmarks.csv" ]; then
+        echo "calibrate.sh: $bench wrote no report" >&2
+        exit 1
+    fi
+    tail -n +2 "$work/benchmarks.csv" >> "$work/measures.csv"
+    rm "$work/benchmarks.csv"
+    i=$((i + 1))
+done
+
+awk -F';' '
+NR == FNR {
+    key = $1 " " $2 " " $3
+    v = $4 + 0
+    if (!(key in hi) || v > hi[key]) hi[key] = v
+    if (!(key in lo) || v < lo[key]) lo[key] = v
+    next
+}
+($4 == "wall_time" || $4 == "peak_rss") && (($1 " " $2 " " $4) in hi) {
+    key = $1 " " $2 " " $4
+    tol = hi[key] > 0 ? (hi[key] - lo[key]) / hi[key] : 0
+    if (tol < 0.1) tol = 0.1
+    printf "%s %s %s %s %s %.2f %.6g\n", $1, $2, $3, $4, $5, tol, hi[key]
+    next
+}
+{ print }
+' "$work/measures.csv" FS=' ' "$data"